@@ -9,12 +9,13 @@ from numpy import cos, sin, pi
 
 import matplotlib.pyplot as plt
 import numpy as np
-import pandas as pd
 import ctypes
+import os
 import pyrr
 import time
 
-from GUI.helpers import Eframe2GlframeRotation, Eframe2GlframeTranslation, normalize
+from GUI import tvcsim
+from GUI.helpers import eulerToDCM, Eframe2GlframeRotation, Eframe2GlframeTranslation, normalize, loadTelemetry, telemetrySignals, decimatedSignal
 
 vertex_src = """
 # version 330
@@ -217,18 +218,37 @@ class MplCanvas(FigureCanvasQTAgg):
         self.setParent(parent)
 
     def plot2D(self, x, y, xlabel, ylabel, r=None, e=None):
+        # Signals given as decimatedSignal are drawn as min/max envelope at the resolution of the canvas,
+        # recomputed from the level of detail pyramid whenever the visible time range changes
         self.fig.clear()
         self.axes = self.fig.add_subplot()
-        self.axes.plot(x, y)
-        if r is not None:
-            self.axes.plot(x, r, 'r')
-        if e is not None:
-            self.axes.plot(x, e, 'y')
+        self.time = x
+        self.lines = []
+        for signal, style in ((y, ()), (r, ('r',)), (e, ('y',))):
+            if signal is not None:
+                self.lines.append((self.axes.plot([], [], *style)[0], signal))
+        self.axes.set_xlim(x[0], x[-1])
+        self.updateLines(self.axes)
+        self.axes.relim()
+        self.axes.autoscale_view(scalex=False)
+        self.axes.callbacks.connect('xlim_changed', self.updateLines)
         self.axes.grid()
         self.axes.set_xlabel(xlabel)
         self.axes.set_ylabel(ylabel)
         self.draw()
 
+    def updateLines(self, axes):
+        xmin, xmax = axes.get_xlim()
+        first = max(0, np.searchsorted(self.time, xmin) - 1)
+        last = min(len(self.time), np.searchsorted(self.time, xmax, 'right') + 1)
+        width = max(1, int(axes.bbox.width))
+        for line, signal in self.lines:
+            if isinstance(signal, decimatedSignal):
+                index, values = signal.envelope(first, last, width)
+            else:
+                index, values = np.arange(first, last), signal[first:last]
+            line.set_data(self.time[index], values)
+
     def plot3d(self, x, y, z, xlabel, ylabel, zlabel):
         self.fig.clear()
         self.axes = self.fig.add_subplot(111, projection="3d")
@@ -1948,42 +1968,48 @@ class Ui_MainWindow(object):
 
 
 class simulation():
-    def __init__(self):
-        # Run simulation executable
+    def __init__(self, scenarioFile=None):
+        if os.path.exists(tvcsim.libraryPath()):
+            # Run simulation in-process, records are views on the buffer of the library
+            self.sim = tvcsim.simulation(tvcsim.scenario(scenarioFile))
+            self.sim.run()
+            records = self.sim.records()
+            states, estimates, references, inputs, times = records[0:18], records[18:31], records[31:44], records[44:50], records[50]
+        else:
+            # Library not built, load telemetry written by the simulation executable
+            states, estimates = "data/state.tlm", "data/estimate.tlm"
+            references, inputs = "data/ref.tlm", "data/input.tlm"
+            times = loadTelemetry("data/time.tlm")[2][0]
 
         # Load simulation data
-        self.x_vec = pd.read_csv("data/state.csv", header=None)           # Simulation states
-        self.e_vec = pd.read_csv("data/estimate.csv", header=None)        # Simulation estimated states
-        self.r_vec = pd.read_csv("data/ref.csv", header=None)           # Simulation reference
-        self.u_vec = pd.read_csv("data/input.csv", header=None)           # Simulation inputs
-        self.t_vec = np.genfromtxt('data/time.csv', delimiter=',')        # Simulation time
+        self.x_sig = telemetrySignals(states)                       # Simulation states
+        self.e_sig = telemetrySignals(estimates)                    # Simulation estimated states
+        self.r_sig = telemetrySignals(references)                   # Simulation reference
+        self.u_sig = telemetrySignals(inputs)                       # Simulation inputs
+        self.x_vec, self.e_vec, self.r_vec, self.u_vec = self.x_sig.raw, self.e_sig.raw, self.r_sig.raw, self.u_sig.raw
+        self.t_vec = times                                          # Simulation time
 
         # Current data point
         self.t, self.x, self.y, self.z, self.phi, self.theta, self.psi = np.hstack(( self.t_vec[0],
-                                                                                     np.hstack(( self.x_vec[0][6:9],
-                                                                                                 self.x_vec[0][0:3] )) ))
-        self.p, self.q, self.r, self.u, self.v, self.w = np.hstack(( self.x_vec[0][3:6],
-                                                                     self.x_vec[0][9:12] ))
-        self.theta1, self.theta2, self.omega, self.thetaRate1, self.thetaRate2, self.omegaRate = self.u_vec[0]
+                                                                                     np.hstack(( self.x_vec[6:9, 0],
+                                                                                                 self.x_vec[0:3, 0] )) ))
+        self.p, self.q, self.r, self.u, self.v, self.w = np.hstack(( self.x_vec[3:6, 0],
+                                                                     self.x_vec[9:12, 0] ))
+        self.theta1, self.theta2, self.omega, self.thetaRate1, self.thetaRate2, self.omegaRate = self.u_vec[:, 0]
 
         self.R = self.rotationMatrix()
 
     def rotationMatrix(self):
-        R = np.array([[cos(self.theta) * cos(self.psi), sin(self.phi) * sin(self.theta) * cos(self.psi) - cos(self.phi) * sin(self.psi),
-                         sin(self.phi) * sin(self.psi) + cos(self.phi) * sin(self.theta) * cos(self.psi)],
-                        [cos(self.theta) * sin(self.psi), cos(self.phi) * cos(self.psi) + sin(self.phi) * sin(self.theta) * sin(self.psi),
-                         cos(self.phi) * sin(self.theta) * sin(self.psi) - sin(self.phi) * cos(self.psi)],
-                        [-sin(self.theta), sin(self.phi) * cos(self.theta), cos(self.phi) * cos(self.theta)]])
-        return R
+        return eulerToDCM(np.array([self.phi, self.theta, self.psi]))
 
     def simulate(self):
         index = np.where(np.around(self.t_vec, 2) == np.round(self.t, 2))[0][0]
-        self.x, self.y, self.z, self.phi, self.theta, self.psi = np.hstack((self.x_vec[index][6:9], self.x_vec[index][0:3]))
-        self.p, self.q, self.r, self.u, self.v, self.w = np.hstack(( self.x_vec[index][3:6], self.x_vec[index][9:12] ))
-        self.theta1, self.theta2, self.omega, self.thetaRate1, self.thetaRate2, self.omegaRate = self.u_vec[index]
-        scale = np.amax(np.abs(np.array(self.x_vec.loc[8])))
+        self.x, self.y, self.z, self.phi, self.theta, self.psi = np.hstack((self.x_vec[6:9, index], self.x_vec[0:3, index]))
+        self.p, self.q, self.r, self.u, self.v, self.w = np.hstack(( self.x_vec[3:6, index], self.x_vec[9:12, index] ))
+        self.theta1, self.theta2, self.omega, self.thetaRate1, self.thetaRate2, self.omegaRate = self.u_vec[:, index]
+        scale = np.amax(np.abs(self.x_vec[8]))
         rotationMatrix = pyrr.Matrix44(Eframe2GlframeRotation(self.rotationMatrix()))
-        translationMatrix = pyrr.matrix44.create_from_translation(Eframe2GlframeTranslation(self.x_vec[index][6:9] / scale))
+        translationMatrix = pyrr.matrix44.create_from_translation(Eframe2GlframeTranslation(self.x_vec[6:9, index] / scale))
         model = rotationMatrix.dot(translationMatrix)
         return model
 
@@ -2051,7 +2077,11 @@ class MainWindow(QtWidgets.QMainWindow):
             self.ui.openGLWidget.repaint()        # Update OpenGL widget
 
     def runSimulation(self):
-        self.ui.openGLWidget.simulation = simulation()                                      # Create simulation object
+        try:
+            self.ui.openGLWidget.simulation = simulation()                                  # Create simulation object
+        except (OSError, RuntimeError) as error:                                            # Library fails to load or simulate
+            QtWidgets.QMessageBox.critical(self, "Simulation failed", str(error))
+            return
         self.max = self.ui.openGLWidget.simulation.t_vec[-1]
         self.ui.horizontalSlider.setMaximum(int(100*round(self.max, 2)))
         self.generateGraphs()
@@ -2070,48 +2100,48 @@ class MainWindow(QtWidgets.QMainWindow):
 
     def generateGraphs(self):
         t = self.ui.openGLWidget.simulation.t_vec
-        x = np.array(self.ui.openGLWidget.simulation.x_vec)
-        e = np.array(self.ui.openGLWidget.simulation.e_vec)
-        r = np.array(self.ui.openGLWidget.simulation.r_vec)
-        u = np.array(self.ui.openGLWidget.simulation.u_vec)
+        x = self.ui.openGLWidget.simulation.x_sig
+        e = self.ui.openGLWidget.simulation.e_sig
+        r = self.ui.openGLWidget.simulation.r_sig
+        u = self.ui.openGLWidget.simulation.u_sig
         # Page 1: earth-fixed graphs
-        self.ui.graph1_1.plot2D(t, x[:][6], "Time [s]", "X position [m]", r[:][10], e[:][6])
-        self.ui.graph1_2.plot2D(t, x[:][7], "Time [s]", "Y position [m]", r[:][11], e[:][7])
-        self.ui.graph1_3.plot2D(t, -x[:][8], "Time [s]", "Z position [m]", -r[:][12], -e[:][8])
+        self.ui.graph1_1.plot2D(t, x(6), "Time [s]", "X position [m]", r(10), e(6))
+        self.ui.graph1_2.plot2D(t, x(7), "Time [s]", "Y position [m]", r(11), e(7))
+        self.ui.graph1_3.plot2D(t, x(8, -1), "Time [s]", "Z position [m]", r(12, -1), e(8, -1))
 
-        self.ui.graph1_4.plot2D(t, x[:][12], "Time [s]", "X velocity [m/s]", r[:][7])
-        self.ui.graph1_5.plot2D(t, x[:][13], "Time [s]", "Y velocity [m/s]", r[:][8])
-        self.ui.graph1_6.plot2D(t, -x[:][14], "Time [s]", "Z velocity [m/s]", -r[:][9])
+        self.ui.graph1_4.plot2D(t, x(12), "Time [s]", "X velocity [m/s]", r(7))
+        self.ui.graph1_5.plot2D(t, x(13), "Time [s]", "Y velocity [m/s]", r(8))
+        self.ui.graph1_6.plot2D(t, x(14, -1), "Time [s]", "Z velocity [m/s]", r(9, -1))
 
         # Page 2: earth-fixed graphs
-        self.ui.graph2_1.plot2D(t, x[:][15], "Time [s]", "X acceleration [m/s2]", r[:][4])
-        self.ui.graph2_2.plot2D(t, x[:][16], "Time [s]", "Y acceleration [m/s2]", r[:][5])
-        self.ui.graph2_3.plot2D(t, -x[:][17], "Time [s]", "Z acceleration [m/s2]", -r[:][6])
+        self.ui.graph2_1.plot2D(t, x(15), "Time [s]", "X acceleration [m/s2]", r(4))
+        self.ui.graph2_2.plot2D(t, x(16), "Time [s]", "Y acceleration [m/s2]", r(5))
+        self.ui.graph2_3.plot2D(t, x(17, -1), "Time [s]", "Z acceleration [m/s2]", r(6, -1))
 
-        self.ui.graph2_4.plot2D(t, x[:][0]*180/pi, "Time [s]", "Roll angle [deg]", r[:][2]*180/pi, e[:][0]*180/pi)
-        self.ui.graph2_5.plot2D(t, x[:][1]*180/pi, "Time [s]", "Pitch angle [deg]", r[:][3]*180/pi, e[:][1]*180/pi)
-        self.ui.graph2_6.plot2D(t, x[:][2]*180/pi, "Time [s]", "Yaw angle [deg]", None, e[:][2]*180/pi)
+        self.ui.graph2_4.plot2D(t, x(0, 180/pi), "Time [s]", "Roll angle [deg]", r(2, 180/pi), e(0, 180/pi))
+        self.ui.graph2_5.plot2D(t, x(1, 180/pi), "Time [s]", "Pitch angle [deg]", r(3, 180/pi), e(1, 180/pi))
+        self.ui.graph2_6.plot2D(t, x(2, 180/pi), "Time [s]", "Yaw angle [deg]", None, e(2, 180/pi))
 
         # Page 3: body-fixed graphs
-        self.ui.graph3_1.plot2D(t, x[:][9], "Time [s]", "X velocity [m/s]", None, e[:][9])
-        self.ui.graph3_2.plot2D(t, x[:][10], "Time [s]", "Y velocity [m/s]", None, e[:][10])
-        self.ui.graph3_3.plot2D(t, x[:][11], "Time [s]", "Z velocity [m/s]", None, e[:][11])
+        self.ui.graph3_1.plot2D(t, x(9), "Time [s]", "X velocity [m/s]", None, e(9))
+        self.ui.graph3_2.plot2D(t, x(10), "Time [s]", "Y velocity [m/s]", None, e(10))
+        self.ui.graph3_3.plot2D(t, x(11), "Time [s]", "Z velocity [m/s]", None, e(11))
 
-        self.ui.graph3_4.plot2D(t, x[:][3]*180/pi, "Time [s]", "Roll rate [deg/s]", r[:][0]*180/pi, e[:][3]*180/pi)
-        self.ui.graph3_5.plot2D(t, x[:][4]*180/pi, "Time [s]", "Pitch rate [deg/s]", r[:][1]*180/pi, e[:][4]*180/pi)
-        self.ui.graph3_6.plot2D(t, x[:][5]*180/pi, "Time [s]", "Yaw rate [deg/s]", None, e[:][5]*180/pi)
+        self.ui.graph3_4.plot2D(t, x(3, 180/pi), "Time [s]", "Roll rate [deg/s]", r(0, 180/pi), e(3, 180/pi))
+        self.ui.graph3_5.plot2D(t, x(4, 180/pi), "Time [s]", "Pitch rate [deg/s]", r(1, 180/pi), e(4, 180/pi))
+        self.ui.graph3_6.plot2D(t, x(5, 180/pi), "Time [s]", "Yaw rate [deg/s]", None, e(5, 180/pi))
 
         # Page 4: inputs
-        self.ui.graph4_1.plot2D(t, u[:][0]*180/pi, "Time [s]", "X gimbal angle [deg]")
-        self.ui.graph4_2.plot2D(t, u[:][1]*180/pi, "Time [s]", "Y gimbal angle [deg]")
-        self.ui.graph4_3.plot2D(t, u[:][2], "Time [s]", "Prop. rotational velocity [deg/s]")
+        self.ui.graph4_1.plot2D(t, u(0, 180/pi), "Time [s]", "X gimbal angle [deg]")
+        self.ui.graph4_2.plot2D(t, u(1, 180/pi), "Time [s]", "Y gimbal angle [deg]")
+        self.ui.graph4_3.plot2D(t, u(2), "Time [s]", "Prop. rotational velocity [deg/s]")
 
-        self.ui.graph4_4.plot2D(t, u[:][3]*180/pi, "Time [s]", "X gimbal rate [deg/s]")
-        self.ui.graph4_5.plot2D(t, u[:][4]*180/pi, "Time [s]", "Y gimbal rate [deg/s]")
-        self.ui.graph4_6.plot2D(t, u[:][5], "Time [s]", "Prop. rotational acceleration [deg/s^2]")
+        self.ui.graph4_4.plot2D(t, u(3, 180/pi), "Time [s]", "X gimbal rate [deg/s]")
+        self.ui.graph4_5.plot2D(t, u(4, 180/pi), "Time [s]", "Y gimbal rate [deg/s]")
+        self.ui.graph4_6.plot2D(t, u(5), "Time [s]", "Prop. rotational acceleration [deg/s^2]")
 
         # Page 5: trajectory
-        self.ui.graph5_1.plot3d(x[:][6], x[:][7], x[:][8], "X position [m]", "Y position [m]", "Z position [m]")
+        self.ui.graph5_1.plot3d(x.raw[6], x.raw[7], x.raw[8], "X position [m]", "Y position [m]", "Z position [m]")
 
     def keyReleaseEvent(self, event):
         self.ui.openGLWidget.processKeyInput(event)
@@ -1,15 +1,23 @@
 import numpy as np
+import os
 from numpy import cos, sin
 
 
-def Bframe2Eframe(attitude, axisB):
-    phi,theta,psi = attitude
+def eulerToDCM(attitude):
+    # Rotation from body-fixed to earth-fixed frame of roll, pitch and yaw angle; for angles
+    # of shape (3, N) the result is of shape (N, 3, 3)
+    sphi, sth, spsi = sin(attitude)
+    cphi, cth, cpsi = cos(attitude)
+
+    Mbe = np.array([[cth*cpsi, sphi*sth*cpsi-cphi*spsi, sphi*spsi+cphi*sth*cpsi],
+                    [cth*spsi, cphi*cpsi+sphi*sth*spsi, cphi*sth*spsi-sphi*cpsi],
+                    [-sth, sphi*cth, cphi*cth]])
+
+    return np.moveaxis(Mbe, [0, 1], [-2, -1])
 
-    Mbe = np.array([[cos(theta)*cos(psi), sin(phi)*sin(theta)*cos(psi)-cos(phi)*sin(psi), sin(phi)*sin(psi)+cos(phi)*sin(theta)*cos(psi)],
-                    [cos(theta)*sin(psi), cos(phi)*cos(psi)+sin(phi)*sin(theta)*sin(psi), cos(phi)*sin(theta)*sin(psi)-sin(phi)*cos(psi)],
-                    [-sin(theta), sin(phi)*cos(theta), cos(phi)*cos(theta)]])
 
-    axisE = Mbe.dot(axisB)
+def Bframe2Eframe(attitude, axisB):
+    axisE = eulerToDCM(attitude).dot(axisB)
 
     return axisE
 
@@ -41,3 +49,136 @@ def normalize(v):
     if norm == 0:
         return v
     return v/norm
+
+
+def loadTelemetry(fileName):
+    # Map telemetry file written by telemetryWriter (include/telemetry.h), returns the
+    # channel names, units and an array with one row per channel and one column per sample
+    header = np.fromfile(fileName, dtype=np.dtype([('magic', 'S8'), ('version', '<u4'), ('channels', '<u4'),
+                                                   ('chunkSamples', '<u4'), ('flags', '<u4'),
+                                                   ('samples', '<u8'), ('dataOffset', '<u8')]), count=1)[0]
+    if header['magic'] != b'TVCLOG' or header['version'] != 1:
+        raise ValueError("Not a telemetry file: " + fileName)
+    if header['flags'] & 1:
+        raise ValueError("Compressed telemetry cannot be mapped, read it with telemetryReader: " + fileName)
+
+    nChannels, chunkSamples, nSamples = int(header['channels']), int(header['chunkSamples']), int(header['samples'])
+    table = np.fromfile(fileName, dtype=np.dtype([('name', 'S40'), ('unit', 'S16'), ('dtype', 'S8')]),
+                        count=nChannels, offset=64)
+    if np.any(table['dtype'] != b'<f4'):
+        raise ValueError("Unsupported telemetry data type in " + fileName)
+
+    nChunks = -(-nSamples // chunkSamples)
+    if nChunks == 0:
+        return [n.decode() for n in table['name']], [u.decode() for u in table['unit']], np.zeros((nChannels, 0), np.float32)
+
+    chunks = np.memmap(fileName, dtype='<f4', mode='r', offset=int(header['dataOffset']),
+                       shape=(nChunks, nChannels, chunkSamples))
+
+    # Single chunk files give a view on the mapped file, chunked files are copied once
+    data = chunks[0] if nChunks == 1 else chunks.transpose(1, 0, 2).reshape(nChannels, -1)
+
+    return [n.decode() for n in table['name']], [u.decode() for u in table['unit']], data[:, :nSamples]
+
+
+def loadCatalog(directory):
+    # Map index of a run catalog (include/runCatalog.h), returns a record array with the fields
+    # id, seed, scenarioHash and each catalog field, e.g. runs[(runs['mass'] > 1.9) & (runs['maxTilt'] > 20)]
+    fileName = os.path.join(directory, 'catalog.idx')
+    header = np.fromfile(fileName, dtype=np.dtype([('magic', 'S8'), ('version', '<u4'), ('fields', '<u4'),
+                                                   ('recordSize', '<u4'), ('pad', '<u4'), ('runs', '<u8')]), count=1)[0]
+    if header['magic'] != b'TVCRUNS' or header['version'] != 1:
+        raise ValueError("Not a run catalog: " + fileName)
+
+    nFields, nRuns = int(header['fields']), int(header['runs'])
+    names = [n.decode() for n in np.fromfile(fileName, dtype='S32', count=nFields, offset=64)]
+    record = np.dtype({'names': ['id', 'seed', 'scenarioHash'] + names,
+                       'formats': ['<u8', '<u8', '<u8'] + ['<f4']*nFields,
+                       'offsets': [0, 8, 16] + [24 + 4*i for i in range(nFields)],
+                       'itemsize': int(header['recordSize'])})
+    if nRuns == 0:
+        return np.zeros(0, dtype=record)
+    return np.memmap(fileName, dtype=record, mode='r', offset=64 + 32*nFields, shape=(nRuns,))
+
+
+def loadPyramid(fileName):
+    # Map min/max level of detail pyramid written alongside a telemetry file (include/lodPyramid.h),
+    # returns the bucket size and data of each level, the data holds the minimum of every channel
+    # followed by the maximum over buckets of that many raw samples
+    base = fileName[:-4] if fileName.endswith('.tlm') else fileName
+    levels = []
+    while os.path.exists(base + '.lod' + str(len(levels) + 1) + '.tlm'):
+        levelName = base + '.lod' + str(len(levels) + 1) + '.tlm'
+        bucketSize = int(np.fromfile(levelName, dtype='<u8', count=1, offset=48)[0])
+        levels.append((bucketSize, loadTelemetry(levelName)[2]))
+    return levels
+
+
+def buildPyramid(raw, factor=4, maxLevels=12):
+    # Min/max level of detail pyramid of channels held in memory, one row per channel, in the
+    # layout of loadPyramid. Like lodPyramid, a level is created once its first bucket is complete.
+    levels = []
+    low = high = raw
+    while len(levels) < maxLevels and low.shape[1] >= factor:
+        starts = np.arange(0, low.shape[1], factor)
+        low, high = np.minimum.reduceat(low, starts, axis=1), np.maximum.reduceat(high, starts, axis=1)
+        levels.append((factor**(len(levels) + 1), np.vstack((low, high))))
+    return levels
+
+
+class decimatedSignal():
+    # Channel of a telemetry file, reduced to a min/max envelope of about twice the plot width
+    def __init__(self, raw, levels, channel, scale=1.0):
+        self.raw = raw
+        self.levels = levels
+        self.channel = channel
+        self.scale = scale
+
+    def __len__(self):
+        return self.raw.shape[1]
+
+    def envelope(self, first, last, width):
+        # Returns sample indices and values of the envelope of samples [first, last)
+        first, last, width = max(0, first), min(len(self), last), max(1, int(width))
+        if last - first <= 2*width or not self.levels:
+            return np.arange(first, last), self.scale*self.raw[self.channel, first:last]
+
+        # Coarsest level that still has at least one bucket per pixel
+        size, level = 1, None
+        for s, l in self.levels:
+            if (last - first) // s < width:
+                break
+            size, level = s, l
+
+        if level is None:
+            low = high = self.raw[self.channel, first:last]
+        else:
+            nChannels = level.shape[0] // 2
+            low = level[self.channel, first // size:-(-last // size)]
+            high = level[nChannels + self.channel, first // size:-(-last // size)]
+
+        # Combine buckets into one bucket per pixel
+        group = -(-len(low) // width)
+        starts = np.arange(0, len(low), group)
+        low = np.minimum.reduceat(low, starts)
+        high = np.maximum.reduceat(high, starts)
+
+        index = (first // size + starts)*size if level is not None else first + starts
+        values = np.empty(2*len(low), dtype=low.dtype)
+        values[0::2], values[1::2] = low, high
+        if self.scale < 0:
+            values[0::2], values[1::2] = high, low
+        return np.repeat(np.minimum(index, len(self) - 1), 2), self.scale*values
+
+
+class telemetrySignals():
+    # Channels of a telemetry file together with its level of detail pyramid, or channels held
+    # in memory, one row per channel
+    def __init__(self, source):
+        if isinstance(source, str):
+            self.raw, self.levels = loadTelemetry(source)[2], loadPyramid(source)
+        else:
+            self.raw, self.levels = source, buildPyramid(source)
+
+    def __call__(self, channel, scale=1.0):
+        return decimatedSignal(self.raw, self.levels, channel, scale)
@@ -0,0 +1,124 @@
+import ctypes
+import os
+import numpy as np
+
+
+def libraryPath():
+    # Default location of the simulator library: $TVCSIM_LIBRARY or build/src/libtvcsim.so in
+    # the project root
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    return os.environ.get('TVCSIM_LIBRARY', os.path.join(root, 'build', 'src', 'libtvcsim.so'))
+
+
+def loadLibrary(fileName=None):
+    # Load the simulator library built by cmake (include/tvcsim.h), by default from libraryPath
+    lib = ctypes.CDLL(libraryPath() if fileName is None else fileName)
+
+    scenarioPtr, simulationPtr, floatPtr, intPtr = ctypes.c_void_p, ctypes.c_void_p, ctypes.POINTER(ctypes.c_float), ctypes.POINTER(ctypes.c_int)
+    signatures = {
+        'tvcsimVersion': (ctypes.c_char_p, []),
+        'tvcsimLastError': (ctypes.c_char_p, []),
+        'tvcsimCreateScenario': (scenarioPtr, []),
+        'tvcsimLoadScenario': (scenarioPtr, [ctypes.c_char_p]),
+        'tvcsimDestroyScenario': (None, [scenarioPtr]),
+        'tvcsimSetParameter': (ctypes.c_int, [scenarioPtr, ctypes.c_char_p, ctypes.c_char_p]),
+        'tvcsimGetParameter': (ctypes.c_int, [scenarioPtr, ctypes.c_char_p, floatPtr, ctypes.c_int]),
+        'tvcsimCreateSimulation': (simulationPtr, [scenarioPtr]),
+        'tvcsimDestroySimulation': (None, [simulationPtr]),
+        'tvcsimStep': (ctypes.c_int, [simulationPtr, ctypes.c_int]),
+        'tvcsimRun': (ctypes.c_int, [simulationPtr, floatPtr]),
+        'tvcsimFinished': (ctypes.c_int, [simulationPtr]),
+        'tvcsimMetrics': (None, [simulationPtr, floatPtr]),
+        'tvcsimRecords': (floatPtr, [simulationPtr, intPtr, intPtr]),
+        'tvcsimChannels': (ctypes.c_int, []),
+        'tvcsimChannelName': (ctypes.c_char_p, [ctypes.c_int]),
+        'tvcsimChannelUnit': (ctypes.c_char_p, [ctypes.c_int]),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        getattr(lib, name).restype = restype
+        getattr(lib, name).argtypes = argtypes
+    return lib
+
+
+_lib = None
+
+
+def library():
+    # Simulator library, loaded on first use
+    global _lib
+    if _lib is None:
+        _lib = loadLibrary()
+    return _lib
+
+
+def _check(result, failure):
+    if result == failure:
+        raise RuntimeError(library().tvcsimLastError().decode())
+    return result
+
+
+class scenario():
+    # Scenario of the simulator library: nominal, or read from a scenario file, without
+    # telemetry files unless set, e.g. scenario()['position.p'] = [0.8, 0.8, 1.0]
+    def __init__(self, fileName=None):
+        lib = library()
+        self.handle = _check(lib.tvcsimCreateScenario() if fileName is None else lib.tvcsimLoadScenario(fileName.encode()), None)
+
+    def __del__(self):
+        if getattr(self, 'handle', None):
+            library().tvcsimDestroyScenario(self.handle)
+
+    def __setitem__(self, key, value):
+        if not isinstance(value, str):
+            value = ' '.join(str(float(v)) for v in np.atleast_1d(value))
+        _check(library().tvcsimSetParameter(self.handle, key.encode(), value.encode()), -1)
+
+    def __getitem__(self, key):
+        size = _check(library().tvcsimGetParameter(self.handle, key.encode(), None, 0), -1)
+        values = np.zeros(size, np.float32)
+        library().tvcsimGetParameter(self.handle, key.encode(), values.ctypes.data_as(ctypes.POINTER(ctypes.c_float)), size)
+        return values
+
+
+class simulation():
+    # Simulation of a scenario in-process, with its records in memory
+    def __init__(self, scenario):
+        self.handle = _check(library().tvcsimCreateSimulation(scenario.handle), None)
+
+    def __del__(self):
+        if getattr(self, 'handle', None):
+            library().tvcsimDestroySimulation(self.handle)
+
+    def step(self, steps=1):
+        # Advance by a number of sampling times, returns the number of steps taken
+        return _check(library().tvcsimStep(self.handle, steps), -1)
+
+    def run(self):
+        # Run to the end, returns the summary metrics
+        metrics = np.zeros(4, np.float32)
+        _check(library().tvcsimRun(self.handle, metrics.ctypes.data_as(ctypes.POINTER(ctypes.c_float))), -1)
+        return metrics
+
+    def finished(self):
+        return library().tvcsimFinished(self.handle) == 1
+
+    def metrics(self):
+        metrics = np.zeros(4, np.float32)
+        library().tvcsimMetrics(self.handle, metrics.ctypes.data_as(ctypes.POINTER(ctypes.c_float)))
+        return metrics
+
+    def records(self):
+        # View on the records without copying, one row per channel and one column per sample,
+        # valid while the simulation exists
+        channels, samples = ctypes.c_int(), ctypes.c_int()
+        data = library().tvcsimRecords(self.handle, ctypes.byref(channels), ctypes.byref(samples))
+        if samples.value == 0:
+            return np.zeros((channels.value, 0), np.float32)
+        return np.ctypeslib.as_array(data, shape=(samples.value, channels.value)).T
+
+
+def channels():
+    # Names and units of the channels of a record
+    lib = library()
+    return [lib.tvcsimChannelName(k).decode() for k in range(lib.tvcsimChannels())], \
+           [lib.tvcsimChannelUnit(k).decode() for k in range(lib.tvcsimChannels())]
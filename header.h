@@ -11,10 +11,45 @@
 #include <fstream>
 #include <math.h>
 #include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
 
-#include "include/saturator.h"       // include src code
+#include "include/mappedFile.h"      // include src code
+#include "include/compression.h"
+#include "include/telemetry.h"
+#include "include/telemetryStream.h"
+#include "include/lodPyramid.h"
+#include "include/flightRecorder.h"
+#include "include/runCatalog.h"
+#include "include/runDiff.h"
+#include "include/reference.h"
+#include "include/sampledReference.h"
+#include "include/minSnapTrajectory.h"
+#include "include/attitude.h"
+#include "include/snapshot.h"
+#include "include/snapshot.ipp"
+#include "include/saturator.h"
 #include "include/filter.h"
+#include "include/measurementQueue.h"
+#include "include/threadPool.h"
+#include "include/progressReporter.h"
+#include "include/randomStream.h"
 #include "include/estimator.h"
+#include "include/ESKFestimator.h"
+#include "include/UKFestimator.h"
+#include "include/PFestimator.h"
 #include "include/controller.h"
 #include "include/controller.ipp"
 #include "include/dynamics.h"
@@ -23,7 +58,13 @@
 #include "include/PIDcontroller.h"
 #include "include/INDIcontroller.h"
 #include "include/actuator.h"
+#include "include/delayLine.h"
 #include "include/sensor.h"
+#include "include/scenario.h"
+#include "include/resultCache.h"
+#include "include/simulation.h"
+#include "include/monteCarlo.h"
+#include "include/tvcsim.h"
 
 #include "scripts/PIDattitudeControl.h"     // include scripts
 
@@ -0,0 +1,163 @@
+/**
+ *	\file include/ESKFestimator.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+class ESKFestimator : public estimator
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+        /** Default constructor
+         */
+        ESKFestimator( );
+
+        /**
+         * @brief Initialize error-state estimator
+         *
+         * @param[in] _initEstimate     System initial state
+         * @param[in] _initTime         Initial time
+         * @param[in] _samplingTime     Sampling time
+         */
+        ESKFestimator( VectorXf& _initEstimate, float _initTime, float _samplingTime );
+
+        /** Copy constructor
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		ESKFestimator( const ESKFestimator& rhs );
+
+		/** Destructor.
+		 */
+		~ESKFestimator( );
+
+
+        using estimator::estimateState;
+
+        /**
+         * @brief Propagate nominal state with the measured IMU body rates and specific force
+         *        and correct attitude with the IMU attitude
+         *
+         * @param[in] _u        Control input (unused, the filter is driven by the IMU)
+         * @param[in] _y        Measured IMU output: Euler angles, body rates and specific force
+         * @param[out] _x       State estimate
+         */
+        void estimateState( VectorXf& _u, VectorXf& _y, VectorXf& _x ) override;
+
+        /**
+         * @brief Correct error state with a measurement and reset the nominal state.
+         *        For IMU measurements only the attitude is used, since the gyro
+         *        already drives the propagation.
+         *
+         * @param[in] _measurement      Measurement
+         */
+        void update( const measurement& _measurement ) override;
+
+        /**
+         * @brief Assign covariance update method. Only the Joseph-form update of the error state
+         *        is supported, other methods throw.
+         *
+         * @param[in] _method           Update method
+         */
+        void setUpdateMethod( updateMethod _method ) override;
+
+        /**
+         * @brief Normalized estimation error squared of position, velocity and attitude
+         *
+         * @param[in] _trueState        True system state
+         *
+         * \return NEES, chi-squared distributed with 9 degrees of freedom for a consistent filter
+         */
+        float NEES( const VectorXf& _trueState ) override;
+
+        /**
+         * @brief Append nominal state, biases and error covariance to snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const override;
+
+        /**
+         * @brief Restore nominal state, biases and error covariance from snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot ) override;
+
+
+        /**
+         * @brief Assign IMU noise densities and bias random walks
+         *
+         * @param[in] _accelNoise       Accelerometer noise density [m/s2/sqrt(Hz)]
+         * @param[in] _gyroNoise        Gyroscope noise density [rad/s/sqrt(Hz)]
+         * @param[in] _accelBiasWalk    Accelerometer bias random walk [m/s3/sqrt(Hz)]
+         * @param[in] _gyroBiasWalk     Gyroscope bias random walk [rad/s2/sqrt(Hz)]
+         */
+        void setIMUNoise( float _accelNoise, float _gyroNoise, float _accelBiasWalk, float _gyroBiasWalk );
+
+
+
+    //
+    // PUBLIC DATA MEMBERS
+    //
+    public:
+        Matrix<float,15,15> errorCovariance;        // Covariance of error state (dp, dv, dtheta, dba, dbg)
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /**
+         * @brief Propagate nominal state and error covariance over one sampling interval
+         *
+         * @param[in] _gyro             Measured angular velocity (body) [rad/s]
+         * @param[in] _specificForce    Measured specific force (body) [m/s2]
+         */
+        void propagate( const Vector3f& _gyro, const Vector3f& _specificForce );
+
+        /**
+         * @brief Predicted measurement for the nominal state with an injected error state
+         *
+         * @param[in] _type             Measurement type
+         * @param[in] _dx               Error state
+         * @param[out] _z               Predicted measurement
+         *
+         * \return number of measurement channels
+         */
+        int errorMeasurementModel( measurementType _type, const Matrix<float,15,1>& _dx, Matrix<float,6,1>& _z );
+
+        /**
+         * @brief Write nominal state to 12-state Euler angle representation
+         */
+        void nominalToState( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        Vector3f position;              // Nominal position (NED) [m]
+        Vector3f velocity;              // Nominal velocity (NED) [m/s]
+        Quaternionf attitude;           // Nominal attitude, body to NED
+        Vector3f accelBias;             // Accelerometer bias [m/s2]
+        Vector3f gyroBias;              // Gyroscope bias [rad/s]
+
+        Vector3f lastGyro;              // Last gyro sample, used for body rate output
+
+        float accelNoise = 0.05;        // Accelerometer noise density
+        float gyroNoise = 0.005;        // Gyroscope noise density
+        float accelBiasWalk = 1e-3;     // Accelerometer bias random walk
+        float gyroBiasWalk = 1e-4;      // Gyroscope bias random walk
+};
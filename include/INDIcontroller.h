@@ -44,6 +44,12 @@ class INDIcontroller : public controller
          */
         INDIcontroller( const INDIcontroller& _rhs );
 
+        /** Copy assignment operator
+         * 
+         * @param[in] _rhs      Right-hand side object
+         */
+        INDIcontroller& operator=( const INDIcontroller& _rhs );
+
         /** Destructor
          */
         ~INDIcontroller(  );
@@ -59,6 +65,22 @@ class INDIcontroller : public controller
         void computeControlEffectiveness( VectorXf& currentAttitude, VectorXf& currentGimbal, VectorXf& currentOmega, VectorXf& parameters );
 
 
+        /** 
+         * @brief Append current input and control effectiveness to snapshot
+         * 
+         * @param[in] _snapshot             Snapshot
+         */
+        void save( snapshot& _snapshot ) const override;
+
+
+        /** 
+         * @brief Restore current input and control effectiveness from snapshot
+         * 
+         * @param[in] _snapshot             Snapshot
+         */
+        void restore( snapshot& _snapshot ) override;
+
+
     //
     // PRIVATE MEMBER FUNCTIONS
     //
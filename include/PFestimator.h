@@ -0,0 +1,188 @@
+/**
+ *	\file include/PFestimator.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+class PFestimator : public estimator
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+        /** Default constructor
+         */
+        PFestimator( );
+
+        /**
+         * @brief Initialize particle filter
+         *
+         * @param[in] _initEstimate     System initial state
+         * @param[in] _initTime         Initial time
+         * @param[in] _samplingTime     Sampling time
+         * @param[in] _nParticles       Number of particles
+         * @param[in] _nThreads         Number of threads used for propagation and resampling
+         */
+        PFestimator( VectorXf& _initEstimate, float _initTime, float _samplingTime, int _nParticles, unsigned int _nThreads );
+
+        /** Copy constructor
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		PFestimator( const PFestimator& rhs );
+
+		/** Destructor.
+		 */
+		~PFestimator( );
+
+
+        /**
+         * @brief Draw particles from the initial estimate and initial covariance
+         */
+        void init( ) override;
+
+        using estimator::estimateState;
+
+        /**
+         * @brief Propagate particles through the model with process noise and weight
+         *        them with the IMU attitude and body rates
+         *
+         * @param[in] _u        Control input
+         * @param[in] _y        System output vector
+         * @param[out] _x       State estimate (weighted mean of particles)
+         */
+        void estimateState( VectorXf& _u, VectorXf& _y, VectorXf& _x ) override;
+
+        /**
+         * @brief Weight particles with the likelihood of a measurement and resample
+         *        when the effective number of particles becomes too small. Sharp
+         *        likelihoods are applied in stages (progressive correction).
+         *
+         * @param[in] _measurement      Measurement
+         */
+        void update( const measurement& _measurement ) override;
+
+        /**
+         * @brief Assign covariance update method. The particle filter has no covariance to
+         *        update, so only the default method is accepted and other methods throw.
+         *
+         * @param[in] _method           Update method
+         */
+        void setUpdateMethod( updateMethod _method ) override;
+
+
+        /**
+         * @brief Assign effective sample size, relative to the number of particles,
+         *        below which the particles are resampled
+         *
+         * @param[in] _threshold        Resampling threshold [0-1]
+         */
+        void setResampleThreshold( float _threshold );
+
+        /**
+         * @brief Key particle noise streams and redraw particles
+         *
+         * @param[in] _seed             Global random seed
+         * @param[in] _run              Run number
+         */
+        void setSeed( unsigned long _seed, unsigned long _run = 0 );
+
+        /**
+         * @brief Append particles, weights and noise stream positions to snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const override;
+
+        /**
+         * @brief Restore particles, weights and noise stream positions from snapshot. The
+         *        streams keep their own seed and run number, so a restored filter draws the
+         *        noise of its own run from the restored position on.
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot ) override;
+
+
+
+    //
+    // PUBLIC DATA MEMBERS
+    //
+    public:
+        float effectiveSampleSize;                      // Effective number of particles after last update
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /**
+         * @brief Predicted measurement of a batch of particles
+         *
+         * @param[in] _type             Measurement type
+         * @param[in] _X                Particles, one column per particle
+         * @param[out] _Z               Predicted measurements, one column per particle
+         *
+         * \return number of measurement channels
+         */
+        int measurementModelBatch( measurementType _type, const constStateBatchRef& _X, Matrix<float,6,Dynamic,RowMajor>& _Z );
+
+        /**
+         * @brief Gaussian log-likelihood of a measurement for every particle
+         *
+         * @param[in] _measurement      Measurement
+         * @param[in] _nz               Number of measurement channels
+         */
+        void calculateLogLikelihood( const measurement& _measurement, int _nz );
+
+        /**
+         * @brief Effective number of particles if a fraction of the log-likelihood
+         *        were added to the current weights
+         *
+         * @param[in] _fraction         Fraction of log-likelihood [0-1]
+         */
+        float effectiveSamples( float _fraction );
+
+        /**
+         * @brief Systematic resampling, using a parallel prefix sum of the weights, followed
+         *        by regularization with a kernel scaled to the current state covariance
+         */
+        void resample( );
+
+        /**
+         * @brief Weighted mean and covariance of the particles
+         */
+        void calculateEstimate( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        static constexpr int blockSize = 256;           // Particles per block, each block has its own noise stream
+        static const int maxStages = 32;                 // Maximum number of progressive correction stages
+
+        int nParticles = 1000;                          // Number of particles
+        int nBlocks;                                    // Number of particle blocks
+        float resampleThreshold = 0.5;                  // Relative effective sample size triggering resampling
+        unsigned long seed = 0;                         // Global seed of noise streams
+        unsigned long run = 0;                          // Run number of noise streams
+
+        stateBatch particles;                           // Particles, one column per particle
+        stateBatch resampled;                           // Buffer for resampled particles
+        VectorXf logWeights;                            // Logarithm of unnormalized particle weights
+        VectorXf logLikelihood;                         // Log-likelihood of last measurement
+        VectorXf weights;                               // Normalized particle weights
+
+        std::vector<randomStream> streams;              // Noise stream per block
+        std::unique_ptr<threadPool> pool;               // Threads processing particle blocks
+};
@@ -44,6 +44,12 @@ class PIDcontroller : public controller
          */
         PIDcontroller( const PIDcontroller& _rhs );
 
+        /** Copy assignment operator
+         * 
+         * @param[in] _rhs      Right-hand side object
+         */
+        PIDcontroller& operator=( const PIDcontroller& _rhs );
+
         /** Destructor
          */
         ~PIDcontroller(  );
@@ -90,6 +96,22 @@ class PIDcontroller : public controller
         void init( const VectorXf& _x0, const VectorXf& _initU, double startTime );
 
 
+        /** 
+         * @brief Append integrator, derivative filter and last error to snapshot
+         * 
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const override;
+
+
+        /** 
+         * @brief Restore integrator, derivative filter and last error from snapshot
+         * 
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot ) override;
+
+
 
     //
     // PRIVATE MEMBER FUNCTIONS
@@ -0,0 +1,116 @@
+/**
+ *	\file include/UKFestimator.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+class UKFestimator : public estimator
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+        /** Default constructor
+         */
+        UKFestimator( );
+
+        /**
+         * @brief Initialize unscented estimator
+         *
+         * @param[in] _initEstimate     System initial state
+         * @param[in] _initTime         Initial time
+         * @param[in] _samplingTime     Sampling time
+         */
+        UKFestimator( VectorXf& _initEstimate, float _initTime, float _samplingTime );
+
+        /** Copy constructor
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		UKFestimator( const UKFestimator& rhs );
+
+		/** Destructor.
+		 */
+		~UKFestimator( );
+
+
+        using estimator::estimateState;
+
+        /**
+         * @brief Propagate sigma points through the model and correct the estimate with
+         *        the IMU attitude and body rates
+         *
+         * @param[in] _u        Control input
+         * @param[in] _y        System output vector
+         * @param[out] _x       State estimate
+         */
+        void estimateState( VectorXf& _u, VectorXf& _y, VectorXf& _x ) override;
+
+        /**
+         * @brief Correct state estimate with a measurement using unscented transform
+         *        of the measurement model
+         *
+         * @param[in] _measurement      Measurement
+         */
+        void update( const measurement& _measurement ) override;
+
+        /**
+         * @brief Assign covariance update method. The unscented update always processes all
+         *        channels at once, so only the batch update is supported and other methods throw.
+         *
+         * @param[in] _method           Update method
+         */
+        void setUpdateMethod( updateMethod _method ) override;
+
+
+        /**
+         * @brief Assign scaling parameters of the sigma points
+         *
+         * @param[in] _alpha        Spread of sigma points around the mean
+         * @param[in] _beta         Prior knowledge of distribution (2 for Gaussian)
+         * @param[in] _kappa        Secondary scaling parameter
+         */
+        void setSigmaPointParameters( float _alpha, float _beta, float _kappa );
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /**
+         * @brief Generate sigma points from the Cholesky factor of the state covariance
+         */
+        void generateSigmaPoints( );
+
+        /**
+         * @brief Calculate weights of the sigma points from the scaling parameters
+         */
+        void calculateWeights( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        static const int nSigma = 25;                   // Number of sigma points (2n+1)
+
+        float alpha = 1.0;                              // Spread of sigma points
+        float beta = 2.0;                               // Distribution parameter
+        float kappa = 0.0;                              // Secondary scaling parameter
+        float gamma;                                    // Scaling of Cholesky factor columns
+
+        Matrix<float,nSigma,1> meanWeights;             // Weights for mean
+        Matrix<float,nSigma,1> covWeights;              // Weights for covariance
+
+        stateBatch sigmaPoints;                         // Sigma points, one column per point
+        LLT<Matrix<float,12,12>> covarianceFactor;      // Cholesky factor of state covariance
+};
@@ -37,6 +37,13 @@ class actuator : public saturator
          */
         actuator( const actuator& rhs );
 
+        /**
+         * @brief Copy assignment operator
+         * 
+         * @param[in] rhs       Right-hand side object
+         */
+        actuator& operator=( const actuator& rhs );
+
         /**
          * @brief Destructor
          */
@@ -52,6 +59,21 @@ class actuator : public saturator
         void actuate( VectorXf& _u );
 
 
+        /**
+         * @brief Append last control and control rate to snapshot
+         * 
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const;
+
+        /**
+         * @brief Restore last control and control rate from snapshot
+         * 
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot );
+
+
 
     //
     // PUBLIC DATA MEMBERS
@@ -0,0 +1,232 @@
+/**
+ *	\file include/attitude.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/*  Rotation and attitude math shared by the dynamics, estimators, sensors and controllers.
+ *  Euler angles are roll, pitch and yaw (ZYX sequence), the direction cosine matrix rotates
+ *  from body-fixed to earth-fixed frame (NED) and quaternions are the same rotation.
+ */
+
+
+typedef Array<float,6,Dynamic,RowMajor> eulerTrigBatch;     // sin(phi), cos(phi), sin(theta), cos(theta), sin(psi), cos(psi) of multiple samples, one row each
+typedef Array<float,9,Dynamic,RowMajor> dcmBatch;           // Direction cosine matrices of multiple samples, entry (i,j) in row 3*i+j
+
+
+struct eulerTrig
+{
+    float sphi, cphi;               // Sine and cosine of roll angle
+    float sth, cth;                 // Sine and cosine of pitch angle
+    float spsi, cpsi;               // Sine and cosine of yaw angle
+};
+
+
+/** Sine and cosine of the euler angles, each angle evaluated once
+ *
+ * @param[in] _euler        Euler angles: roll, pitch, yaw [rad]
+ */
+inline eulerTrig eulerTrigonometry( const Vector3f& _euler )
+{
+    eulerTrig t;
+    t.sphi = std::sin( _euler(0) ); t.cphi = std::cos( _euler(0) );
+    t.sth = std::sin( _euler(1) ); t.cth = std::cos( _euler(1) );
+    t.spsi = std::sin( _euler(2) ); t.cpsi = std::cos( _euler(2) );
+    return t;
+}
+
+
+/** Direction cosine matrix from body-fixed to earth-fixed frame
+ *
+ * @param[in] _t            Sine and cosine of the euler angles
+ */
+inline Matrix3f eulerToDCM( const eulerTrig& _t )
+{
+    Matrix3f R;
+    R <<    _t.cth*_t.cpsi, _t.sphi*_t.sth*_t.cpsi - _t.cphi*_t.spsi, _t.sphi*_t.spsi + _t.cphi*_t.sth*_t.cpsi,
+            _t.cth*_t.spsi, _t.cphi*_t.cpsi + _t.sphi*_t.sth*_t.spsi, _t.cphi*_t.sth*_t.spsi - _t.sphi*_t.cpsi,
+            -_t.sth, _t.sphi*_t.cth, _t.cphi*_t.cth;
+    return R;
+}
+
+
+/** Direction cosine matrix from body-fixed to earth-fixed frame
+ *
+ * @param[in] _euler        Euler angles: roll, pitch, yaw [rad]
+ */
+inline Matrix3f eulerToDCM( const Vector3f& _euler )
+{
+    return eulerToDCM( eulerTrigonometry( _euler ) );
+}
+
+
+/** Partial derivatives of the direction cosine matrix with respect to roll and pitch angle
+ *
+ * @param[in] _t            Sine and cosine of the euler angles
+ * @param[out] _dPhi        Derivative with respect to roll angle
+ * @param[out] _dTheta      Derivative with respect to pitch angle
+ */
+inline void eulerToDCMPartials( const eulerTrig& _t, Matrix3f& _dPhi, Matrix3f& _dTheta )
+{
+    _dPhi <<    0, _t.spsi*_t.sphi + _t.cpsi*_t.sth*_t.cphi, _t.spsi*_t.cphi - _t.cpsi*_t.sth*_t.sphi,
+                0, -_t.cpsi*_t.sphi + _t.spsi*_t.sth*_t.cphi, -_t.cpsi*_t.cphi - _t.spsi*_t.sth*_t.sphi,
+                0, _t.cth*_t.cphi, -_t.cth*_t.sphi;
+
+    _dTheta <<  -_t.cpsi*_t.sth, _t.cpsi*_t.cth*_t.sphi, _t.cpsi*_t.cth*_t.cphi,
+                -_t.spsi*_t.sth, _t.spsi*_t.cth*_t.sphi, _t.spsi*_t.cth*_t.cphi,
+                -_t.cth, -_t.sth*_t.sphi, -_t.sth*_t.cphi;
+}
+
+
+/** Quaternion of the euler angles
+ *
+ * @param[in] _euler        Euler angles: roll, pitch, yaw [rad]
+ */
+inline Quaternionf eulerToQuaternion( const Vector3f& _euler )
+{
+    float sr = std::sin( 0.5f*_euler(0) ), cr = std::cos( 0.5f*_euler(0) );
+    float sp = std::sin( 0.5f*_euler(1) ), cp = std::cos( 0.5f*_euler(1) );
+    float sy = std::sin( 0.5f*_euler(2) ), cy = std::cos( 0.5f*_euler(2) );
+
+    return Quaternionf( cr*cp*cy + sr*sp*sy, sr*cp*cy - cr*sp*sy, cr*sp*cy + sr*cp*sy, cr*cp*sy - sr*sp*cy );
+}
+
+
+/** Euler angles of direction cosine matrix from body-fixed to earth-fixed frame
+ *
+ * @param[in] _R            Direction cosine matrix
+ *
+ * \return roll, pitch and yaw angle [rad]
+ */
+inline Vector3f dcmToEuler( const Matrix3f& _R )
+{
+    return Vector3f( std::atan2( _R(2,1), _R(2,2) ), -std::asin( std::max( -1.0f, std::min( 1.0f, _R(2,0) ) ) ), std::atan2( _R(1,0), _R(0,0) ) );
+}
+
+
+/** Euler angles of quaternion
+ *
+ * @param[in] _q            Unit quaternion
+ *
+ * \return roll, pitch and yaw angle [rad]
+ */
+inline Vector3f quaternionToEuler( const Quaternionf& _q )
+{
+    return dcmToEuler( _q.toRotationMatrix() );
+}
+
+
+/** Quaternion of rotation vector (exponential map)
+ *
+ * @param[in] _theta        Rotation vector [rad]
+ */
+inline Quaternionf rotationVectorToQuaternion( const Vector3f& _theta )
+{
+    float angle = _theta.norm();
+
+    if ( angle < 1e-8 )
+        return Quaternionf( 1.0, 0.5*_theta(0), 0.5*_theta(1), 0.5*_theta(2) ).normalized();
+
+    return Quaternionf( AngleAxisf( angle, _theta/angle ) );
+}
+
+
+/** Skew-symmetric cross product matrix
+ *
+ * @param[in] _v            Vector
+ */
+inline Matrix3f skew( const Vector3f& _v )
+{
+    Matrix3f S;
+    S <<    0, -_v(2), _v(1),
+            _v(2), 0, -_v(0),
+            -_v(1), _v(0), 0;
+    return S;
+}
+
+
+
+/*  Batch versions over multiple samples, one column per sample
+ */
+
+/** Sine and cosine of the euler angles of multiple samples
+ *
+ * @param[in] _euler        Euler angles, one row per angle
+ * @param[out] _trig        Sine and cosine of each angle
+ */
+template<typename Derived>
+inline void eulerTrigonometry( const MatrixBase<Derived>& _euler, eulerTrigBatch& _trig )
+{
+    _trig.resize( 6,_euler.cols() );
+    _trig.row(0) = _euler.row(0).array().sin();
+    _trig.row(1) = _euler.row(0).array().cos();
+    _trig.row(2) = _euler.row(1).array().sin();
+    _trig.row(3) = _euler.row(1).array().cos();
+    _trig.row(4) = _euler.row(2).array().sin();
+    _trig.row(5) = _euler.row(2).array().cos();
+}
+
+
+/** Direction cosine matrices of multiple samples
+ *
+ * @param[in] _trig         Sine and cosine of the euler angles
+ * @param[out] _R           Direction cosine matrices
+ */
+inline void eulerToDCM( const eulerTrigBatch& _trig, dcmBatch& _R )
+{
+    auto sphi = _trig.row(0); auto cphi = _trig.row(1);
+    auto sth = _trig.row(2); auto cth = _trig.row(3);
+    auto spsi = _trig.row(4); auto cpsi = _trig.row(5);
+
+    _R.resize( 9,_trig.cols() );
+    _R.row(0) = cth*cpsi;   _R.row(1) = sphi*sth*cpsi - cphi*spsi;  _R.row(2) = sphi*spsi + cphi*sth*cpsi;
+    _R.row(3) = cth*spsi;   _R.row(4) = cphi*cpsi + sphi*sth*spsi;  _R.row(5) = cphi*sth*spsi - sphi*cpsi;
+    _R.row(6) = -sth;       _R.row(7) = sphi*cth;                   _R.row(8) = cphi*cth;
+}
+
+
+/** Quaternions of the euler angles of multiple samples
+ *
+ * @param[in] _euler        Euler angles, one row per angle
+ * @param[out] _q           Quaternions, rows w, x, y, z
+ */
+template<typename Derived>
+inline void eulerToQuaternion( const MatrixBase<Derived>& _euler, Array<float,4,Dynamic,RowMajor>& _q )
+{
+    eulerTrigBatch half;
+    eulerTrigonometry( 0.5f*_euler, half );
+
+    auto sr = half.row(0); auto cr = half.row(1);
+    auto sp = half.row(2); auto cp = half.row(3);
+    auto sy = half.row(4); auto cy = half.row(5);
+
+    _q.resize( 4,_euler.cols() );
+    _q.row(0) = cr*cp*cy + sr*sp*sy;
+    _q.row(1) = sr*cp*cy - cr*sp*sy;
+    _q.row(2) = cr*sp*cy + sr*cp*sy;
+    _q.row(3) = cr*cp*sy - sr*sp*cy;
+}
+
+
+/** Euler angles of direction cosine matrices of multiple samples
+ *
+ * @param[in] _R            Direction cosine matrices
+ * @param[out] _euler       Euler angles, one row per angle
+ */
+inline void dcmToEuler( const dcmBatch& _R, Array<float,3,Dynamic,RowMajor>& _euler )
+{
+    _euler.resize( 3,_R.cols() );
+    for ( Index i=0; i<_R.cols(); ++i )
+    {
+        _euler( 0,i ) = std::atan2( _R( 7,i ), _R( 8,i ) );
+        _euler( 1,i ) = -std::asin( std::max( -1.0f, std::min( 1.0f, _R( 6,i ) ) ) );
+        _euler( 2,i ) = std::atan2( _R( 3,i ), _R( 0,i ) );
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ *	\file include/compression.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>            // #include module
+using namespace Eigen;            // using namespace
+
+
+/** Encoding of a compressed block of float samples
+ */
+enum compressionCodec
+{
+    XOR_CODEC,                      // XOR with previous value, for smooth signals
+    DELTA_OF_DELTA_CODEC            // Delta-of-delta of the bit patterns, for ramps such as time
+};
+
+
+/** Compress block of float samples without loss. Both codecs are tried and the
+ *  smaller encoding is kept.
+ * 
+ * @param[in] values        Samples to be compressed
+ * @param[in] n             Number of samples
+ * @param[out] out          Compressed bytes, appended
+ * 
+ * \returns Codec of the compressed bytes
+ * 
+ */
+compressionCodec compressBlock(const float* values, int n, std::vector<uint8_t>& out);
+
+
+/** Decompress block of float samples
+ * 
+ * @param[in] codec         Codec of the compressed bytes
+ * @param[in] data          Compressed bytes
+ * @param[in] size          Number of compressed bytes
+ * @param[in] n             Number of samples
+ * @param[out] values       Decompressed samples
+ * 
+ */
+void decompressBlock(compressionCodec codec, const uint8_t* data, size_t size, int n, float* values);
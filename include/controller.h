@@ -49,6 +49,13 @@ class controller : public saturator, public filter
          */
         controller ( const controller& rhs );
 
+        /** 
+         * @brief Copy assignment operator
+         * 
+         * @param[in] rhs   Right-hand side object
+         */
+        controller& operator=( const controller& rhs );
+
         /** 
          * @brief Destructor
          */
@@ -90,6 +97,22 @@ class controller : public saturator, public filter
         inline void getU( VectorXf& _u );
 
 
+        /** 
+         * @brief Append control signal, reference, saturation and filter state to snapshot
+         * 
+         * @param[in] _snapshot     Snapshot
+         */
+        virtual void save( snapshot& _snapshot ) const;
+
+
+        /** 
+         * @brief Restore control signal, reference, saturation and filter state from snapshot
+         * 
+         * @param[in] _snapshot     Snapshot
+         */
+        virtual void restore( snapshot& _snapshot );
+
+
 
     //
     // PUBLIC DATA MEMBERS
@@ -0,0 +1,107 @@
+/**
+ *	\file include/delayLine.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+class delayLine
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS:
+    //
+    public:
+        /**
+         * @brief Default constructor
+         */
+        delayLine( );
+
+        /**
+         * @brief Constructor which takes dimensions of delayed signal and length of history
+         *
+         * @param[in] _nu                   Number of signal channels
+         * @param[in] _initSignal           Initial signal, output until the delay has elapsed
+         * @param[in] _samplingTime         Sampling time
+         * @param[in] _capacity             Number of stored samples, limits maximum delay
+         */
+        delayLine( int _nu, VectorXf _initSignal, float _samplingTime, int _capacity );
+
+        /**
+         * @brief Copy constructor
+         *
+         * @param[in] rhs       Right-hand side object
+         */
+        delayLine( const delayLine& rhs ) = default;
+
+        /**
+         * @brief Copy assignment operator
+         *
+         * @param[in] rhs       Right-hand side object
+         */
+        delayLine& operator=( const delayLine& rhs ) = default;
+
+        /**
+         * @brief Destructor
+         */
+        ~delayLine(  );
+
+
+        /**
+         * @brief Assign delay as integer number of samples
+         *
+         * @param[in] _ticks        Delay [samples]
+         */
+        void setDelayTicks( int _ticks );
+
+        /**
+         * @brief Assign delay in seconds, fractions of a sample are linearly interpolated
+         *
+         * @param[in] _delay        Delay [s]
+         */
+        void setDelay( float _delay );
+
+
+        /**
+         * @brief Store signal and replace it by the delayed signal
+         *
+         * @param[in] _u        Signal to be delayed
+         */
+        void delay( VectorXf& _u );
+
+
+        /**
+         * @brief Append stored samples to snapshot
+         *
+         * @param[in] _snapshot     Snapshot
+         */
+        void save( snapshot& _snapshot ) const;
+
+        /**
+         * @brief Restore stored samples from snapshot, the capacity must match
+         *
+         * @param[in] _snapshot     Snapshot
+         */
+        void restore( snapshot& _snapshot );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        int nu = 0;                         // Number of signal channels
+        int capacity = 0;                   // Number of stored samples
+        float samplingTime = 0;             // Sampling time
+
+        int delayTicks = 0;                 // Integer part of delay [samples]
+        float delayFraction = 0;            // Fractional part of delay [-]
+
+        int head = 0;                       // Column of most recent sample
+
+        MatrixXf history;                   // Stored samples, one column per sample
+};
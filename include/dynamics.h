@@ -39,6 +39,13 @@ class dynamics
          */
         dynamics(  const dynamics& rhs  );
 
+        /** 
+         * @brief Copy assignment operator
+         * 
+         * @param[in] rhs       Right-hand side object
+         */
+        dynamics& operator=( const dynamics& rhs );
+
         /** 
          * @brief Destructor
          */
@@ -62,6 +69,55 @@ class dynamics
         inline float getdt( );
 
 
+        /** 
+         * @brief Assign vehicle mass
+         * 
+         * @param[in] _mass     Mass [kg]
+         */
+        void setMass( float _mass );
+
+
+        /** 
+         * @brief Assign principal moments of inertia
+         * 
+         * @param[in] _inertia  Moments of inertia around x-, y- and z-axis [kg m2]
+         */
+        void setInertia( const Vector3f& _inertia );
+
+
+        /** 
+         * @brief Assign propeller constants, equal for both propellers
+         * 
+         * @param[in] _forceConstant    Thrust per squared propeller velocity
+         * @param[in] _momentConstant   Torque per squared propeller velocity
+         */
+        void setPropellerConstants( float _forceConstant, float _momentConstant );
+
+
+        /** 
+         * @brief Assign offset of thrust line from cg
+         * 
+         * @param[in] _offset   Offset in x- and y-direction in body-frame [m]
+         */
+        void setThrustOffset( const Vector2f& _offset );
+
+
+        /** 
+         * @brief Append state, time and auxiliary outputs to snapshot
+         * 
+         * @param[in] _snapshot     Snapshot
+         */
+        void save( snapshot& _snapshot ) const;
+
+
+        /** 
+         * @brief Restore state, time and auxiliary outputs from snapshot
+         * 
+         * @param[in] _snapshot     Snapshot
+         */
+        void restore( snapshot& _snapshot );
+
+
 
     //
     // PUBLIC DATA MEMBERS
@@ -10,6 +10,21 @@
 #include <Eigen/Dense>              // #include module
 using namespace Eigen;              // using namespace of module
 
+typedef Matrix<float,12,Dynamic,RowMajor> stateBatch;              // States of multiple samples, one row per state
+typedef Ref<stateBatch,0,OuterStride<>> stateBatchRef;             // Column range of a state batch
+typedef Ref<const stateBatch,0,OuterStride<>> constStateBatchRef;
+
+
+/** Covariance update method of the extended Kalman filter
+ */
+enum updateMethod
+{
+    JOSEPH_UPDATE,                  // Batch update of all channels in Joseph form
+    SEQUENTIAL_UPDATE,              // Scalar Joseph-form updates, one channel at a time
+    UD_UPDATE                       // Scalar Bierman updates and Thornton time update of UD factors
+};
+
+
 class estimator
 {
     //
@@ -47,20 +62,104 @@ class estimator
 
 		/** Destructor. 
 		 */
-		~estimator( );
+		virtual ~estimator( );
 
 
         /**
          * @brief Initialize estimator
          * 
          */
-        void init( );
+        virtual void init( );
+
+        /**
+         * @brief Estimate state at current time step using IMU attitude and body rates
+         * 
+         * @param[in] _u        Control input
+         * @param[in] _y        System output vector
+         * @param[out] _x       State estimate
+         */
+        virtual void estimateState( VectorXf& _u, VectorXf& _y, VectorXf& _x );
+
+        /**
+         * @brief Estimate state at current time step using IMU attitude and body rates
+         *        and all queued measurements that have arrived. Delayed measurements are
+         *        fused at their arrival time.
+         * 
+         * @param[in] _u        Control input
+         * @param[in] _y        System output vector
+         * @param[in] _queue    Queue with asynchronous sensor measurements
+         * @param[out] _x       State estimate
+         */
+        void estimateState( VectorXf& _u, VectorXf& _y, measurementQueue& _queue, VectorXf& _x );
+
+        /**
+         * @brief Correct state estimate with a measurement (Joseph-form update)
+         * 
+         * @param[in] _measurement      Measurement
+         */
+        virtual void update( const measurement& _measurement );
+
+
+        /**
+         * @brief Assign process noise spectral density
+         * 
+         * @param[in] _processNoise     Diagonal of process noise matrix, one entry per state
+         */
+        void setProcessNoise( const VectorXf& _processNoise );
+
+        /**
+         * @brief Assign initial state uncertainty
+         * 
+         * @param[in] _initStd          Standard deviation of initial estimate, one entry per state
+         */
+        void setInitialCovariance( const VectorXf& _initStd );
+
+        /**
+         * @brief Assign measurement noise of a measurement type
+         * 
+         * @param[in] _type             Measurement type
+         * @param[in] _noiseStd         Standard deviation of measurement noise
+         */
+        void setMeasurementNoise( measurementType _type, const VectorXf& _noiseStd );
+
+        /**
+         * @brief Assign local earth magnetic field used by the magnetometer model
+         * 
+         * @param[in] _field            Magnetic field in earth-fixed reference frame (NED) [Gauss]
+         */
+        void setMagneticField( const Vector3f& _field );
+
+        /**
+         * @brief Assign covariance update method. Sequential and UD updates process the
+         *        uncorrelated measurement channels one at a time and need no matrix inversion.
+         * 
+         * @param[in] _method           Update method
+         */
+        virtual void setUpdateMethod( updateMethod _method );
+
+
+        /**
+         * @brief Normalized estimation error squared with respect to the true state
+         * 
+         * @param[in] _trueState        True system state
+         * 
+         * \return NEES, chi-squared distributed with 12 degrees of freedom for a consistent filter
+         */
+        virtual float NEES( const VectorXf& _trueState );
+
+        /**
+         * @brief Append state estimate, covariance and time to snapshot
+         * 
+         * @param[in] _snapshot         Snapshot
+         */
+        virtual void save( snapshot& _snapshot ) const;
 
         /**
-         * @brief Estimate state at current time step
+         * @brief Restore state estimate, covariance and time from snapshot
          * 
+         * @param[in] _snapshot         Snapshot
          */
-        void estimateState( VectorXf& _u, VectorXf& _y, VectorXf& _x );
+        virtual void restore( snapshot& _snapshot );
 
 
 
@@ -71,12 +170,14 @@ class estimator
         VectorXf stateEstimate;
         float time;
 
+        Matrix<float,12,12> stateCovariance;        // Covariance of state estimate
+
 
 
     //
-    // PRIVATE MEMBER FUNCTIONS:
+    // PROTECTED MEMBER FUNCTIONS:
     //
-    private:
+    protected:
         /** 
          * @brief Update system state using RK45
          * 
@@ -115,11 +216,95 @@ class estimator
         VectorXf calculateMoment(   float _t, VectorXf& _state, const VectorXf& _u    );
 
 
+        /** 
+         * @brief Calculate state derivatives of a batch of states. Each row holds one state
+         *        for all samples, so that the kernel is vectorized across samples.
+         * 
+         * @param[in] _X        States, one column per sample
+         * @param[in] _u        Control input, shared by all samples
+         * @param[out] _Xdot    State derivatives, one column per sample
+         */
+        void modelBatch( const constStateBatchRef& _X, const Vector3f& _u, stateBatchRef _Xdot );
+
+        /** 
+         * @brief Integrate a batch of states over one sampling interval using RK4
+         * 
+         * @param[in] _X        States, one column per sample, updated in place
+         * @param[in] _u        Control input, shared by all samples
+         */
+        void propagateBatch( stateBatchRef _X, const Vector3f& _u );
+
+        /** 
+         * @brief Analytic Jacobian of the state derivatives with respect to the state
+         * 
+         * @param[in] _x        State at which the Jacobian is evaluated
+         * @param[out] _F       Jacobian of model w.r.t. state
+         */
+        void modelJacobian( const Matrix<float,12,1>& _x, Matrix<float,12,12>& _F );
+
+
+        /** 
+         * @brief Assign default process noise, initial uncertainty and measurement noise
+         */
+        void setDefaultNoise( );
+
+
+        /** 
+         * @brief Propagate state covariance using the model Jacobian at the current estimate
+         */
+        void propagateCovariance( );
+
+
+        /** 
+         * @brief Predicted measurement for a given state
+         * 
+         * @param[in] _type     Measurement type
+         * @param[in] _x        State
+         * @param[out] _z       Predicted measurement
+         * 
+         * \return number of measurement channels
+         */
+        int measurementModel( measurementType _type, const Matrix<float,12,1>& _x, Matrix<float,6,1>& _z );
+
+
+        /** 
+         * @brief Scalar measurement update of state and covariance in Joseph form
+         * 
+         * @param[in] _h            Measurement Jacobian row
+         * @param[in] _innovation   Innovation of the measurement channel
+         * @param[in] _variance     Measurement noise variance
+         * @param[in] _x            State estimate, updated in place
+         */
+        void scalarUpdate( const Matrix<float,1,12>& _h, float _innovation, float _variance, Matrix<float,12,1>& _x );
+
+        /** 
+         * @brief Scalar measurement update of state and UD factors (Bierman)
+         * 
+         * @param[in] _h            Measurement Jacobian row
+         * @param[in] _innovation   Innovation of the measurement channel
+         * @param[in] _variance     Measurement noise variance
+         * @param[in] _x            State estimate, updated in place
+         */
+        void biermanUpdate( const Matrix<float,1,12>& _h, float _innovation, float _variance, Matrix<float,12,1>& _x );
+
+        /** 
+         * @brief Time update of UD factors by modified weighted Gram-Schmidt (Thornton)
+         * 
+         * @param[in] _Phi          State transition matrix
+         */
+        void thorntonUpdate( const Matrix<float,12,12>& _Phi );
+
+        /** 
+         * @brief Factorize state covariance as U*D*U^T with U unit upper triangular
+         */
+        void factorizeUD( );
+
+
 
     //
-	// PRIVATE DATA MEMBER:
+	// PROTECTED DATA MEMBER:
 	//
-    private:
+    protected:
         float samplingTime=0.01;
 
         // System properties
@@ -166,4 +351,16 @@ class estimator
         VectorXf k3=VectorXf::Zero(12);
         VectorXf k4=VectorXf::Zero(12);
         VectorXf stateDerivative=VectorXf::Zero(12);  
+
+        // Extended Kalman filter
+        Matrix<float,12,12> initCovariance;                         // Initial state covariance
+        Matrix<float,12,12> processNoise;                           // Process noise spectral density
+        Matrix<float,12,12> stateJacobian;                          // Jacobian of model w.r.t. state
+        Matrix<float,6,1> measurementNoise[N_MEASUREMENT_TYPES];    // Measurement noise standard deviations
+
+        Vector3f magField;                                          // Earth magnetic field (NED) [Gauss]
+
+        updateMethod covarianceUpdate = JOSEPH_UPDATE;              // Covariance update method
+        Matrix<float,12,12> covarianceU;                            // Unit upper triangular factor of state covariance
+        Matrix<float,12,1> covarianceD;                             // Diagonal factor of state covariance
 };
\ No newline at end of file
@@ -42,11 +42,30 @@ class filter
 		 */
 		filter( const filter& rhs );
 
+        /** Copy assignment operator
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		filter& operator=( const filter& rhs );
+
 		/** Destructor. 
 		 */
 		~filter( );
 
 
+        /** Append previous input and output samples to snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const;
+
+        /** Restore previous input and output samples from snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot );
+
+
 
     //
     // PRIVATE MEMBER FUNCTIONS
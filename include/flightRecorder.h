@@ -0,0 +1,126 @@
+/**
+ *	\file include/flightRecorder.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/** Trigger event captured by a flight recorder
+ */
+struct recorderEvent
+{
+    std::string trigger;            // Name of trigger that fired
+    unsigned long sample;           // Record at which the trigger fired
+    std::string fileName;           // Telemetry file holding the capture
+};
+
+
+class flightRecorder
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which takes the channels and capture windows. Full-rate data is
+         *  written to <_fileName>_event<k>.tlm around each trigger, the minimum, mean and
+         *  maximum of every channel over each summary interval to <_fileName>_summary.tlm.
+         *
+         * @param[in] _fileName         Name of telemetry files, without extension
+         * @param[in] _channels         Name and unit of each channel, names of at most 34 characters
+         * @param[in] _samplingTime     Time between records [s]
+         * @param[in] _preTime          Time kept in memory and captured before a trigger [s]
+         * @param[in] _postTime         Time captured after a trigger [s]
+         * @param[in] _summaryTime      Summary interval [s]
+         */
+        flightRecorder( std::string _fileName, const std::vector<telemetryChannel>& _channels, float _samplingTime, float _preTime, float _postTime, float _summaryTime );
+
+        /** Flight recorders own their telemetry files and cannot be copied
+         */
+        flightRecorder( const flightRecorder& rhs ) = delete;
+
+		/** Destructor, closes all files
+		 */
+		~flightRecorder( );
+
+
+        /** Add trigger which starts a capture when its condition becomes true. A
+         *  trigger firing during a capture extends it.
+         *
+         * @param[in] _name             Name of trigger
+         * @param[in] _condition        Condition evaluated for each record
+         */
+        void addTrigger( std::string _name, std::function<bool(const VectorXf&)> _condition );
+
+        /** Store record in the ring buffer, evaluate the triggers and write captures
+         *  and summaries. Performs I/O, during a simulation records are passed on by the
+         *  writer thread of a telemetryStream (see telemetryStream::setRecorder).
+         *
+         * @param[in] _record           Value of each channel
+         */
+        void record( const Ref<const VectorXf>& _record );
+
+        /** Write last summary interval and close all files
+         */
+        void close( );
+
+        /** Returns trigger events captured so far
+         */
+        const std::vector<recorderEvent>& events( ) const;
+
+        /** Returns name and unit of each channel of a record
+         */
+        const std::vector<telemetryChannel>& channelList( ) const;
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Open capture file and write the ring buffer to it
+         *
+         * @param[in] _trigger          Name of trigger that fired
+         */
+        void startCapture( const std::string& _trigger );
+
+        /** Write minimum, mean and maximum of the current summary interval
+         */
+        void writeSummary( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::string fileName;                           // Name of telemetry files, without extension
+        std::vector<telemetryChannel> channels;         // Name and unit of each channel
+
+        int nChannels;                                  // Number of channels
+        int preSamples;                                 // Records kept in ring buffer
+        int postSamples;                                // Records captured after a trigger
+        int summarySamples;                             // Records per summary interval
+
+        MatrixXf history;                               // Ring buffer, one column per record
+        VectorXf lastRecord;                            // Most recent record, passed to the triggers
+        unsigned long nRecords = 0;                     // Number of records
+
+        std::vector<std::pair<std::string, std::function<bool(const VectorXf&)>>> triggers;
+        std::vector<bool> triggerActive;                // Condition of each trigger at the last record
+        std::vector<recorderEvent> eventLog;            // Captured events
+
+        std::unique_ptr<telemetryWriter> capture;       // Current capture, if any
+        int remaining = 0;                              // Records left in current capture
+
+        std::unique_ptr<telemetryWriter> summary;       // Summary file
+        VectorXf summaryMin, summaryMax, summarySum;    // Statistics of current summary interval
+        int summaryFill = 0;                            // Records in current summary interval
+        VectorXf summaryRecord;                         // Summary record, minimum, mean and maximum
+};
@@ -11,7 +11,18 @@
 using namespace Eigen;            // using namespace
 
 
-/** Load grid data from csv file
+/** Load grid data from csv or binary matrix file. The file is memory-mapped and its
+ *  dimensions are detected from the data. Binary files are recognized by their header.
+ * 
+ * @param[in] FileName      File name from which to load in the data
+ * 
+ * \returns Matrix with data from file
+ * 
+ */
+MatrixXf loadFromFile(std::string FileName);
+
+
+/** Load grid data from csv or binary matrix file
  * 
  * @param[in] FileName      File name from which to load in the data
  * @param[in] row           Number of rows to read
@@ -23,6 +34,16 @@ using namespace Eigen;            // using namespace
 MatrixXf loadFromFile(std::string FileName, int row, int col);
 
 
+/** Load grid data from binary matrix file
+ * 
+ * @param[in] FileName      File name from which to load in the data
+ * 
+ * \returns Matrix with data from file
+ * 
+ */
+MatrixXf loadFromBinary(std::string FileName);
+
+
 
 /** Upload grid data to csv file
  * 
@@ -35,11 +56,15 @@ MatrixXf loadFromFile(std::string FileName, int row, int col);
 void saveToFile(MatrixXf &data, int rows, int cols, std::string FileName);
 
 
-/** Convert from euler angles to quaternion attitude representation
+/** Upload grid data to binary matrix file. The file holds a 16 byte header (magic "TVCM",
+ *  version, rows and columns as 32-bit unsigned integers) followed by the data as 32-bit
+ *  floats in column-major order, all little-endian.
+ * 
+ * @param[in] data          Data to be uploaded
+ * @param[in] FileName      File name to which data should be uploaded
  * 
- * @param[in] EulerAnlges   Vector containing the euler angles: roll, pitch, yaw
  */
-VectorXf toQuaternion( VectorXf& EulerAngles );
+void saveToBinary(const MatrixXf &data, std::string FileName);
 
 
 /** Convert vector from body-fixed reference frame to earth-fixed reference frame
@@ -49,4 +74,4 @@ VectorXf toQuaternion( VectorXf& EulerAngles );
  * 
  * \return transformed vector in earth-fixed reference frame (NED)
  */
-VectorXf BFRtoNED( VectorXf& EulerAngles, VectorXf& Vector );
+VectorXf BFRtoNED( const VectorXf& EulerAngles, const VectorXf& Vector );
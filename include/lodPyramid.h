@@ -0,0 +1,105 @@
+/**
+ *	\file include/lodPyramid.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/*  Level k of the pyramid of telemetry file <name>.tlm is stored in <name>.lod<k>.tlm. Its
+ *  sample i holds the minimum (first half of the channels) and maximum (second half) of each
+ *  channel over raw samples [i*factor^k, (i+1)*factor^k), the bucket size factor^k is stored
+ *  in its header. A level is created once its first bucket is complete, the last bucket of
+ *  each level may be partial.
+ */
+
+
+class lodPyramid
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which takes the telemetry file and channels of the raw data
+         *
+         * @param[in] _fileName         Name of raw telemetry file
+         * @param[in] _channels         Name and unit of each channel, names of at most 35 characters
+         * @param[in] _factor           Number of buckets combined per level
+         * @param[in] _maxLevels        Maximum number of levels
+         */
+        lodPyramid( std::string _fileName, const std::vector<telemetryChannel>& _channels, int _factor = 4, int _maxLevels = 12 );
+
+        /** Pyramids own their telemetry files and cannot be copied
+         */
+        lodPyramid( const lodPyramid& rhs ) = delete;
+
+		/** Destructor, closes all levels
+		 */
+		~lodPyramid( );
+
+
+        /** Add raw sample to the lowest level
+         *
+         * @param[in] _sample           Value of each channel
+         */
+        void add( const Ref<const VectorXf>& _sample );
+
+        /** Write partial buckets and close all levels
+         */
+        void close( );
+
+        /** Returns number of levels written so far
+         */
+        int levels( ) const;
+
+        /** Returns name of telemetry file of a level
+         *
+         * @param[in] _fileName         Name of raw telemetry file
+         * @param[in] _level            Level, starting at 1
+         */
+        static std::string levelFileName( const std::string& _fileName, int _level );
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Combine minimum and maximum into the bucket of a level
+         *
+         * @param[in] _level            Level of bucket, 0 for the raw data
+         * @param[in] _min              Minimum of each channel
+         * @param[in] _max              Maximum of each channel
+         */
+        void addToLevel( int _level, const Ref<const VectorXf>& _min, const Ref<const VectorXf>& _max );
+
+        /** Write bucket of a level to the next level and pass it on
+         *
+         * @param[in] _level            Level of bucket, 0 for the raw data
+         */
+        void emit( int _level );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::string fileName;                           // Name of raw telemetry file
+        std::vector<telemetryChannel> levelChannels;    // Minimum and maximum of each channel
+
+        int nChannels;                                  // Number of raw channels
+        int factor;                                     // Number of buckets combined per level
+        int maxLevels;                                  // Maximum number of levels
+
+        std::vector<std::unique_ptr<telemetryWriter>> writers;  // Telemetry file of each level
+        MatrixXf bucketMin, bucketMax;                  // Current bucket of each level, one column per level
+        std::vector<int> bucketFill;                    // Number of entries in current bucket of each level
+        VectorXf levelRecord;                           // Record written to a level
+};
@@ -0,0 +1,55 @@
+/**
+ *	\file include/mappedFile.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+class mappedFile
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which maps a file read-only into memory. Where memory mapping
+         *  is not available, the file is read into a buffer instead.
+         *
+         * @param[in] _fileName         Name of file to be mapped
+         */
+        mappedFile( const std::string& _fileName );
+
+        /** Mapped files own their mapping and cannot be copied
+         */
+        mappedFile( const mappedFile& rhs ) = delete;
+
+		/** Destructor, unmaps the file
+		 */
+		~mappedFile( );
+
+
+        /** Returns pointer to first byte of the file
+         */
+        const char* data( ) const;
+
+        /** Returns size of the file in bytes
+         */
+        size_t size( ) const;
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        const char* begin = nullptr;        // First byte of mapped file
+        size_t length = 0;                  // Size of mapped file [bytes]
+
+        std::vector<char> buffer;           // File contents when memory mapping is not available
+};
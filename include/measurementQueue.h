@@ -0,0 +1,126 @@
+/**
+ *	\file include/measurementQueue.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/** Type of measurement stored in a measurement queue
+ */
+enum measurementType
+{
+    GPS_MEASUREMENT,                // NED position and velocity [m, m/s]
+    BARO_MEASUREMENT,               // Altitude above initial ground level [m]
+    MAG_MEASUREMENT,                // Magnetic field in body-fixed reference frame [Gauss]
+    IMU_MEASUREMENT,                // Euler angles and body rates [rad, rad/s]
+    POSITION_MEASUREMENT,           // NED position [m]
+
+    N_MEASUREMENT_TYPES             // Number of measurement types
+};
+
+
+/** Timestamped measurement as published by a sensor
+ */
+struct measurement
+{
+    float sampleTime;               // Time at which the measurement was taken [s]
+    float arrivalTime;              // Time at which the measurement becomes available [s]
+
+    measurementType type;           // Type of measurement
+    int size;                       // Number of valid entries in value
+
+    Matrix<float,6,1> value;        // Measured values
+};
+
+
+class measurementQueue
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Default constructor
+         */
+        measurementQueue( );
+
+        /** Constructor which takes the maximum number of pending measurements
+         *
+         * @param[in] _capacity             Maximum number of pending measurements
+         */
+        measurementQueue( unsigned int _capacity );
+
+        /** Copy constructor
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		measurementQueue( const measurementQueue& rhs );
+
+        /** Copy assignment operator
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		measurementQueue& operator=( const measurementQueue& rhs );
+
+		/** Destructor.
+		 */
+		~measurementQueue( );
+
+
+        /** Add measurement to the queue, ordered by arrival time. The oldest
+         *  pending measurement is dropped when the queue is full.
+         *
+         * @param[in] _measurement      Measurement to be added
+         *
+         * \return false if a pending measurement had to be dropped
+         */
+        bool push( const measurement& _measurement );
+
+        /** Remove the oldest measurement that has arrived at the given time
+         *
+         * @param[in] _time             Current time
+         * @param[out] _measurement     Measurement removed from the queue
+         *
+         * \return true if a measurement was available
+         */
+        bool pop( float _time, measurement& _measurement );
+
+        /** Remove all pending measurements
+         */
+        void clear( );
+
+        /** Returns number of pending measurements
+         */
+        unsigned int size( ) const;
+
+
+        /** Append pending measurements to snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const;
+
+        /** Replace pending measurements by those of a snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::vector<measurement> buffer;    // Ring buffer with pending measurements
+
+        unsigned int capacity;              // Maximum number of pending measurements
+        unsigned int head;                  // Index of oldest pending measurement
+        unsigned int count;                 // Number of pending measurements
+};
@@ -0,0 +1,109 @@
+/**
+ *	\file include/minSnapTrajectory.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+class minSnapTrajectory : public reference
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Default constructor
+         */
+        minSnapTrajectory( );
+
+        /** Constructor which builds the minimum-snap trajectory through waypoints. Each
+         *  segment is a 7th-order polynomial, the segments join with continuous derivatives
+         *  up to the 6th and the trajectory starts and ends at rest.
+         *
+         * @param[in] _waypoints        Waypoints, one column per waypoint [m]
+         * @param[in] _segmentTimes     Duration of each segment [s]
+         * @param[in] _startTime        Time of first waypoint [s]
+         */
+        minSnapTrajectory( const MatrixXf& _waypoints, const VectorXf& _segmentTimes, float _startTime = 0.0 );
+
+        /** Constructor which allocates the segment times from a trapezoidal velocity profile
+         *  over the length of each segment
+         *
+         * @param[in] _waypoints        Waypoints, one column per waypoint [m]
+         * @param[in] _maxVelocity      Cruise velocity of the profile [m/s]
+         * @param[in] _maxAcceleration  Acceleration of the profile [m/s2]
+         * @param[in] _startTime        Time of first waypoint [s]
+         */
+        minSnapTrajectory( const MatrixXf& _waypoints, float _maxVelocity, float _maxAcceleration, float _startTime = 0.0 );
+
+        /** Copy constructor
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		minSnapTrajectory( const minSnapTrajectory& rhs );
+
+		/** Destructor.
+		 */
+		~minSnapTrajectory( );
+
+
+        /** Evaluate the trajectory. Before the start and after the end the first and last
+         *  waypoint are held. Consecutive evaluations at increasing times find their segment
+         *  in constant time.
+         *
+         * @param[in] _time             Time [s]
+         *
+         * \return position, velocity, acceleration and jerk, one column each
+         */
+        Matrix<float,3,4> evaluate( float _time );
+
+        /** Evaluate position, velocity and acceleration of the trajectory
+         *
+         * @param[in] _time             Time [s]
+         * @param[out] _position        Position [m]
+         * @param[out] _velocity        Velocity [m/s]
+         * @param[out] _acceleration    Acceleration [m/s2]
+         */
+        void evaluate( float _time, VectorXf& _position, VectorXf& _velocity, VectorXf& _acceleration ) override;
+
+        /** Returns time of first waypoint
+         */
+        float startTime( ) const;
+
+        /** Returns time of last waypoint
+         */
+        float endTime( ) const;
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Solve for the polynomial coefficients of all segments
+         *
+         * @param[in] _waypoints        Waypoints, one column per waypoint
+         * @param[in] _segmentTimes     Duration of each segment
+         * @param[in] _startTime        Time of first waypoint
+         */
+        void solve( const MatrixXf& _waypoints, const VectorXf& _segmentTimes, float _startTime );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        int nSegments = 0;                  // Number of segments
+
+        VectorXd knots;                     // Start time of each segment and end time
+        MatrixXd coefficients;              // 8 coefficients per segment and axis in normalized time, one row per axis
+
+        int cursor = 0;                     // Segment of last evaluation
+};
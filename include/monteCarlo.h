@@ -0,0 +1,101 @@
+/**
+ *	\file include/monteCarlo.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/*  Monte Carlo analysis of a scenario: each run disperses the parameters listed in the
+ *  dispersions of the nominal scenario and draws its own sensor noise. Runs are scheduled
+ *  with work stealing, since diverging runs end early. The dispersion of a run only
+ *  depends on the seed and the run number, so results do not depend on the number of
+ *  threads.
+ */
+class monteCarlo
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor
+         *
+         * @param[in] _nominal          Nominal scenario with dispersions
+         * @param[in] _seed             Seed of the analysis
+         */
+        monteCarlo( const scenario& _nominal, unsigned long _seed = 1 );
+
+
+        /** Returns dispersed scenario of a run
+         *
+         * @param[in] _run              Run number
+         */
+        scenario sample( unsigned long _run ) const;
+
+        /** Fly the nominal scenario once up to a time and start every run from its snapshot
+         *  at that time, instead of from the initial state. The dispersed parameters of a run
+         *  apply from the fork time on. Scenarios with dispersions of the initial state cannot
+         *  be forked.
+         *
+         * @param[in] _forkTime         Fork time [s], no fork at or before the initial time
+         */
+        void setForkTime( float _forkTime );
+
+        /** Returns snapshot of the nominal scenario at the fork time, from which every run
+         *  starts, or an empty snapshot if the runs are not forked
+         */
+        snapshot prefix( ) const;
+
+        /** Simulate runs in parallel. With a catalog, each run is added to the catalog and
+         *  writes its telemetry to its run directory if the nominal scenario has telemetry.
+         *  With a cache, runs simulated before are restored from the cache, unless the
+         *  runs are forked. Runs that dropped telemetry records are neither cached nor
+         *  cataloged, see incomplete. With a reporter, the progress of the runs is reported while they
+         *  are simulated.
+         *
+         * @param[in] _runs             Number of runs
+         * @param[in] _nThreads         Number of threads
+         * @param[in] _catalog          Catalog with the fields of this analysis, may be null
+         * @param[in] _cache            Cache of simulation results, may be null
+         * @param[in] _progress         Progress reporter, may be null
+         *
+         * \return throughput [simulations/s]
+         */
+        double run( unsigned long _runs, unsigned int _nThreads, runCatalog* _catalog = nullptr, resultCache* _cache = nullptr,
+                    progressReporter* _progress = nullptr );
+
+        /** Returns name of each catalog field: run number, dispersed parameter elements,
+         *  number of steps and summary metrics of the simulation
+         */
+        const std::vector<std::string>& fields( ) const;
+
+        /** Returns catalog values of each run of the last call to run
+         */
+        const std::vector<VectorXf>& results( ) const;
+
+        /** Returns number of runs of the last call to run that dropped telemetry records and
+         *  were therefore not cached or cataloged
+         */
+        unsigned long incomplete( ) const;
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        scenario nominal;                       // Nominal scenario
+        unsigned long seed;                     // Seed of the analysis
+        float forkTime = -INFINITY;             // Time from which the runs fork off the nominal scenario [s]
+
+        std::vector<std::pair<std::string,int>> dispersed;     // Key and element of each dispersed parameter element
+        std::vector<std::string> fieldNames;                    // Name of each catalog field
+        std::vector<VectorXf> values;                           // Catalog values of each run
+        unsigned long nIncomplete = 0;                          // Number of runs with dropped telemetry
+};
@@ -0,0 +1,110 @@
+/**
+ *	\file include/progressReporter.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+enum reportFormat
+{
+    TEXT_REPORT,                    // Line of text, rewritten in place on a terminal
+    JSON_REPORT                     // One JSON object per line
+};
+
+
+/*  Progress of one run, updated by the simulation thread with relaxed atomic stores and read
+ *  by the reporter thread, so that the simulation never waits on the reporter.
+ */
+struct progressCounter
+{
+    std::atomic<int> steps{ 0 };            // Steps taken
+    std::atomic<int> totalSteps{ 0 };       // Steps to the final time, 0 if the run has not started
+    std::atomic<bool> finished{ false };    // Set when the run has ended
+};
+
+
+/*  Progress of a batch of runs, reported to standard error by one thread at a fixed wall-clock
+ *  rate: finished runs, steps, throughput and estimated time to completion of all runs. The
+ *  runs only update their counters, so the report rate does not depend on the number of runs
+ *  or steps, and no run writes to the console.
+ */
+class progressReporter
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor
+         *
+         * @param[in] _format           Format of the reports
+         * @param[in] _interval         Time between reports [s]
+         */
+        progressReporter( reportFormat _format = TEXT_REPORT, double _interval = 1.0 );
+
+        /** Reporters own a reporter thread and cannot be copied
+         */
+        progressReporter( const progressReporter& rhs ) = delete;
+
+		/** Destructor, stops the reporter thread
+		 */
+		~progressReporter( );
+
+
+        /** Reset the counters of a batch of runs and start reporting
+         *
+         * @param[in] _runs             Number of runs
+         */
+        void start( unsigned long _runs );
+
+        /** Returns counter of a run, valid until the next start
+         *
+         * @param[in] _run              Run number in [0,runs)
+         */
+        progressCounter& counter( unsigned long _run );
+
+        /** Write the final report and stop reporting
+         */
+        void stop( );
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Reporter thread
+         */
+        void reporter( );
+
+        /** Sample the counters and write a report
+         *
+         * @param[in] _final            Report after the last run has ended
+         */
+        void report( bool _final );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        reportFormat format;                                // Format of the reports
+        double interval;                                    // Time between reports [s]
+        bool terminal;                                      // Standard error is a terminal
+
+        std::unique_ptr<progressCounter[]> counters;        // Counter of each run
+        unsigned long nRuns = 0;                            // Number of runs
+        std::chrono::steady_clock::time_point startTime;    // Time of start
+
+        std::thread thread;                                 // Reporter thread
+        std::mutex mutex;                                   // Guards running
+        std::condition_variable wake;                       // Wakes the reporter thread when stopped
+        bool running = false;                               // Reporting
+};
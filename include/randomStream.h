@@ -0,0 +1,132 @@
+/**
+ *	\file include/randomStream.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+enum randomComponent
+{
+    DISPERSION_STREAM,              // Dispersion of scenario parameters
+    IMU_STREAM,                     // Inertial measurement unit
+    GPS_STREAM,                     // Satellite navigation receiver
+    BARO_STREAM,                    // Barometric altimeter
+    MAG_STREAM,                     // Magnetometer
+    ACCEL_STREAM,                   // Accelerometer of the inertial measurement unit
+    PARTICLE_STREAM                 // Particle filter, one stream per particle block from here on
+};
+
+
+/*  Counter-based random stream (Philox4x32-10). Every number is a function of the global
+ *  seed, run number, component, tick and position within the tick only, so a stream can be
+ *  positioned at any tick without drawing the preceding numbers. Results therefore do not
+ *  depend on the number of threads or the order in which components draw, and a single run
+ *  can be repeated in isolation.
+ */
+class randomStream
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Default constructor, seed 1 of run 0 and component 0
+         */
+        randomStream( );
+
+        /** Constructor which takes the key of the stream
+         *
+         * @param[in] _seed             Global seed
+         * @param[in] _run              Run number
+         * @param[in] _component        Component drawing from the stream, see randomComponent
+         */
+        randomStream( uint64_t _seed, uint64_t _run, uint32_t _component );
+
+
+        /** Position stream at the first number of a tick
+         *
+         * @param[in] _tick             Tick, e.g. sample or step number
+         */
+        void seek( uint64_t _tick );
+
+        /** Returns uniformly distributed number in [0,1)
+         */
+        float uniform( );
+
+        /** Returns standard normally distributed number
+         */
+        float normal( );
+
+        /** Fill with uniformly distributed numbers
+         *
+         * @param[out] _values          Values to be filled
+         * @param[in] _low              Lower bound
+         * @param[in] _high             Upper bound, excluded
+         */
+        void uniform( Ref<VectorXf> _values, float _low = 0.0, float _high = 1.0 );
+
+        /** Fill with normally distributed numbers, using the Box-Muller transform
+         *
+         * @param[out] _values          Values to be filled
+         * @param[in] _mean             Mean
+         * @param[in] _std              Standard deviation
+         */
+        void normal( Ref<VectorXf> _values, float _mean = 0.0, float _std = 1.0 );
+
+        /** Fill with normally distributed numbers truncated to an interval, using the inverse
+         *  distribution function so that each value takes exactly one number of the stream
+         *
+         * @param[out] _values          Values to be filled
+         * @param[in] _mean             Mean of the normal distribution
+         * @param[in] _std              Standard deviation of the normal distribution
+         * @param[in] _low              Lower bound
+         * @param[in] _high             Upper bound
+         */
+        void truncatedNormal( Ref<VectorXf> _values, float _mean, float _std, float _low, float _high );
+
+
+        /** Append position in the stream to snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const;
+
+        /** Restore position in the stream from snapshot, the key of the stream is kept
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot );
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Next raw 32-bit numbers of the stream
+         *
+         * @param[out] _values          Numbers
+         * @param[in] _n                Count
+         */
+        void next( uint32_t* _values, int _n );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        uint32_t key[2];                // Key derived from seed and run number
+        uint32_t component;             // Component drawing from the stream
+        uint64_t tick = 0;              // Current tick
+        uint32_t block = 0;             // Next block of four numbers within the tick
+
+        uint32_t buffer[4];             // Last block of four numbers
+        int buffered = 0;               // Numbers of the last block not yet used
+};
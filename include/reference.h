@@ -0,0 +1,57 @@
+/**
+ *	\file include/reference.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/** Interpolation between the samples of a reference signal
+ */
+enum interpolationMethod
+{
+    ZERO_ORDER_HOLD,                // Last sample is held until the next one
+    LINEAR_INTERPOLATION,           // Straight line between samples
+    HERMITE_INTERPOLATION           // Cubic Hermite spline with finite difference slopes
+};
+
+
+class reference
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Default constructor
+         */
+        reference( );
+
+        /** Destructor
+         */
+        virtual ~reference( );
+
+
+        /** Evaluate the reference signal and its first two time derivatives. The signal
+         *  has its own time base, independent of the simulation sampling time.
+         *
+         * @param[in] _time             Time [s]
+         * @param[out] _value           Value of each channel
+         * @param[out] _rate            First time derivative of each channel
+         * @param[out] _acceleration    Second time derivative of each channel
+         */
+        virtual void evaluate( float _time, VectorXf& _value, VectorXf& _rate, VectorXf& _acceleration ) = 0;
+
+        /** Evaluate the reference signal
+         *
+         * @param[in] _time             Time [s]
+         *
+         * \return value of each channel
+         */
+        VectorXf value( float _time );
+};
@@ -0,0 +1,103 @@
+/**
+ *	\file include/resultCache.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/*  Content-addressed cache of simulation results on disk. A result is keyed by the hash of
+ *  the canonical description of its scenario and the version of the simulator, and holds
+ *  the number of steps, the summary metrics and the telemetry files of the simulation.
+ *  Scenarios that were simulated before are restored instead of simulated again. When the
+ *  cache exceeds its size, the least recently used results are evicted.
+ *
+ *      <directory>/<key>/result.bin    steps and summary metrics
+ *      <directory>/<key>/<name>.tlm    telemetry files, if the scenario has telemetry
+ */
+class resultCache
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which opens the cache in a directory, or creates it
+         *
+         * @param[in] _directory        Cache directory
+         * @param[in] _maxSize          Maximum size of the cache on disk [bytes]
+         */
+        resultCache( std::string _directory, uintmax_t _maxSize = 1ull << 30 );
+
+        /** Caches hold their size bookkeeping and cannot be copied
+         */
+        resultCache( const resultCache& rhs ) = delete;
+
+
+        /** Restore result of a scenario: copy its telemetry files to the output directory of
+         *  the scenario. Thread-safe.
+         *
+         * @param[in] _scenario         Scenario
+         * @param[out] _metrics         Summary metrics of the simulation
+         * @param[out] _steps           Number of steps of the simulation
+         *
+         * \return true if the scenario was found in the cache
+         */
+        bool lookup( const scenario& _scenario, VectorXf& _metrics, int& _steps );
+
+        /** Store result of a scenario with the telemetry files in its output directory, and
+         *  evict results if the cache has grown beyond its size. Thread-safe, also between
+         *  processes sharing the cache.
+         *
+         * @param[in] _scenario         Simulated scenario
+         * @param[in] _metrics          Summary metrics of the simulation
+         * @param[in] _steps            Number of steps of the simulation
+         */
+        void store( const scenario& _scenario, const Ref<const VectorXf>& _metrics, int _steps );
+
+        /** Remove least recently used results until the cache is within its size
+         */
+        void evict( );
+
+        /** Returns number of results found by lookup
+         */
+        unsigned long hits( ) const;
+
+        /** Returns number of results not found by lookup
+         */
+        unsigned long misses( ) const;
+
+        /** Returns size of the cache on disk [bytes]
+         */
+        uintmax_t size( ) const;
+
+        /** Returns key of a scenario: hash of its canonical description and the simulator
+         *  version, see canonicalScenario
+         *
+         * @param[in] _scenario         Scenario
+         */
+        static uint64_t key( const scenario& _scenario );
+
+        /** Returns version of the simulator code the cache was built with
+         */
+        static const char* version( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::string directory;                  // Cache directory
+        uintmax_t maxSize;                      // Maximum size of the cache [bytes]
+
+        std::atomic<uintmax_t> totalSize{ 0 };  // Size of the cache [bytes]
+        std::atomic<unsigned long> nHits{ 0 };  // Number of results found
+        std::atomic<unsigned long> nMisses{ 0 };// Number of results not found
+        std::mutex lock;                        // Serializes eviction between threads
+};
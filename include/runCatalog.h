@@ -0,0 +1,126 @@
+/**
+ *	\file include/runCatalog.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/** Entry of a run catalog
+ */
+struct runRecord
+{
+    unsigned long id;               // Run number
+    uint64_t seed;                  // Random seed of the run
+    uint64_t scenarioHash;          // Hash of the scenario description
+    VectorXf values;                // Value of each catalog field (parameters and summary metrics)
+    std::string directory;          // Directory holding the outputs of the run
+};
+
+
+class runCatalog
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which opens the catalog in a directory, or creates it with the
+         *  given fields. Each run writes its outputs to its own subdirectory, the
+         *  index file catalog.idx holds one fixed-size record per run.
+         *
+         * @param[in] _directory        Catalog directory
+         * @param[in] _fields           Name of each parameter and summary metric stored per run,
+         *                              names of at most 31 characters. May be empty to open an
+         *                              existing catalog, otherwise it must match the catalog.
+         */
+        runCatalog( std::string _directory, const std::vector<std::string>& _fields = {} );
+
+        /** Catalogs own their index file and cannot be copied
+         */
+        runCatalog( const runCatalog& rhs ) = delete;
+
+		/** Destructor
+		 */
+		~runCatalog( );
+
+
+        /** Reserve run number and create the output directory of the run. Thread-safe.
+         *
+         * \return run number
+         */
+        unsigned long beginRun( );
+
+        /** Returns output directory of a run
+         *
+         * @param[in] _id               Run number
+         */
+        std::string runDirectory( unsigned long _id ) const;
+
+        /** Append run to the index. Thread-safe, and several processes may add runs
+         *  to a catalog at the same time: the index is locked while the run is appended.
+         *
+         * @param[in] _id               Run number returned by beginRun
+         * @param[in] _seed             Random seed of the run
+         * @param[in] _scenarioHash     Hash of the scenario description, see hash
+         * @param[in] _values           Value of each catalog field
+         */
+        void addRun( unsigned long _id, uint64_t _seed, uint64_t _scenarioHash, const Ref<const VectorXf>& _values );
+
+        /** Select runs from the memory-mapped index without opening their data files.
+         *  Conditions have the form "<field> <op> <value>" with op one of <, <=, >, >=,
+         *  == and !=, joined by "and", e.g. "mass > 1.9 and maxTilt > 20". Besides the
+         *  catalog fields, "id" may be used as field.
+         *
+         * @param[in] _condition        Conditions on the runs, empty to select all runs
+         * @param[in] _orderBy          Field to sort by, empty to keep the order of the index
+         * @param[in] _descending       Sort in descending order
+         * @param[in] _limit            Maximum number of runs returned, 0 for no limit
+         *
+         * \return selected runs
+         */
+        std::vector<runRecord> query( const std::string& _condition = "", const std::string& _orderBy = "", bool _descending = false, size_t _limit = 0 ) const;
+
+        /** Returns number of runs in the index
+         */
+        unsigned long runs( ) const;
+
+        /** Returns name of each catalog field
+         */
+        const std::vector<std::string>& fields( ) const;
+
+        /** Returns index of a catalog field
+         *
+         * @param[in] _name             Name of field
+         */
+        int fieldIndex( const std::string& _name ) const;
+
+        /** 64-bit FNV-1a hash, e.g. of the scenario description of a run
+         *
+         * @param[in] _text             Text to be hashed
+         */
+        static uint64_t hash( const std::string& _text );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::string directory;                  // Catalog directory
+        std::vector<std::string> fieldNames;    // Name of each catalog field
+
+        int recordSize;                         // Size of index record [bytes]
+        int dataOffset;                         // Offset of first index record [bytes]
+        unsigned long nRuns = 0;                // Number of runs in the index
+
+        std::fstream Index;                     // Index file, opened for appending runs
+        int lockFile = -1;                      // Descriptor of the index file, locked between processes
+        mutable std::mutex lock;                // Serializes index access between threads
+        std::atomic<unsigned long> nextId{ 0 }; // Next run number
+};
@@ -0,0 +1,58 @@
+/**
+ *	\file include/runDiff.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/** Difference between one channel of two runs
+ */
+struct channelDifference
+{
+    std::string name;                   // Channel name
+    long firstDivergence = -1;          // First sample outside the tolerance, -1 if none
+    float maxError = 0;                 // Maximum absolute error
+    unsigned long maxErrorSample = 0;   // Sample of maximum absolute error
+    float rms = 0;                      // Root mean square of the error
+    unsigned long violations = 0;       // Number of samples outside the tolerance
+};
+
+
+/** Difference between two runs
+ */
+struct runDifference
+{
+    unsigned long samplesA = 0;         // Number of samples of first run
+    unsigned long samplesB = 0;         // Number of samples of second run
+    unsigned long compared = 0;         // Number of samples compared, the common length
+
+    long firstDivergence = -1;          // First sample at which any channel is outside the tolerance, -1 if none
+    int firstChannel = -1;              // Channel diverging first
+
+    std::vector<channelDifference> channels;    // Difference of each channel
+};
+
+
+/**
+ * @brief Compare two runs channel by channel. Runs are given as telemetry files, CSV
+ *        files or binary matrix files (see loadFromFile) with one row per channel and one
+ *        column per sample. Both files are mapped once and compared in blocks of samples
+ *        across all channels: telemetry chunks are decompressed once per block, binary
+ *        matrices are used in place and CSV rows are parsed as the blocks advance. A sample is outside the tolerance if
+ *        |a - b| > _absTol + _relTol*max(|a|, |b|), a NaN in only one run always is.
+ *
+ * @param[in] _fileA            First run
+ * @param[in] _fileB            Second run
+ * @param[in] _absTol           Absolute tolerance
+ * @param[in] _relTol           Relative tolerance
+ * @param[in] _blockSamples     Number of samples compared at a time
+ *
+ * \return difference of the common samples of both runs
+ */
+runDifference compareRuns( std::string _fileA, std::string _fileB, float _absTol, float _relTol, unsigned long _blockSamples = 65536 );
@@ -0,0 +1,92 @@
+/**
+ *	\file include/sampledReference.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+class sampledReference : public reference
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Default constructor
+         */
+        sampledReference( );
+
+        /** Constructor which takes samples at a constant sampling time
+         *
+         * @param[in] _samples          Samples, one row per channel and one column per sample
+         * @param[in] _samplingTime     Time between samples [s]
+         * @param[in] _startTime        Time of first sample [s]
+         * @param[in] _method           Interpolation between samples
+         */
+        sampledReference( const MatrixXf& _samples, float _samplingTime, float _startTime = 0.0, interpolationMethod _method = LINEAR_INTERPOLATION );
+
+        /** Constructor which takes samples at given times
+         *
+         * @param[in] _times            Time of each sample, strictly increasing [s]
+         * @param[in] _samples          Samples, one row per channel and one column per sample
+         * @param[in] _method           Interpolation between samples
+         */
+        sampledReference( const VectorXf& _times, const MatrixXf& _samples, interpolationMethod _method = LINEAR_INTERPOLATION );
+
+        /** Copy constructor
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		sampledReference( const sampledReference& rhs );
+
+		/** Destructor.
+		 */
+		~sampledReference( );
+
+
+        /** Interpolate the samples. Before the first and after the last sample these are
+         *  held with zero derivatives. Consecutive evaluations at increasing times find
+         *  their interval in constant time.
+         *
+         * @param[in] _time             Time [s]
+         * @param[out] _value           Value of each channel
+         * @param[out] _rate            First time derivative of each channel
+         * @param[out] _acceleration    Second time derivative of each channel
+         */
+        void evaluate( float _time, VectorXf& _value, VectorXf& _rate, VectorXf& _acceleration ) override;
+
+        /** Assign interpolation method
+         *
+         * @param[in] _method           Interpolation between samples
+         */
+        void setInterpolation( interpolationMethod _method );
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Check samples and compute Hermite slopes
+         */
+        void init( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        VectorXf times;                     // Time of each sample
+        MatrixXf samples;                   // Samples, one column per sample
+        MatrixXf slopes;                    // Time derivative at each sample for Hermite interpolation
+
+        interpolationMethod method = LINEAR_INTERPOLATION;     // Interpolation between samples
+        int cursor = 0;                     // Interval of last evaluation
+};
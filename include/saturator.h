@@ -34,6 +34,12 @@ class saturator
 		 */
 		saturator( const saturator& rhs );
 
+        /** Copy assignment operator
+		 *
+		 *	@param[in] rhs	Right-hand side object.
+		 */
+		saturator& operator=( const saturator& rhs );
+
 		/** Destructor. 
 		 */
 		~saturator( );
@@ -93,6 +99,19 @@ class saturator
         void setUpperRateLimit( int idx, float _upperRateLimit );
 
 
+        /** Append previous control to snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const;
+
+        /** Restore previous control from snapshot
+         *
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot );
+
+
     //
     // PROTECTED MEMBER FUNCTIONS
     //
@@ -0,0 +1,195 @@
+/**
+ *	\file include/scenario.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+enum referenceType
+{
+    WAYPOINT_REFERENCE,             // Minimum-snap trajectory through waypoints
+    FILE_REFERENCE                  // Sampled reference read from file
+};
+
+
+enum estimatorType
+{
+    EKF_ESTIMATOR,                  // Extended Kalman filter
+    ESKF_ESTIMATOR,                 // Error-state Kalman filter
+    UKF_ESTIMATOR,                  // Unscented Kalman filter
+    PF_ESTIMATOR                    // Particle filter
+};
+
+
+enum distributionType
+{
+    NORMAL_DISTRIBUTION,            // Normal distribution, spread is standard deviation
+    UNIFORM_DISTRIBUTION            // Uniform distribution, spread is half-width
+};
+
+
+struct dispersion
+{
+    std::string parameter;          // Key of dispersed scenario parameter
+    distributionType distribution;  // Distribution of deviation from nominal value
+    VectorXf spread;                // Spread of each element of the parameter
+};
+
+
+struct pidGains
+{
+    VectorXf p;                     // Proportional gain of each channel
+    VectorXf i;                     // Integral gain of each channel
+    VectorXf d;                     // Derivative gain of each channel
+};
+
+
+struct signalLimits
+{
+    float control = INFINITY;       // Symmetric limit on signal, none if infinite
+    float rate = INFINITY;          // Symmetric limit on rate of signal, none if infinite
+};
+
+
+/*  Declarative description of one closed-loop simulation: initial state, vehicle parameters,
+ *  gains, limits, delays, reference, estimator, duration and outputs. The default values are
+ *  the nominal vehicle and gains of the position control script.
+ */
+struct scenario
+{
+    /** Default constructor, nominal scenario
+     */
+    scenario( );
+
+    /** Returns numeric parameter by key, as in the scenario file, for example "mass",
+     *  "inertia", "position.p" or "gps.bias"
+     *
+     * @param[in] _key          Key of parameter
+     *
+     * \return view on the elements of the parameter
+     */
+    Map<VectorXf> parameter( const std::string& _key );
+
+    std::string name;                       // Name of scenario, file name without extension
+
+    // Time
+    float initialTime;                      // Start time [s]
+    float finalTime;                        // End time [s]
+    float samplingTime;                     // Sampling time of simulation and control loops [s]
+
+    // Vehicle
+    VectorXf initialState;                  // Initial state
+    float mass;                             // Mass [kg]
+    Vector3f inertia;                       // Principal moments of inertia [kg m2]
+    float forceConstant;                    // Thrust per squared propeller velocity of one propeller
+    float momentConstant;                   // Torque per squared propeller velocity of one propeller
+    Vector2f thrustOffset;                  // Offset of thrust line from cg in x- and y-direction [m]
+
+    // Controllers
+    pidGains positionGains;                 // Position loop, 3 channels
+    pidGains velocityGains;                 // Velocity loop, 3 channels
+    pidGains attitudeGains;                 // Attitude loop, 2 channels
+    pidGains rateGains;                     // Angular rate loop, 2 channels
+
+    signalLimits positionLimits;            // Velocity command of position loop [m/s]
+    signalLimits velocityLimits;            // Acceleration command of velocity loop [m/s2]
+    signalLimits attitudeCommandLimits;     // Attitude command of INDI loop [rad]
+    signalLimits attitudeLimits;            // Rate command of attitude loop [rad/s]
+    signalLimits servoLimits;               // Gimbal angles [rad]
+    signalLimits propellerLimits;           // Propeller velocity [rad/s]
+
+    // Delays
+    float servoDelay;                       // Flight computer and servo command delay [s]
+    float propellerDelay;                   // Flight computer and ESC command delay [s]
+    float imuDelay;                         // IMU transport delay [s]
+
+    // Sensors
+    VectorXf imuNoise, imuBias;             // Standard deviation of noise and bias of Euler angles and body rates
+    VectorXf accelNoise, accelBias;         // Standard deviation of noise and bias of accelerometer specific force
+    VectorXf gpsNoise, gpsBias;             // Standard deviation of noise and bias of position and velocity
+    VectorXf baroNoise, baroBias;           // Standard deviation of noise and bias of altitude
+    VectorXf magNoise, magBias;             // Standard deviation of noise and bias of magnetic field
+    unsigned long seed;                     // Global seed of the random streams of sensor and filter noise
+    unsigned long run;                      // Run number, keys the random streams together with the seed
+
+    // Reference
+    referenceType reference;                // Kind of reference
+    MatrixXf waypoints;                     // Waypoints, one column per waypoint [m]
+    float maxVelocity;                      // Cruise velocity of time allocation [m/s]
+    float maxAcceleration;                  // Acceleration of time allocation [m/s2]
+    std::string referenceFile;              // Reference file, one column per sample
+    float referenceSamplingTime;            // Sampling time of reference file [s]
+    interpolationMethod interpolation;      // Interpolation of reference file
+
+    // Estimator
+    estimatorType estimator;                // Kind of estimator
+    int particles;                          // Number of particles of particle filter
+
+    // Outputs
+    std::string outputDirectory;            // Directory to which the telemetry files are written
+    bool telemetry;                         // Write telemetry files
+    bool levelOfDetail;                     // Write min/max pyramids next to telemetry files
+
+    // Flight recorder
+    bool recorder;                          // Write flight recorder files instead of full-rate telemetry files
+    float recorderPreTime;                  // Time captured before a trigger [s]
+    float recorderPostTime;                 // Time captured after a trigger [s]
+    float recorderSummaryTime;              // Interval of the minimum, mean and maximum of the channels [s]
+    bool saturationTrigger;                 // Capture when a gimbal servo reaches its limit
+    bool groundTrigger;                     // Capture when the vehicle hits the ground
+    float trackingErrorTrigger;             // Capture when the position error exceeds this error, 0 if none [m]
+    float tiltTrigger;                      // Capture when the tilt exceeds this angle, 0 if none [deg]
+
+    // Monte Carlo
+    std::vector<dispersion> dispersions;    // Dispersions of parameters between runs
+};
+
+
+/** Read scenario from file. Each line holds a key and its value separated by '=', vectors
+ *  are separated by spaces or commas and the waypoints by ';'. Text after '#' is a comment.
+ *  Keys that are not given keep their nominal value. Relative paths are relative to the
+ *  directory of the scenario file.
+ *
+ *      finalTime = 35
+ *      initialState = 0 0 0  0 0 0  0 0 -0.05  0 0 0
+ *      mass = 1.75
+ *      position.p = 0.7 0.7 1.0
+ *      velocity.limit = 0.3
+ *      waypoints = 0 0 -0.05; 0 0 -1; 1 1 -2; 0 0 -2
+ *      dispersion.mass = normal 0.05
+ *      dispersion.gps.bias = uniform 0.5 0.5 1.0 0 0 0
+ *
+ * @param[in] _fileName     Scenario file
+ *
+ * \return scenario, named after the file
+ */
+scenario loadScenario( const std::string& _fileName );
+
+
+/** Set parameter of a scenario from its key and value as in a scenario file, for example
+ *  ( "position.p", "0.7 0.7 1.0" ) or ( "estimator", "ukf" ). Relative paths are relative
+ *  to the working directory.
+ *
+ * @param[in,out] _scenario Scenario
+ * @param[in] _key          Key of parameter
+ * @param[in] _value        Value of parameter
+ */
+void setScenarioParameter( scenario& _scenario, const std::string& _key, const std::string& _value );
+
+
+/** Canonical description of a scenario, the same for scenarios that simulate bit-identical
+ *  results: every parameter that affects the simulation in a fixed order with exact
+ *  hexadecimal floats, and the reference file by the hash of its contents. The name,
+ *  output directory and dispersions are left out.
+ *
+ * @param[in] _scenario     Scenario
+ *
+ * \return description, one 'key = value' line per parameter
+ */
+std::string canonicalScenario( const scenario& _scenario );
@@ -29,6 +29,98 @@ class sensor
         void processOutput( VectorXf& _y );
 
 
+        /**
+         * @brief Assign update rate of sensor
+         * 
+         * @param[in] _updateRate       Update rate [Hz]
+         */
+        void setUpdateRate( float _updateRate );
+
+        /**
+         * @brief Assign latency between sampling and availability of measurement
+         * 
+         * @param[in] _latency          Latency [s]
+         */
+        void setLatency( float _latency );
+
+        /**
+         * @brief Assign standard deviation of white noise on each measurement channel
+         * 
+         * @param[in] _noise            Noise standard deviation
+         */
+        void setNoise( const VectorXf& _noise );
+
+        /**
+         * @brief Assign constant bias on each measurement channel
+         * 
+         * @param[in] _bias             Measurement bias
+         */
+        void setBias( const VectorXf& _bias );
+
+        /**
+         * @brief Assign probability that a sample is dropped
+         * 
+         * @param[in] _dropout          Dropout probability [-]
+         */
+        void setDropout( float _dropout );
+
+        /**
+         * @brief Key noise and dropout stream, each sample draws from its own tick of the stream
+         * 
+         * @param[in] _seed             Global random seed
+         * @param[in] _run              Run number
+         */
+        void setSeed( unsigned long _seed, unsigned long _run = 0 );
+
+        /**
+         * @brief Append sample schedule and sample count, the position in the noise stream, to snapshot
+         * 
+         * @param[in] _snapshot         Snapshot
+         */
+        void save( snapshot& _snapshot ) const;
+
+        /**
+         * @brief Restore sample schedule and sample count from snapshot
+         * 
+         * @param[in] _snapshot         Snapshot
+         */
+        void restore( snapshot& _snapshot );
+
+
+
+    //
+    // PROTECTED MEMBER FUNCTIONS
+    //
+    protected:
+        /**
+         * @brief Check whether a new sample is due and schedule the next one
+         * 
+         * @param[in] _time         Current time
+         * 
+         * \return true if the sensor should sample at the current time
+         */
+        bool sampleDue( float _time );
+
+        /**
+         * @brief Corrupt measurement with bias and noise and push it on the queue
+         * 
+         * @param[in] _time         Sample time
+         * @param[in] _type         Measurement type
+         * @param[in] _value        Ideal measurement, entries beyond nChannels are ignored
+         * @param[in] _queue        Queue on which the measurement is published
+         */
+        void publish( float _time, measurementType _type, const Matrix<float,6,1>& _value, measurementQueue& _queue );
+
+        /**
+         * @brief Corrupt measurement of the current sample with bias and noise
+         * 
+         * @param[in,out] _value    Ideal measurement, entries beyond nChannels are ignored
+         * 
+         * \return false if the sample is dropped
+         */
+        bool corrupt( Matrix<float,6,1>& _value );
+
+
 
     //
     // PROTECTED DATA MEMBERS
@@ -42,6 +134,20 @@ class sensor
         VectorXf GravityVector;     // Gravity vector'
         
         VectorXf PositionVector;    // Position vector
+
+        int nChannels = 0;          // Number of measurement channels
+        float updateRate = 0;       // Update rate [Hz], zero samples every call
+        float latency = 0;          // Latency between sampling and availability [s]
+        float dropout = 0;          // Probability of a dropped sample [-]
+        float nextSampleTime = 0;   // Time of next sample [s]
+        unsigned long samples = 0;  // Number of samples taken
+
+        VectorXf noise;             // Standard deviation of measurement noise
+        VectorXf bias;              // Measurement bias
+
+        unsigned long seed = 1;                 // Global random seed
+        unsigned long run = 0;                  // Run number
+        randomComponent component = IMU_STREAM; // Component of noise and dropout stream
 };
 
 
@@ -106,4 +212,136 @@ class IMUsensor : public sensor
          */
         void PositionVec( VectorXf& _yout );
 
+        /**
+         * @brief Assign standard deviation of accelerometer noise
+         * 
+         * @param[in] _noise        Standard deviation of specific force noise in body axes [m/s^2]
+         */
+        void setAccelerometerNoise( const VectorXf& _noise );
+
+        /**
+         * @brief Assign accelerometer bias
+         * 
+         * @param[in] _bias         Specific force bias in body axes [m/s^2]
+         */
+        void setAccelerometerBias( const VectorXf& _bias );
+
+        /**
+         * @brief Sample Euler angles, body rates and specific force with bias and noise if a new
+         *        sample is due, the measured output holds the last sample otherwise
+         * 
+         * @param[in] _time         Current time
+         * @param[in] _y            System output vector
+         * @param[out] _ymeas       Measured attitude, body rates and specific force (9 entries)
+         */
+        void sample( float _time, VectorXf& _y, VectorXf& _ymeas );
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /**
+         * @brief Specific force of the system, the body acceleration without gravity and
+         *        without the transport term of the body-fixed velocity
+         * 
+         * @param[in] _y            System output vector
+         * 
+         * \return Specific force in body axes [m/s^2]
+         */
+        static Vector3f specificForce( const VectorXf& _y );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        Vector3f accelNoise = Vector3f::Constant( 0.05 );   // Standard deviation of accelerometer noise [m/s^2]
+        Vector3f accelBias = Vector3f::Zero();              // Accelerometer bias [m/s^2]
+};
+
+
+class GPSsensor : public sensor
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS:
+    //
+    public:
+        /** 
+         * @brief Default constructor
+         */
+        GPSsensor( );
+
+
+        /**
+         * @brief Sample NED position and velocity if a new sample is due
+         * 
+         * @param[in] _time         Current time
+         * @param[in] _y            System output vector
+         * @param[in] _queue        Queue on which the measurement is published
+         */
+        void sample( float _time, VectorXf& _y, measurementQueue& _queue );
+};
+
+
+class BAROsensor : public sensor
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS:
+    //
+    public:
+        /** 
+         * @brief Default constructor
+         */
+        BAROsensor( );
+
+
+        /**
+         * @brief Sample altitude if a new sample is due
+         * 
+         * @param[in] _time         Current time
+         * @param[in] _y            System output vector
+         * @param[in] _queue        Queue on which the measurement is published
+         */
+        void sample( float _time, VectorXf& _y, measurementQueue& _queue );
+};
+
+
+class MAGsensor : public sensor
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS:
+    //
+    public:
+        /** 
+         * @brief Default constructor
+         */
+        MAGsensor( );
+
+
+        /**
+         * @brief Assign local earth magnetic field
+         * 
+         * @param[in] _field        Magnetic field in earth-fixed reference frame (NED) [Gauss]
+         */
+        void setField( const Vector3f& _field );
+
+        /**
+         * @brief Sample body-fixed magnetic field if a new sample is due
+         * 
+         * @param[in] _time         Current time
+         * @param[in] _y            System output vector
+         * @param[in] _queue        Queue on which the measurement is published
+         */
+        void sample( float _time, VectorXf& _y, measurementQueue& _queue );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        Vector3f field;             // Earth magnetic field (NED) [Gauss]
 };
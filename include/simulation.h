@@ -0,0 +1,234 @@
+/**
+ *	\file include/simulation.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+// Telemetry channels of the exported data
+extern const std::vector<telemetryChannel> stateChannels;           // True state, earth-fixed velocity and acceleration
+extern const std::vector<telemetryChannel> estimateChannels;        // State estimate and NEES
+extern const std::vector<telemetryChannel> inputChannels;           // Control inputs and their rates
+extern const std::vector<telemetryChannel> referenceChannels;       // References of all loops
+extern const std::vector<telemetryChannel> timeChannels;            // Simulation time
+extern const std::vector<telemetryChannel> recordChannels;          // All of the above, in the order of a record
+
+
+/*  Closed-loop position control simulation of a scenario: cascaded position, velocity, INDI
+ *  acceleration, attitude and rate loops, actuators with delays, sensors and estimator. The
+ *  simulation advances one sampling time per step, so it can be run to the end or stepped.
+ */
+class simulation
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which builds the closed loop and reference of a scenario
+         *
+         * @param[in] _scenario         Scenario to be simulated
+         */
+        simulation( const scenario& _scenario );
+
+        /** Constructor which builds the closed loop of a scenario with a given reference
+         *
+         * @param[in] _scenario         Scenario to be simulated
+         * @param[in] _reference        Reference position, must outlive the simulation
+         */
+        simulation( const scenario& _scenario, reference& _reference );
+
+        /** Simulations own a telemetry writer thread and cannot be copied
+         */
+        simulation( const simulation& rhs ) = delete;
+
+		/** Destructor, closes the telemetry files
+		 */
+		~simulation( );
+
+
+        /** Initialize controllers and estimator and open the telemetry files. Called by the
+         *  first step if not called before.
+         */
+        void init( );
+
+        /** Advance the closed loop by one sampling time
+         *
+         * \return false once the final time has been reached, the drone has hit the ground or
+         *  the state has diverged, after which no further steps are taken
+         */
+        bool step( );
+
+        /** Run the simulation to the final time and close the telemetry files
+         *
+         * \return summary metrics: maximum tilt [deg], maximum and RMS position error [m] and mean NEES
+         */
+        VectorXf run( );
+
+        /** Returns summary metrics of the steps so far
+         */
+        VectorXf metrics( ) const;
+
+        /** Returns number of steps taken
+         */
+        int iteration( ) const;
+
+        /** Returns number of telemetry records dropped because the writer fell behind. The
+         *  telemetry of a run with dropped records is incomplete and must not be cached or
+         *  cataloged.
+         */
+        unsigned long dropped( ) const;
+
+        /** Returns number of steps to the final time
+         */
+        int iterations( ) const;
+
+        /** Returns vehicle dynamics
+         */
+        const dynamics& vehicle( ) const;
+
+        /** Returns snapshot of the closed loop after the steps so far: vehicle, controllers
+         *  with their integrator and filter states, actuators, delay lines, sensor schedules,
+         *  pending measurements, estimator, random stream positions, signals and metrics.
+         *  Initializes the simulation if no step was taken.
+         */
+        snapshot save( );
+
+        /** Continue from a snapshot instead of the initial state. Called before the first step
+         *  and for a scenario with the same initial time, sampling time and estimator as the
+         *  saved one. Parameters, such as gains, vehicle properties, sensor noise, seed and run
+         *  number, are those of the scenario of this simulation, so that variants can be
+         *  forked from a common prefix. Telemetry starts at the time of the snapshot.
+         *
+         * @param[in] _snapshot         Snapshot returned by save
+         */
+        void restore( const snapshot& _snapshot );
+
+        /** Enable or disable printing of the estimator timing and dropped telemetry to
+         *  standard output at the end of the simulation
+         *
+         * @param[in] _verbose          Print summary
+         */
+        void setVerbose( bool _verbose );
+
+        /** Wait for the telemetry writer instead of dropping records when its buffer is full.
+         *  Assigned before the first step.
+         *
+         * @param[in] _lossless         Keep all records
+         */
+        void setLosslessTelemetry( bool _lossless );
+
+        /** Report progress to a counter, sampled by a progressReporter. Called before the
+         *  first step.
+         *
+         * @param[in] _counter          Progress counter, must outlive the simulation, or null
+         */
+        void setProgress( progressCounter* _counter );
+
+        /** Enable or disable recording of the telemetry records in memory, for scripts and the
+         *  GUI that read the results in-process. Called before the first step.
+         *
+         * @param[in] _recording        Keep records in memory
+         */
+        void setRecording( bool _recording );
+
+        /** Returns records kept in memory, one column of recordChannels per sample from the
+         *  initial state, or from the snapshot the simulation was restored from, to the last
+         *  step. The buffer holds all samples to the final time and does not move while
+         *  stepping.
+         */
+        const float* records( ) const;
+
+        /** Returns number of records kept in memory
+         */
+        int recordedSamples( ) const;
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Build controllers, actuators, delays and estimator from the scenario
+         */
+        void build( );
+
+        /** Write current signals to the telemetry record
+         */
+        void record( );
+
+        /** Open the telemetry files or flight recorder
+         */
+        void open( );
+
+        /** Push current record to the telemetry writer or flight recorder
+         */
+        void log( );
+
+        /** Close telemetry files
+         */
+        void close( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        scenario Scenario;                          // Simulated scenario
+
+        std::unique_ptr<reference> ownedReference;  // Reference built from the scenario
+        reference* Reference;                       // Reference position
+
+        dynamics Drone;                             // Vehicle dynamics
+        PIDcontroller PIDpos;                       // Position loop
+        PIDcontroller PIDvel;                       // Velocity loop
+        INDIcontroller INDI;                        // Acceleration loop
+        PIDcontroller PID;                          // Attitude loop
+        PIDcontroller PIDinner;                     // Angular rate loop
+
+        actuator Servos;                            // Gimbal servos
+        actuator Propellers;                        // Propeller motors
+        actuator Attitude;                          // Limits on attitude command
+        delayLine ServoDelay;                       // Servo command delay
+        delayLine PropellerDelay;                   // ESC command delay
+        delayLine AttitudeDelay;                    // IMU attitude transport delay
+        delayLine GyroDelay;                        // IMU rate transport delay
+
+        IMUsensor BNO055;                           // Inertial measurement unit
+        GPSsensor GPS;                              // Satellite navigation receiver
+        BAROsensor Barometer;                       // Barometric altimeter
+        MAGsensor Magnetometer;                     // Magnetometer
+        measurementQueue Measurements;              // Queue with asynchronous sensor measurements
+        std::unique_ptr<estimator> Estimator;       // State estimator
+
+        telemetryStream Log;                        // Telemetry writer, or flight recorder if enabled
+        VectorXf logRecord;                         // Telemetry record of current step
+        MatrixXf recordBuffer;                      // Records kept in memory, one column per sample
+        int firstStep = 0;                          // Step the simulation started from, after a restore
+
+        // Parameters, input, output and reference signals
+        VectorXf p, u, u_serv, u_prop, e, ySystem, yIMU;
+        VectorXf y_position, y_vel, y_acc, y_attitude, y_omega;
+        VectorXf ref_pos, ref_vel, ref_acc, ref_attitude, ref_omega, ff_vel, ff_acc;
+
+        int Nsim = 0;                               // Number of steps to the final time
+        int i = 0;                                  // Number of steps taken
+        bool initialized = false;                   // Set by init
+        bool stopped = false;                       // Set when a step ended the simulation
+        bool closed = false;                        // Set when the telemetry files are closed
+        bool verbose = true;                        // Print progress
+        bool recording = false;                     // Keep records in memory
+        progressCounter* progress = nullptr;        // Progress counter, if reported
+
+        double neesSum = 0;                         // Sum of NEES over all samples
+        double errorSum = 0;                        // Sum of squared position errors
+        double estimatorTime = 0;                   // Accumulated wall-clock time of estimator [s]
+        VectorXf summary = VectorXf::Zero( 4 );     // Maximum tilt, maximum and RMS position error, mean NEES
+};
@@ -0,0 +1,113 @@
+/**
+ *	\file include/snapshot.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/*  Compact binary blob holding the dynamic state of simulation components: integrator
+ *  states, filter memories, delay line histories, random stream counters. Parameters are
+ *  not stored, they are taken from the object the state is restored into. Values are
+ *  written and read back in the same order, matrices with their dimensions.
+ */
+class snapshot
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Default constructor, empty snapshot
+         */
+        snapshot( );
+
+        /** Constructor which takes a blob written before, positioned at its start
+         *
+         * @param[in] _blob             Blob
+         */
+        snapshot( std::vector<char> _blob );
+
+
+        /** Append value of arithmetic, enumeration or trivially copyable type
+         *
+         * @param[in] _value            Value
+         */
+        template<typename T, typename = std::enable_if_t<std::is_trivially_copyable<T>::value && !std::is_base_of<EigenBase<T>,T>::value>>
+        void write( const T& _value );
+
+        /** Append matrix with its dimensions
+         *
+         * @param[in] _matrix           Matrix
+         */
+        template<typename Derived>
+        void write( const MatrixBase<Derived>& _matrix );
+
+        /** Append quaternion
+         *
+         * @param[in] _quaternion       Quaternion
+         */
+        void write( const Quaternionf& _quaternion );
+
+
+        /** Read next value of arithmetic, enumeration or trivially copyable type
+         *
+         * @param[out] _value           Value
+         */
+        template<typename T, typename = std::enable_if_t<std::is_trivially_copyable<T>::value && !std::is_base_of<EigenBase<T>,T>::value>>
+        void read( T& _value );
+
+        /** Read next matrix, dynamic dimensions are resized and fixed dimensions must match
+         *
+         * @param[out] _matrix          Matrix
+         */
+        template<typename Derived>
+        void read( PlainObjectBase<Derived>& _matrix );
+
+        /** Read next quaternion
+         *
+         * @param[out] _quaternion      Quaternion
+         */
+        void read( Quaternionf& _quaternion );
+
+
+        /** Position at the start of the blob
+         */
+        void rewind( );
+
+        /** Returns blob
+         */
+        const std::vector<char>& blob( ) const;
+
+        /** Returns size of blob [bytes]
+         */
+        size_t size( ) const;
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Append bytes
+         */
+        void append( const void* _data, size_t _size );
+
+        /** Read next bytes, throws if the blob is exhausted
+         */
+        void extract( void* _data, size_t _size );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::vector<char> data;         // Blob
+        size_t position = 0;            // Read position [bytes]
+};
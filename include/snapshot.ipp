@@ -0,0 +1,52 @@
+/**
+ *	\file include/snapshot.ipp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+template<typename T, typename>
+inline void snapshot::write( const T& _value )
+{
+    append( &_value, sizeof( T ) );
+}
+
+
+template<typename Derived>
+inline void snapshot::write( const MatrixBase<Derived>& _matrix )
+{
+    // Column-major, whatever the storage order of the matrix
+    MatrixXf values = _matrix.template cast<float>();
+    int32_t dims[2] = { (int32_t) values.rows(), (int32_t) values.cols() };
+
+    append( dims, sizeof( dims ) );
+    append( values.data(), sizeof( float )*values.size() );
+}
+
+
+template<typename T, typename>
+inline void snapshot::read( T& _value )
+{
+    extract( &_value, sizeof( T ) );
+}
+
+
+template<typename Derived>
+inline void snapshot::read( PlainObjectBase<Derived>& _matrix )
+{
+    int32_t dims[2];
+    extract( dims, sizeof( dims ) );
+
+    if ( dims[0] < 0 || dims[1] < 0 ||
+         ( Derived::RowsAtCompileTime != Dynamic && Derived::RowsAtCompileTime != dims[0] ) ||
+         ( Derived::ColsAtCompileTime != Dynamic && Derived::ColsAtCompileTime != dims[1] ) )
+        throw std::invalid_argument("Snapshot does not match the dimensions of the restored state");
+
+    MatrixXf values( dims[0], dims[1] );
+    extract( values.data(), sizeof( float )*values.size() );
+
+    _matrix = values.template cast<typename Derived::Scalar>();
+}
@@ -0,0 +1,262 @@
+/**
+ *	\file include/telemetry.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+/*  Telemetry file layout, all values little-endian:
+ *
+ *      header          64 bytes    magic "TVCLOG", version, number of channels, samples per
+ *                                  chunk, number of samples, offset of the first chunk, offset
+ *                                  of the chunk index and raw samples per sample (bucket size)
+ *      channel table   64 bytes    name (40), unit (16) and numpy dtype string (8) per channel
+ *      chunks                      for each chunk and each channel, samples per chunk values
+ *
+ *  Each channel is stored as a contiguous float32 array within a chunk. The last chunk is
+ *  padded to full length, the number of samples in the header excludes the padding. A file
+ *  written in a single chunk holds one contiguous array per channel.
+ *
+ *  Compressed files (flag in header) store each chunk as its number of samples, the size and
+ *  codec of each channel and the compressed channels (see compression.h). The chunks are
+ *  followed by an index with the offset and the first value of each channel per chunk, of
+ *  which the offset is stored in the header on closing.
+ */
+
+
+class lodPyramid;
+
+
+/** Name and unit of a telemetry channel
+ */
+struct telemetryChannel
+{
+    std::string name;               // Channel name, at most 39 characters
+    std::string unit;               // Channel unit, at most 15 characters
+};
+
+
+class telemetryWriter
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which creates the telemetry file and writes its header
+         *
+         * @param[in] _fileName         Name of telemetry file
+         * @param[in] _channels         Name and unit of each channel
+         * @param[in] _chunkSamples     Number of samples per chunk
+         * @param[in] _compressed       Compress each chunk
+         */
+        telemetryWriter( std::string _fileName, const std::vector<telemetryChannel>& _channels, int _chunkSamples = 4096, bool _compressed = false );
+
+        /** Telemetry writers own their file and cannot be copied
+         */
+        telemetryWriter( const telemetryWriter& rhs ) = delete;
+
+		/** Destructor, writes pending samples and closes the file
+		 */
+		~telemetryWriter( );
+
+
+        /** Append one sample of all channels. Full chunks are written to disk.
+         *
+         * @param[in] _sample           Value of each channel
+         */
+        void write( const Ref<const VectorXf>& _sample );
+
+        /** Append multiple samples of all channels
+         *
+         * @param[in] _samples          Samples with one row per channel and one column per sample
+         */
+        void writeBlock( const Ref<const MatrixXf>& _samples );
+
+        /** Write a min/max level of detail pyramid alongside the samples, see lodPyramid.h.
+         *  Enabled before the first sample is written.
+         *
+         * @param[in] _factor           Number of buckets combined per level
+         */
+        void enableLevelOfDetail( int _factor = 4 );
+
+        /** Assign number of raw samples summarized by each sample, stored in the header of
+         *  the levels of a pyramid. Files of raw samples have a bucket size of 1.
+         *
+         * @param[in] _bucketSize       Raw samples per sample
+         */
+        void setBucketSize( uint64_t _bucketSize );
+
+        /** Write pending samples as a last chunk, write the chunk index and close the file
+         */
+        void close( );
+
+        /** Returns number of samples written
+         */
+        unsigned long samples( ) const;
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Write current chunk and update number of samples in header
+         */
+        void writeChunk( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::ofstream File;                 // Telemetry file
+        std::string fileName;               // Name of telemetry file
+        std::vector<telemetryChannel> channelTable;     // Name and unit of each channel
+
+        int nChannels;                      // Number of channels
+        int chunkSamples;                   // Number of samples per chunk
+        bool compressed;                    // Chunks are compressed
+
+        std::vector<uint8_t> chunkBytes;    // Compressed chunk
+        std::vector<uint64_t> chunkOffsets; // Offset of each compressed chunk [bytes]
+        std::vector<float> chunkKeys;       // First value of each channel of each compressed chunk
+
+        uint64_t nSamples = 0;              // Number of samples in written chunks
+        int fill = 0;                       // Number of samples in current chunk
+
+        MatrixXf chunk;                     // Current chunk, one column per channel
+
+        std::unique_ptr<lodPyramid> pyramid;    // Level of detail pyramid, if enabled
+};
+
+
+class telemetryReader
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which maps the telemetry file and reads its channel table
+         *
+         * @param[in] _fileName         Name of telemetry file
+         */
+        telemetryReader( std::string _fileName );
+
+        /** Telemetry readers own their mapping and cannot be copied
+         */
+        telemetryReader( const telemetryReader& rhs ) = delete;
+
+		/** Destructor
+		 */
+		~telemetryReader( );
+
+
+        /** Returns number of channels
+         */
+        int channels( ) const;
+
+        /** Returns number of samples per channel
+         */
+        unsigned long samples( ) const;
+
+        /** Returns name and unit of a channel
+         *
+         * @param[in] _index            Channel index
+         */
+        const telemetryChannel& channelInfo( int _index ) const;
+
+        /** Returns index of channel with given name
+         *
+         * @param[in] _name             Channel name
+         */
+        int channelIndex( const std::string& _name ) const;
+
+        /** Returns all samples of a channel
+         *
+         * @param[in] _index            Channel index
+         */
+        VectorXf channel( int _index ) const;
+
+        /** Returns all samples of a channel
+         *
+         * @param[in] _name             Channel name
+         */
+        VectorXf channel( const std::string& _name ) const;
+
+        /** Returns range of samples of a channel, only the chunks holding the range are read
+         *
+         * @param[in] _index            Channel index
+         * @param[in] _first            First sample
+         * @param[in] _count            Number of samples
+         */
+        VectorXf channel( int _index, unsigned long _first, unsigned long _count ) const;
+
+        /** Read range of samples of all channels, each chunk holding the range is read once
+         *
+         * @param[in] _first            First sample
+         * @param[in] _count            Number of samples
+         * @param[out] _values          Samples with one row per channel and one column per sample
+         */
+        void block( unsigned long _first, unsigned long _count, MatrixXf& _values ) const;
+
+        /** Find first sample of a nondecreasing channel, such as time, that is not less
+         *  than a value. Only one chunk is read.
+         *
+         * @param[in] _index            Channel index
+         * @param[in] _value            Value to search for
+         *
+         * \return index of sample, or number of samples if all samples are less than the value
+         */
+        unsigned long findSample( int _index, float _value ) const;
+
+        /** Returns all samples with one row per channel and one column per sample
+         */
+        MatrixXf matrix( ) const;
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Read all samples of one channel in a chunk
+         *
+         * @param[in] _chunk            Chunk index
+         * @param[in] _index            Channel index
+         * @param[out] _values          Samples, number of samples of the chunk
+         */
+        void readChunk( uint64_t _chunk, int _index, float* _values ) const;
+
+        /** Returns number of samples in a chunk
+         */
+        int chunkLength( uint64_t _chunk ) const;
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::unique_ptr<mappedFile> File;           // Mapped telemetry file
+
+        std::vector<telemetryChannel> channelTable; // Name and unit of each channel
+
+        int nChannels;                              // Number of channels
+        int chunkSamples;                           // Number of samples per chunk
+        uint64_t nSamples;                          // Number of samples per channel
+        uint64_t dataOffset;                        // Offset of first chunk [bytes]
+        uint64_t nChunks;                           // Number of chunks
+        bool compressed;                            // Chunks are compressed
+
+        std::vector<uint64_t> chunkOffsets;         // Offset of each compressed chunk [bytes]
+        MatrixXf chunkKeys;                         // First value of each channel (rows) of each chunk (columns)
+};
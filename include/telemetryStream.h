@@ -0,0 +1,145 @@
+/**
+ *	\file include/telemetryStream.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+class flightRecorder;
+
+
+class telemetryStream
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Constructor which takes the size of the record buffer
+         *
+         * @param[in] _capacity         Number of records held in memory
+         * @param[in] _chunkSamples     Number of samples per chunk of the telemetry files
+         * @param[in] _compressed       Compress the telemetry files
+         */
+        telemetryStream( int _capacity = 8192, int _chunkSamples = 1024, bool _compressed = false );
+
+        /** Telemetry streams own their writer thread and cannot be copied
+         */
+        telemetryStream( const telemetryStream& rhs ) = delete;
+
+		/** Destructor, writes pending records and closes all files
+		 */
+		~telemetryStream( );
+
+
+        /** Add telemetry file holding the next channels of each record. Files are
+         *  added before the stream is started.
+         *
+         * @param[in] _fileName         Name of telemetry file
+         * @param[in] _channels         Name and unit of each channel
+         */
+        void addFile( std::string _fileName, const std::vector<telemetryChannel>& _channels );
+
+        /** Pass the records to a flight recorder instead of writing them to telemetry files.
+         *  The writer thread evaluates the triggers and writes the captures and summaries,
+         *  so the producer does not perform I/O. Assigned before the stream is started, in
+         *  place of files.
+         *
+         * @param[in] _recorder         Flight recorder, owned by the stream
+         */
+        void setRecorder( std::unique_ptr<flightRecorder> _recorder );
+
+        /** Start writer thread
+         */
+        void start( );
+
+        /** Copy record into the buffer, to be written to disk by the writer thread.
+         *  Does not lock or perform I/O. When the buffer is full the record is dropped
+         *  and counted, unless the stream is lossless, see setLossless.
+         *
+         * @param[in] _record           Value of each channel of all files
+         *
+         * \return false if the record was dropped
+         */
+        bool push( const Ref<const VectorXf>& _record );
+
+        /** Write pending records, stop writer thread and close all files. Rethrows
+         *  an exception raised while writing.
+         */
+        void close( );
+
+        /** Write a min/max level of detail pyramid alongside each telemetry file.
+         *  Assigned before the stream is started.
+         *
+         * @param[in] _enable           Write pyramids
+         */
+        void setLevelOfDetail( bool _enable );
+
+        /** Assign behaviour of push when the buffer is full. A lossless stream waits for
+         *  the writer, so that the producer is slowed down to the speed of the disk.
+         *
+         * @param[in] _lossless         Wait for the writer instead of dropping records
+         */
+        void setLossless( bool _lossless );
+
+        /** Returns number of channels per record
+         */
+        int channels( ) const;
+
+        /** Returns name and unit of each channel of a record
+         */
+        const std::vector<telemetryChannel>& channelList( ) const;
+
+        /** Returns number of dropped records
+         */
+        unsigned long dropped( ) const;
+
+        /** Returns flight recorder, or null if the records are written to telemetry files
+         */
+        const flightRecorder* recorder( ) const;
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Write buffered records to the telemetry files until the stream is closed
+         */
+        void writer( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::vector<std::unique_ptr<telemetryWriter>> files;   // Telemetry files
+        std::unique_ptr<flightRecorder> Recorder;       // Flight recorder, in place of the files
+        std::vector<int> firstChannel;                  // First record channel of each file
+        std::vector<telemetryChannel> channelTable;     // Name and unit of each record channel
+
+        int nChannels = 0;                              // Number of channels per record
+        int capacity;                                   // Number of records in buffer
+        int chunkSamples;                               // Number of samples per chunk
+        bool compressed;                                // Compress the telemetry files
+        bool lossless = false;                          // Wait for the writer when the buffer is full
+        bool levelOfDetail = false;                     // Write level of detail pyramids
+
+        MatrixXf buffer;                                // Ring buffer, one column per record
+
+        std::atomic<uint64_t> head{ 0 };                // Number of pushed records, written by producer
+        std::atomic<uint64_t> tail{ 0 };                // Number of written records, written by writer thread
+        std::atomic<bool> stopping{ false };            // Set when the stream is closed
+        std::atomic<bool> failed{ false };              // Set when the writer thread raised an exception
+        unsigned long nDropped = 0;                     // Number of dropped records
+
+        std::thread thread;                             // Writer thread
+        std::exception_ptr error;                       // Exception raised by the writer thread
+};
@@ -0,0 +1,105 @@
+/**
+ *	\file include/threadPool.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+#include <Eigen/Dense>              // #include module
+using namespace Eigen;              // using namespace of module
+
+
+class threadPool
+{
+    //
+    // PUBLIC MEMBER FUNCTIONS
+    //
+    public:
+
+        /** Default constructor, one thread per hardware core
+         */
+        threadPool( );
+
+        /** Constructor which takes the number of threads
+         *
+         * @param[in] _nThreads         Number of threads, including the calling thread
+         */
+        threadPool( unsigned int _nThreads );
+
+        /** Thread pools own their threads and cannot be copied
+         */
+        threadPool( const threadPool& rhs ) = delete;
+
+		/** Destructor, finishes pending tasks and joins all threads
+		 */
+		~threadPool( );
+
+
+        /** Queue task for execution by a worker thread
+         *
+         * @param[in] _task             Task to be executed
+         */
+        void submit( std::function<void()> _task );
+
+        /** Block until all queued tasks have finished. Rethrows the first exception
+         *  thrown by a task.
+         */
+        void wait( );
+
+        /** Split the range [0,n) in one contiguous part per thread and process
+         *  all parts in parallel. The calling thread processes the first part.
+         *
+         * @param[in] _n                Length of range
+         * @param[in] _body             Function called with begin and end of each part
+         */
+        void parallelFor( int _n, const std::function<void(int,int)>& _body );
+
+        /** Process all indices of the range [0,n) in parallel with work stealing. Each
+         *  thread starts on a contiguous part and, once it runs out, steals half of the
+         *  largest remaining part of another thread. Suited to items of uneven cost.
+         *
+         * @param[in] _n                Length of range
+         * @param[in] _body             Function called with each index
+         */
+        void parallelForEach( int _n, const std::function<void(int)>& _body );
+
+        /** Replace data by its inclusive prefix sum, computed in parallel on parts of
+         *  fixed length. The result does not depend on the number of threads.
+         *
+         * @param[in] _data             Data, updated in place
+         */
+        void inclusiveScan( VectorXf& _data );
+
+        /** Returns number of threads, including the calling thread
+         */
+        unsigned int size( ) const;
+
+
+
+    //
+    // PRIVATE MEMBER FUNCTIONS
+    //
+    private:
+        /** Execute queued tasks until the pool is stopped
+         */
+        void worker( );
+
+
+
+    //
+    // PRIVATE DATA MEMBERS
+    //
+    private:
+        std::vector<std::thread> workers;               // Worker threads
+        std::deque<std::function<void()>> tasks;        // Queued tasks
+
+        std::mutex mutex;                               // Protects tasks, pending, stopping and error
+        std::condition_variable taskAvailable;          // Signalled when a task is queued or the pool stops
+        std::condition_variable tasksDone;              // Signalled when all tasks have finished
+
+        unsigned int pending = 0;                       // Number of queued and running tasks
+        bool stopping = false;                          // Set when the pool is destroyed
+        std::exception_ptr error;                       // First exception thrown by a task
+};
@@ -0,0 +1,129 @@
+/**
+ *	\file include/tvcsim.h
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#pragma once
+
+
+/*  C interface of the simulator, built as the shared library libtvcsim.so, so that the GUI and
+ *  scripts run simulations in-process, e.g. from Python with ctypes:
+ *
+ *      tvcsimScenario* Scenario = tvcsimCreateScenario( );
+ *      tvcsimSetParameter( Scenario, "position.p", "0.8 0.8 1.0" );
+ *      tvcsimSimulation* Simulation = tvcsimCreateSimulation( Scenario );
+ *      tvcsimRun( Simulation, metrics );
+ *      const float* records = tvcsimRecords( Simulation, &channels, &samples );
+ *
+ *  The records are the telemetry records of the simulation kept in memory, one block of
+ *  channels per sample, in the order of the channels of state.tlm, estimate.tlm, ref.tlm,
+ *  input.tlm and time.tlm. The buffer belongs to the simulation: it holds all samples to the
+ *  final time, does not move while stepping and is valid until the simulation is destroyed.
+ *
+ *  Functions do not throw: on failure they return a null pointer or -1, and tvcsimLastError
+ *  returns the message. Scenarios and simulations are not shared between threads.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tvcsimScenario tvcsimScenario;
+typedef struct tvcsimSimulation tvcsimSimulation;
+
+
+/** Returns version of the simulator
+ */
+const char* tvcsimVersion( void );
+
+/** Returns message of the last failure in the calling thread, empty if none
+ */
+const char* tvcsimLastError( void );
+
+
+/** Create nominal scenario, without telemetry files
+ */
+tvcsimScenario* tvcsimCreateScenario( void );
+
+/** Create scenario from a scenario file, see loadScenario
+ *
+ * @param[in] _fileName         Scenario file
+ */
+tvcsimScenario* tvcsimLoadScenario( const char* _fileName );
+
+/** Destroy scenario
+ */
+void tvcsimDestroyScenario( tvcsimScenario* _scenario );
+
+/** Set parameter from its key and value as in a scenario file, e.g. ( "mass", "1.8" ),
+ *  ( "estimator", "ukf" ) or ( "telemetry", "true" )
+ *
+ * \return 0, or -1 on failure
+ */
+int tvcsimSetParameter( tvcsimScenario* _scenario, const char* _key, const char* _value );
+
+/** Copy numeric parameter by key, see scenario::parameter
+ *
+ * @param[out] _values          Values, at least _size elements, or null to query the size
+ * @param[in] _size             Size of _values
+ *
+ * \return number of elements of the parameter, or -1 on failure
+ */
+int tvcsimGetParameter( tvcsimScenario* _scenario, const char* _key, float* _values, int _size );
+
+
+/** Create simulation of a scenario, which keeps its records in memory. The scenario may be
+ *  changed or destroyed afterwards.
+ */
+tvcsimSimulation* tvcsimCreateSimulation( const tvcsimScenario* _scenario );
+
+/** Destroy simulation, closes its telemetry files and releases its records
+ */
+void tvcsimDestroySimulation( tvcsimSimulation* _simulation );
+
+/** Advance simulation by a number of sampling times, or less if it ends before
+ *
+ * \return number of steps taken, or -1 on failure
+ */
+int tvcsimStep( tvcsimSimulation* _simulation, int _steps );
+
+/** Run simulation to its end
+ *
+ * @param[out] _metrics         Summary metrics, see simulation::run, 4 elements, or null
+ *
+ * \return number of steps of the simulation, or -1 on failure
+ */
+int tvcsimRun( tvcsimSimulation* _simulation, float* _metrics );
+
+/** Returns 1 once the simulation has ended, 0 otherwise
+ */
+int tvcsimFinished( const tvcsimSimulation* _simulation );
+
+/** Copy summary metrics of the steps so far, 4 elements
+ */
+void tvcsimMetrics( const tvcsimSimulation* _simulation, float* _metrics );
+
+/** Returns records of the simulation so far, without copying
+ *
+ * @param[out] _channels        Number of channels of a record
+ * @param[out] _samples         Number of samples
+ */
+const float* tvcsimRecords( const tvcsimSimulation* _simulation, int* _channels, int* _samples );
+
+
+/** Returns number of channels of a record
+ */
+int tvcsimChannels( void );
+
+/** Returns name of a channel of a record, null if out of range
+ */
+const char* tvcsimChannelName( int _channel );
+
+/** Returns unit of a channel of a record, null if out of range
+ */
+const char* tvcsimChannelUnit( int _channel );
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,8 +1,238 @@
 #include "header.h"
 
 
+/* Run scenario files concurrently, each writing its telemetry to its own directory
+ *
+ *   Simulator <scenario file or directory> [--output <directory>] [--threads <n>] [--cache <directory>] [--cache-size <MB>] [--quiet] [--json]
+ *   Simulator <scenario file> --montecarlo <runs> [--seed <n>] [--fork <time>] [--scaling] [--output <directory>] [--threads <n>] [--cache <directory>] [--cache-size <MB>] [--quiet] [--json]
+ *   Simulator <scenario file> --run <run> [--seed <n>] [--fork <time>] [--output <directory>] [--quiet] [--json]
+ *
+ * A directory runs every *.scn file in it. The metrics of all scenarios are written to
+ * summary.csv in the output directory. Exits with 0 if all scenarios ran, 1 otherwise.
+ *
+ * With --montecarlo the dispersions of the scenario file are sampled for the given number
+ * of runs, which are added to a run catalog in <output directory>/<scenario name>. With
+ * --scaling the runs are repeated for 1, 2, 4, ... threads, without catalog, to report the
+ * throughput against the number of threads. With --fork the nominal scenario is flown once
+ * up to the given time and all runs continue from its snapshot at that time. With --run a
+ * single run of the analysis is repeated in isolation, bit-exact, writing its telemetry to
+ * <output directory>/<scenario name>_<run>.
+ *
+ * With --cache scenarios that were simulated before by the same version of the simulator
+ * are restored from the result cache in the given directory instead of simulated, and new
+ * results are added to it. The least recently used results are evicted beyond the cache
+ * size, 1024 MB by default. Scaling measurements and single runs bypass the cache.
+ *
+ * The progress of the runs, their throughput and the estimated time to completion are
+ * reported to standard error once per second, as text or with --json as one JSON object per
+ * line. With --quiet nothing is reported. Scaling measurements are not reported.
+ */
+static int runMonteCarlo( const std::string& _file, const std::string& _outputDirectory, unsigned long _runs,
+                          unsigned long _seed, unsigned int _nThreads, bool _scaling, long _run, resultCache* _cache, float _forkTime,
+                          progressReporter* _progress )
+{
+    monteCarlo MonteCarlo( loadScenario( _file ), _seed );
+    MonteCarlo.setForkTime( _forkTime );
+
+    if ( _run >= 0 )
+    {
+        scenario Scenario = MonteCarlo.sample( _run );
+        Scenario.outputDirectory = _outputDirectory + "/" + Scenario.name;
+        std::filesystem::create_directories( Scenario.outputDirectory );
+
+        simulation Simulation( Scenario );
+        Simulation.setVerbose( false );
+
+        if ( _progress )
+        {
+            _progress->start( 1 );
+            Simulation.setProgress( &_progress->counter( 0 ) );
+        }
+
+        snapshot Prefix = MonteCarlo.prefix( );
+        if ( Prefix.size() > 0 )
+            Simulation.restore( Prefix );
+
+        VectorXf metrics = Simulation.run( );
+
+        if ( _progress )
+            _progress->stop( );
+
+        std::cout << "run " << _run << ": " << Simulation.iteration( ) << " steps, maxTilt " << metrics(0) << ", maxPositionError " << metrics(1)
+                  << ", rmsPositionError " << metrics(2) << ", meanNEES " << metrics(3) << ", telemetry in " << Scenario.outputDirectory << std::endl;
+        return 0;
+    }
+
+    if ( _scaling )
+    {
+        for ( unsigned int n=1; n<=_nThreads; n = n < _nThreads && 2*n > _nThreads ? _nThreads : 2*n )
+            std::cout << "threads: " << n << ", " << MonteCarlo.run( _runs, n ) << " sims/s" << std::endl;
+        return 0;
+    }
+
+    std::string directory = _outputDirectory + "/" + std::filesystem::path( _file ).stem().string();
+    runCatalog Catalog( directory, MonteCarlo.fields() );
+
+    double throughput = MonteCarlo.run( _runs, _nThreads, &Catalog, _cache, _progress );
+
+    std::cout << _runs << " runs on " << _nThreads << " threads, " << throughput << " sims/s, catalog in " << directory;
+    if ( _cache )
+        std::cout << ", " << _cache->hits() << " runs from cache";
+    if ( MonteCarlo.incomplete() > 0 )
+        std::cout << ", " << MonteCarlo.incomplete() << " runs dropped telemetry and were not cataloged";
+    std::cout << std::endl;
+
+    return 0;
+}
+
+
+static int runScenarios( const std::vector<std::string>& _args )
+{
+    std::string input, outputDirectory = "../data/scenarios", cacheDirectory;
+    unsigned int nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    unsigned long runs = 0, seed = 1, cacheSize = 1024;
+    long run = -1;
+    float forkTime = -INFINITY;
+    bool scaling = false, quiet = false;
+    reportFormat format = TEXT_REPORT;
+
+    for ( size_t i=0; i<_args.size(); ++i )
+    {
+        if ( _args[i] == "--output" && i+1 < _args.size() ) outputDirectory = _args[++i];
+        else if ( _args[i] == "--threads" && i+1 < _args.size() ) nThreads = std::max( 1, std::stoi( _args[++i] ) );
+        else if ( _args[i] == "--montecarlo" && i+1 < _args.size() ) runs = std::stoul( _args[++i] );
+        else if ( _args[i] == "--seed" && i+1 < _args.size() ) seed = std::stoul( _args[++i] );
+        else if ( _args[i] == "--run" && i+1 < _args.size() ) run = std::stol( _args[++i] );
+        else if ( _args[i] == "--fork" && i+1 < _args.size() ) forkTime = std::stof( _args[++i] );
+        else if ( _args[i] == "--cache" && i+1 < _args.size() ) cacheDirectory = _args[++i];
+        else if ( _args[i] == "--cache-size" && i+1 < _args.size() ) cacheSize = std::stoul( _args[++i] );
+        else if ( _args[i] == "--scaling" ) scaling = true;
+        else if ( _args[i] == "--quiet" ) quiet = true;
+        else if ( _args[i] == "--json" ) format = JSON_REPORT;
+        else input = _args[i];
+    }
+
+    std::vector<std::string> files;
+    if ( std::filesystem::is_directory( input ) )
+    {
+        for ( const auto& entry : std::filesystem::directory_iterator( input ) )
+            if ( entry.path().extension() == ".scn" )
+                files.push_back( entry.path().string() );
+        std::sort( files.begin(), files.end() );
+    }
+    else
+        files.push_back( input );
+
+    if ( input.empty() || ( files.empty() || !std::filesystem::exists( files[0] ) ) )
+    {
+        std::cerr << "Usage: Simulator <scenario file or directory> [--output <directory>] [--threads <n>] [--cache <directory>] [--cache-size <MB>] [--quiet] [--json]" << std::endl;
+        std::cerr << "       Simulator <scenario file> --montecarlo <runs> [--seed <n>] [--fork <time>] [--scaling] [--output <directory>] [--threads <n>] [--cache <directory>] [--cache-size <MB>] [--quiet] [--json]" << std::endl;
+        std::cerr << "       Simulator <scenario file> --run <run> [--seed <n>] [--fork <time>] [--output <directory>] [--quiet] [--json]" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<resultCache> Cache;
+    if ( !cacheDirectory.empty() )
+        Cache.reset( new resultCache( cacheDirectory, (uintmax_t) cacheSize << 20 ) );
+
+    std::unique_ptr<progressReporter> Progress;
+    if ( !quiet )
+        Progress.reset( new progressReporter( format ) );
+
+    if ( runs > 0 || run >= 0 )
+        return runMonteCarlo( files[0], outputDirectory, runs, seed, nThreads, scaling, run, Cache.get(), forkTime, Progress.get() );
+
+    std::vector<VectorXf> results( files.size() );
+    std::vector<std::string> errors( files.size() );
+    std::mutex outputMutex;
+
+    if ( Progress )
+        Progress->start( files.size() );
+
+    // Work stealing, so that long and short scenarios balance
+    threadPool Pool( std::min( nThreads, (unsigned int) files.size() ) );
+    Pool.parallelForEach( files.size(), [&]( int k )
+    {
+        std::string name = std::filesystem::path( files[k] ).stem().string();
+        progressCounter* counter = Progress ? &Progress->counter( k ) : nullptr;
+
+        try
+        {
+            scenario Scenario = loadScenario( files[k] );
+            Scenario.outputDirectory = outputDirectory + "/" + name;
+            std::filesystem::create_directories( Scenario.outputDirectory );
+
+            int steps;
+            if ( !Cache || !Cache->lookup( Scenario, results[k], steps ) )
+            {
+                simulation Simulation( Scenario );
+                Simulation.setVerbose( false );
+                Simulation.setProgress( counter );
+                results[k] = Simulation.run( );
+
+                // Incomplete telemetry is not cached
+                if ( Simulation.dropped( ) > 0 )
+                {
+                    std::lock_guard<std::mutex> lock( outputMutex );
+                    std::cout << name << ": " << Simulation.dropped( ) << " telemetry records dropped, not cached" << std::endl;
+                }
+                else if ( Cache )
+                    Cache->store( Scenario, results[k], Simulation.iteration( ) );
+            }
+            else if ( counter )
+            {
+                counter->totalSteps.store( steps, std::memory_order_relaxed );
+                counter->steps.store( steps, std::memory_order_relaxed );
+            }
+        }
+        catch ( const std::exception& e )
+        {
+            errors[k] = e.what();
+        }
+
+        if ( counter )
+            counter->finished.store( true, std::memory_order_release );
+
+        // Progress is reported by the reporter, only failures are printed
+        if ( !errors[k].empty() )
+        {
+            std::lock_guard<std::mutex> lock( outputMutex );
+            std::cout << name << ": failed, " << errors[k] << std::endl;
+        }
+    } );
+
+    if ( Progress )
+        Progress->stop( );
+
+    std::filesystem::create_directories( outputDirectory );
+    std::ofstream summary( outputDirectory + "/summary.csv" );
+    summary << "scenario,maxTilt,maxPositionError,rmsPositionError,meanNEES,error" << std::endl;
+
+    int failed = 0;
+    for ( size_t k=0; k<files.size(); ++k )
+    {
+        summary << std::filesystem::path( files[k] ).stem().string();
+        for ( int j=0; j<4; ++j )
+            summary << "," << ( errors[k].empty() ? std::to_string( results[k](j) ) : "" );
+        summary << ",\"" << errors[k] << "\"" << std::endl;
+        failed += !errors[k].empty();
+    }
+
+    std::cout << files.size() - failed << " of " << files.size() << " scenarios ran";
+    if ( Cache )
+        std::cout << ", " << Cache->hits() << " from cache";
+    std::cout << ", summary in " << outputDirectory << "/summary.csv" << std::endl;
+
+    return failed > 0 ? 1 : 0;
+}
+
+
 int main(int argc, char const *argv[])
 {
+    // Batch mode: run scenario files
+    if ( argc > 1 )
+        return runScenarios( std::vector<std::string>( argv + 1, argv + argc ) );
+
     /* Set-up dynamics model */
 
     VectorXf initState = VectorXf::Zero(12);
@@ -13,11 +243,25 @@ int main(int argc, char const *argv[])
     dynamics Drone( initState, initTime, samplingTime );
     
     
-    // Set reference using polynomial coefficients
-    MatrixXf ref = loadFromFile("../guidance/trajectory.csv",3,(finalTime-initTime)/samplingTime);
+    // Set reference as minimum-snap trajectory through waypoints
+    MatrixXf waypoints(3,4);
+    waypoints << 0.0,   0.0,  1.0,  0.0,
+                 0.0,   0.0,  1.0,  0.0,
+                -0.05, -1.0, -2.0, -2.0;
+
+    minSnapTrajectory ref( waypoints, 0.5, 0.2 );          // Cruise velocity 0.5 m/s, acceleration 0.2 m/s2
+    // sampledReference ref( loadFromFile("../guidance/trajectory.csv"), 0.01, 0.0, HERMITE_INTERPOLATION );     // Reference file at its own sampling time
 
     // Simulate rocket launch
     INDIpositionControl( Drone,ref,finalTime );
 
+    // Keep results of many runs in a catalog instead, each run writes to its own directory
+    // runCatalog Catalog( "../data/runs", { "finalTime", "maxTilt", "maxPositionError", "rmsPositionError", "meanNEES" } );
+    // unsigned long run = Catalog.beginRun( );
+    // VectorXf metrics = INDIpositionControl( Drone,ref,finalTime,Catalog.runDirectory( run ) );
+    // VectorXf values(5); values << finalTime, metrics;
+    // Catalog.addRun( run, 0, runCatalog::hash( "../guidance/trajectory.csv" ), values );
+    // for ( const runRecord& r : Catalog.query( "maxTilt > 20", "maxPositionError", true, 10 ) ) std::cout << r.directory << std::endl;
+
     return 0;
 }
\ No newline at end of file
@@ -8,6 +8,11 @@
 #include "../header.h"    // #include header
 
 
+// Telemetry channels of the exported attitude reference
+static const std::vector<telemetryChannel> attitudeReferenceChannels = {
+    { "roll_ref", "rad" }, { "pitch_ref", "rad" }, { "z_position_ref", "m" } };
+
+
 void PIDattitudeControl( dynamics& Drone, VectorXf& Reference, float finalTime )
 {
     /* Simulation loop */
@@ -15,7 +20,7 @@ void PIDattitudeControl( dynamics& Drone, VectorXf& Reference, float finalTime )
     // Data points
     float samplingTime = Drone.getdt( );
     float initTime = Drone.time;
-    int Nsim = (int) (finalTime-initTime)/samplingTime;
+    int Nsim = (int) round( (finalTime-initTime)/samplingTime );
 
     // Input, output signals and reference vector
     VectorXf u = VectorXf::Zero(3);
@@ -31,11 +36,26 @@ void PIDattitudeControl( dynamics& Drone, VectorXf& Reference, float finalTime )
 
     VectorXf ref(3); ref << -0.0872665, -0.0872665, -50;
     
-    // Data matrices
-    MatrixXf X(12,Nsim+1); X( seq(0,11),0 )=Drone.state;
-    MatrixXf U(6,Nsim+1); U( seq(0,1),0 )=u_serv; U( seq(2,2),0 )=u_prop; U(seq(3,5), 0) = VectorXf::Zero(3);
-    MatrixXf T(1,Nsim+1); T( 0,0 ) = initTime;
-    MatrixXf R(3,Nsim+1); R( seq(0,2),0 ) = ref;
+    // Telemetry, streamed to disk by a writer thread during the simulation
+    std::vector<telemetryChannel> attitudeStateChannels( stateChannels.begin(), stateChannels.begin() + 12 );
+
+    telemetryStream Log;
+    Log.addFile( "../data/state.tlm", attitudeStateChannels );
+    Log.addFile( "../data/ref.tlm", attitudeReferenceChannels );
+    Log.addFile( "../data/input.tlm", inputChannels );
+    Log.addFile( "../data/time.tlm", timeChannels );
+    Log.setLossless( true );                    // The GUI reads all records
+    Log.setLevelOfDetail( true );
+    Log.start( );
+
+    VectorXf record = VectorXf::Zero( Log.channels() );
+    Ref<VectorXf> X = record.segment( 0,12 ), R = record.segment( 12,3 ), U = record.segment( 15,6 ), T = record.segment( 21,1 );
+
+    X( seq(0,11) )=Drone.state;
+    U( seq(0,1) )=u_serv; U( seq(2,2) )=u_prop;
+    T( 0 ) = initTime;
+    R( seq(0,2) ) = ref;
+    Log.push( record );
     
     // Initialize actuators
     actuator Servos( 2,u_serv,samplingTime );
@@ -99,6 +119,12 @@ void PIDattitudeControl( dynamics& Drone, VectorXf& Reference, float finalTime )
     PID.init( y,ref,y_omega,initTime );
     PIDinner.init( y_omega(seq(0,1)),u,initTime );
 
+    // Progress, reported by a reporter thread
+    progressReporter Progress;
+    Progress.start( 1 );
+    progressCounter& Counter = Progress.counter( 0 );
+    Counter.totalSteps.store( Nsim, std::memory_order_relaxed );
+
     // Run closed-loop simulation
     for (int i=0; i<Nsim; ++i)
     {
@@ -134,291 +160,61 @@ void PIDattitudeControl( dynamics& Drone, VectorXf& Reference, float finalTime )
         }
 
         // Save data
-        X(seq(0, 11), i+1) = Drone.state;
-        R(seq(0,2), i+1) = ref;
-        U(seq(0, 2), i+1) = u;
-        U(seq(3,4), i+1) = Servos.controlRate;
-        U(seq(5,5), i+1) = Propellers.controlRate;
-        T(0, i+1) = (i+1)*samplingTime;
-
-        // Print status
-        if ((i+1)%50 == 0)
-        {
-            std::cout << "Atitude: " << Drone.state[8] << " Time: " << (i+1)*samplingTime << std::endl;
-            std::cout << "Closed-Loop simulation: iteration " << i+1 << " out of " << Nsim << std::endl;
-        }
+        X(seq(0, 11)) = Drone.state;
+        R(seq(0,2)) = ref;
+        U(seq(0, 2)) = u;
+        U(seq(3,4)) = Servos.controlRate;
+        U(seq(5,5)) = Propellers.controlRate;
+        T(0) = (i+1)*samplingTime;
+
+        Log.push( record );
 
+        Counter.steps.store( i+1, std::memory_order_relaxed );
     }
 
-    // Export data
-    saveToFile(X, X.rows(), X.cols(), "../data/state.csv");
-    saveToFile(R, R.rows(), R.cols(), "../data/ref.csv");
-    saveToFile(U, U.rows(), U.cols(), "../data/input.csv");
-    saveToFile(T, T.rows(), T.cols(), "../data/time.csv");
+    Counter.finished.store( true, std::memory_order_release );
+    Progress.stop( );
+
+    // Write remaining data
+    Log.close( );
 }
 
 
-void INDIpositionControl( dynamics& Drone, MatrixXf& Reference, float finalTime )
+VectorXf INDIpositionControl( dynamics& Drone, reference& Reference, float finalTime, std::string outputDirectory, bool flightRecording )
 {
-    /* Simulation loop */
-
-    // Data points
-    float samplingTime = Drone.getdt( );
-    float initTime = Drone.time;
-    int Nsim = (int) (finalTime-initTime)/samplingTime;
-
-    // Parameters, input, output and reference signals
-    VectorXf p(2); p << 1.75, -2*0.00377;                                // Mass and twice the force constant of one propeller
-
-    VectorXf u = VectorXf::Zero(3);
-    VectorXf u_serv(2); u_serv << 0.0, 0.0;
-    VectorXf u_prop(1); u_prop << 2276.856764;
-
-    VectorXf e(12);
-
-    VectorXf ySystem(18);
-    VectorXf y_position(3); y_position << Drone.state( seq( 6,8 ) );
-    VectorXf y_vel = VectorXf::Zero(3);
-    VectorXf y_acc = VectorXf::Zero(3);
-    VectorXf y_attitude(3); y_attitude << Drone.state( seq( 0,2 ) );
-    VectorXf y_omega(3); y_omega << Drone.state( seq( 3,5 ) );
-
-    VectorXf ref_pos = VectorXf::Zero(3); // ref_pos << 1.0, 1.0, -1.0;
-    VectorXf ref_vel = VectorXf::Zero(3);
-    VectorXf ref_acc = VectorXf::Zero(3); 
-    VectorXf ref_attitude = VectorXf::Zero(2);
-    VectorXf ref_omega = VectorXf::Zero(2);
-
-    // Data matrices
-    MatrixXf X(18,Nsim+1); X( seq(0,11),0 )=Drone.state;
-    MatrixXf E(12,Nsim+1); X( seq(0,11),0 )=e;
-    MatrixXf U(6,Nsim+1); U( seq(0,1),0 )=u_serv; U( seq(2,2),0 )=u_prop; U(seq(3,5), 0) = VectorXf::Zero(3);
-    MatrixXf T(1,Nsim+1); T( 0,0 ) = initTime;
-    MatrixXf R(13,Nsim+1); R( seq(0,1),0 ) = ref_omega; R( seq(2,3),0 ) = ref_attitude; R( seq(4,6),0 ) = ref_acc; R( seq(7,9),0 ) = ref_vel; R( seq(10,12),0 ) = ref_pos; 
-    
-    // Define controller
-    PIDcontroller PIDpos( 3,3,samplingTime, 10 );
-    PIDcontroller PIDvel( 3,3,samplingTime, 10 );
-    INDIcontroller INDI( 3,3,samplingTime );
-    PIDcontroller PID( 2,2,samplingTime, 10 );
-    PIDcontroller PIDinner( 2,2,samplingTime, 10 );
-
-    VectorXf pGainsInner( 2 );
-	pGainsInner(0) = -1.0;
-	pGainsInner(1) = -1.0;
-
-	VectorXf iGainsInner( 2 );
-	iGainsInner(0) = -0.0;
-	iGainsInner(1) = -0.0;
-
-	VectorXf dGainsInner( 2 );
-	dGainsInner(0) = -0.0;
-	dGainsInner(1) = -0.0;
-
-    PIDinner.setProportionalGains( pGainsInner );
-    PIDinner.setIntegralGains( iGainsInner );
-    PIDinner.setDerivativeGains( dGainsInner );
-
-    VectorXf pGains( 2 );
-	pGains(0) = 3.0;
-	pGains(1) = 3.0;
-
-	VectorXf iGains( 2 );
-	iGains(0) = 1.0;
-	iGains(1) = 1.0;
-
-	VectorXf dGains( 2 );
-	dGains(0) = 0.0;
-	dGains(1) = 0.0;
-
-    PID.setProportionalGains( pGains );
-    PID.setIntegralGains( iGains );
-    PID.setDerivativeGains( dGains );
-
-    // PID.setLowerControlLimit( -1,-0.261799 );        // Max rotational velocity: +-15 deg/s
-    // PID.setUpperControlLimit( -1, 0.261799 );
-
-    // PID.setLowerRateLimit( -1,-0.0873 );       // Max rotational acceleration: +-5 deg/s2
-    // PID.setUpperRateLimit( -1, 0.0873 );
-
-    VectorXf pGainsVel( 3 );
-	pGainsVel(0) = 2.5;
-	pGainsVel(1) = 2.5;
-	pGainsVel(2) = 2.5;
-
-    VectorXf dGainsVel( 3 );
-	dGainsVel(0) = 0.0;
-	dGainsVel(1) = 0.0;
-	dGainsVel(2) = 0.0;
-
-    VectorXf iGainsVel( 3 );
-	iGainsVel(0) = 1.0;
-	iGainsVel(1) = 1.0;
-	iGainsVel(2) = 1.0;
+    // Nominal scenario starting from the state of the drone
+    scenario Scenario;
+    Scenario.initialState = Drone.state;
+    Scenario.initialTime = Drone.time;
+    Scenario.samplingTime = Drone.getdt( );
+    Scenario.finalTime = finalTime;
+    Scenario.outputDirectory = outputDirectory;
+    Scenario.recorder = flightRecording;
 
-    PIDvel.setProportionalGains( pGainsVel );
-    PIDvel.setDerivativeGains( dGainsVel );
-    PIDvel.setIntegralGains( iGainsVel );
+    progressReporter Progress;
+    Progress.start( 1 );
 
-    // PIDvel.setLowerControlLimit( -1,-0.3 );        // Max acceleration: +-0.3 m/s
-    // PIDvel.setUpperControlLimit( -1, 0.3 );
+    // Single run for the GUI, which reads all records
+    simulation Simulation( Scenario, Reference );
+    Simulation.setLosslessTelemetry( true );
+    Simulation.setProgress( &Progress.counter( 0 ) );
 
-    // PIDvel.setLowerRateLimit( -1,-0.05 );          // Max time derivative of acceleration: +-0.05 m/s2
-    // PIDvel.setUpperRateLimit( -1, 0.05 );
+    // The final report precedes the summary printed by run
+    while ( Simulation.step( ) );
+    Progress.stop( );
 
-    VectorXf pGainsPos( 3 );
-	pGainsPos(0) = 0.7;
-	pGainsPos(1) = 0.7;
-	pGainsPos(2) = 1.0;
+    VectorXf metrics = Simulation.run( );
 
-    VectorXf dGainsPos( 3 );
-	dGainsPos(0) = 0.0;
-	dGainsPos(1) = 0.0;
-	dGainsPos(2) = 0.0;
-
-    VectorXf iGainsPos( 3 );
-	iGainsPos(0) = 0.5;
-	iGainsPos(1) = 0.5;
-	iGainsPos(2) = 0.5;
-
-    PIDpos.setProportionalGains( pGainsPos );
-    PIDpos.setDerivativeGains( dGainsPos );
-    PIDpos.setIntegralGains( iGainsPos );
-
-    // PIDpos.setLowerControlLimit( -1,-1.0 );        // Max velocity: +-5 m/s
-    // PIDpos.setUpperControlLimit( -1, 1.0);
-
-    // PIDpos.setLowerRateLimit( -1,-1.0 );           // Max acceleration: +-0.1 m/s2
-    // PIDpos.setUpperRateLimit( -1, 1.0 );
-
-    // Define and initialize actuators
-    actuator Servos( 2,u_serv,samplingTime );
-    
-    // Servos.setLowerControlLimit( -1,-0.261799 );        // Max gimbal angle
-    // Servos.setUpperControlLimit( -1, 0.261799 );        // deflections: +-15 deg
+    Drone = Simulation.vehicle( );
 
-    // Servos.setLowerRateLimit( -1,-0.261799 );           // Max gimbal deflection
-    // Servos.setUpperRateLimit( -1, 0.261799 );           // rateL +-15 deg/s
-
-    actuator Propellers( 1,u_prop,samplingTime );
-
-    // Propellers.setLowerControlLimit( 0,-3952.12 );      // Max propeller rotational
-    // Propellers.setUpperControlLimit( 0, 3952.12 );      // acceleration: +-3952.12 rad/s
-
-    // Propellers.setLowerRateLimit( 0,-100.0 );         // Max propeller rotational
-    // Propellers.setUpperRateLimit( 0, 100.0 );         // acceleration: +-1976.06 rad/s2
-
-    actuator Attitude( 2,y_attitude(seq(0,1)),samplingTime );
-    
-    // Attitude.setLowerControlLimit( -1,-2.61799 );        // Max attitude angle: +-15 deg
-    // Attitude.setUpperControlLimit( -1, 2.61799 );
-
-    // Attitude.setLowerRateLimit( -1,-0.05 );       // Max rotational velocity: +-0.15 deg/s
-    // Attitude.setUpperRateLimit( -1, 0.05 );        
-
-    // Define sensors
-    IMUsensor BNO055;
-
-    // Define estimators
-    estimator Estimator( Drone.state, initTime, samplingTime );
-
-    // Initialize controllers
-    PIDpos.init( y_position,y_vel,initTime );
-    PIDvel.init( y_vel,y_acc,ref_vel,initTime );
-    PID.init( y_attitude(seq(0,1)),y_omega,ref_attitude,initTime );
-    PIDinner.init( y_omega(seq(0,1)),u,ref_omega,initTime );
-
-    // Initialize estimators
-    Estimator.init();
-
-    // Run closed-loop simulation
-    for (int i=0; i<Nsim; ++i)
-    {
-        // Drone has not hit ground
-        if (Drone.state[8] <= 0.0)
-        {
-            /* Guidance and  */
-            ref_pos = Reference.col(i);
-
-
-            /* Control Software */
-            PIDpos.step( Drone.time,y_position,ref_pos );
-            PIDpos.getU( ref_vel );
-
-            PIDvel.step( Drone.time,y_vel,ref_vel );
-            PIDvel.getU( ref_acc );
-
-            y_acc = BFRtoNED( y_attitude,y_acc );
-            INDI.computeControlEffectiveness( y_attitude,u_serv,u_prop,p );
-            INDI.step( Drone.time, y_acc, ref_acc );
-            INDI.getU( u );
-
-            ref_attitude << u( seq(0,1) );
-            Attitude.actuate( ref_attitude );
-            u_prop = u( seq(2,2) );
-
-            PID.step( Drone.time,y_attitude( seq(0,1) ),ref_attitude );
-            PID.getU( ref_omega );
-
-            PIDinner.step( Drone.time,y_omega( seq(0,1) ),ref_omega );
-            PIDinner.getU( u_serv );
-
-
-            /* Physical System */
-            // Actuator            
-            Servos.actuate( u_serv );
-            Propellers.actuate( u_prop );
-
-            u << u_serv, u_prop;
-
-            // System
-            Drone.step( u,ySystem );
-
-            // Sensor
-            BNO055.processOutput( ySystem );
-            
-            BNO055.AngularVel( y_omega );
-            BNO055.EulerAngles( y_attitude );
-            BNO055.Acceleration( y_acc );   
-            BNO055.PositionVec( y_position );
-            y_vel = Drone.earthVel;
-
-            /* Navigation Software */
-            Estimator.estimateState( u, ySystem, e );
-        }
-
-        // Save data
-        X(seq(0, 11), i+1) = Drone.state;
-        X(seq(12, 14), i+1) = y_vel;
-        X(seq(15, 17), i+1) = y_acc;
-
-        R(seq(0,1), i+1) = ref_omega;
-        R(seq(2,3), i+1) = ref_attitude;
-        R(seq(4,6), i+1) = ref_acc;
-        R(seq(7,9), i+1) = ref_vel;
-        R(seq(10,12), i+1) = PIDpos.yRef;
-
-        U(seq(0, 2), i+1) = u;
-        U(seq(3,4), i+1) = Servos.controlRate;
-        U(seq(5,5), i+1) = Propellers.controlRate;
-
-        E(seq(0, 11), i+1) = e;
-
-        T(0, i+1) = (i+1)*samplingTime;
+    return metrics;
+}
 
-        // Print status
-        if ((i+1)%50 == 0)
-        {
-            std::cout << "Altitude: " << Drone.state[8] << " Time: " << (i+1)*samplingTime << std::endl;
-            std::cout << "Closed-Loop simulation: iteration " << i+1 << " out of " << Nsim << std::endl;
-        }
 
-    }
+VectorXf INDIpositionControl( dynamics& Drone, MatrixXf& Reference, float finalTime, std::string outputDirectory, bool flightRecording )
+{
+    // One sample per sampling time, held without feedforward
+    sampledReference Sampled( Reference, Drone.getdt( ), Drone.time, ZERO_ORDER_HOLD );
 
-    // Export data
-    saveToFile(X, X.rows(), X.cols(), "../data/state.csv");
-    saveToFile(E, E.rows(), E.cols(), "../data/estimate.csv");
-    saveToFile(R, R.rows(), R.cols(), "../data/ref.csv");
-    saveToFile(U, U.rows(), U.cols(), "../data/input.csv");
-    saveToFile(T, T.rows(), T.cols(), "../data/time.csv");
+    return INDIpositionControl( Drone, Sampled, finalTime, outputDirectory, flightRecording );
 }
\ No newline at end of file
@@ -22,10 +22,31 @@ void PIDattitudeControl( dynamics& dynamics, VectorXf& Reference, float finalTim
 
 
 /**
- * @brief Perform position control on the drone
+ * @brief Perform position control on the drone. The reference position is evaluated at the
+ *        time of each iteration, its velocity and acceleration are fed forward to the
+ *        velocity and INDI acceleration loops.
  * 
  * @param[in] DroneDynamics     Object containing the drone dynamics
- * @param[in] RefPosition       Reference drone position
+ * @param[in] Reference         Reference position, e.g. a minimum-snap or sampled trajectory
  * @param[in] finalTime         Simulation time
+ * @param[in] outputDirectory   Directory to which the telemetry files are written
+ * @param[in] flightRecording   Write flight recorder files instead of full-rate telemetry files
+ * 
+ * \return summary metrics: maximum tilt [deg], maximum and RMS position error [m] and mean NEES
+ */
+VectorXf INDIpositionControl( dynamics& Drone, reference& Reference, float finalTime, std::string outputDirectory = "../data", bool flightRecording = false );
+
+
+/**
+ * @brief Perform position control on the drone with a reference position sampled at the
+ *        sampling time, the last sample is held after the end of the reference
+ * 
+ * @param[in] DroneDynamics     Object containing the drone dynamics
+ * @param[in] RefPosition       Reference drone position, one column per sampling time
+ * @param[in] finalTime         Simulation time
+ * @param[in] outputDirectory   Directory to which the telemetry files are written
+ * @param[in] flightRecording   Write flight recorder files instead of full-rate telemetry files
+ * 
+ * \return summary metrics: maximum tilt [deg], maximum and RMS position error [m] and mean NEES
  */
-void INDIpositionControl( dynamics& Drone, MatrixXf& Reference, float finalTime );
+VectorXf INDIpositionControl( dynamics& Drone, MatrixXf& Reference, float finalTime, std::string outputDirectory = "../data", bool flightRecording = false );
@@ -12,7 +12,6 @@ setup(
     install_requires=['numpy',
                       'PyQt5',
                       'matplotlib',
-                      'pandas',
                       'pyrr',
                       'PyOpenGL',
                       'pywin32-ctypes'],
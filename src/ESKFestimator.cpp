@@ -0,0 +1,301 @@
+/**
+ *	\file src/ESKFestimator.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+ESKFestimator::ESKFestimator(  ) : estimator(  )
+{
+    position.setZero();
+    velocity.setZero();
+    attitude.setIdentity();
+    accelBias.setZero();
+    gyroBias.setZero();
+    lastGyro.setZero();
+
+    errorCovariance.setZero();
+}
+
+
+ESKFestimator::ESKFestimator( VectorXf& _initEstimate, float _initTime, float _samplingTime ) : estimator( _initEstimate, _initTime, _samplingTime )
+{
+    attitude = eulerToQuaternion( _initEstimate.head<3>() );
+    position = _initEstimate( seq( 6,8 ) );
+    velocity = attitude.toRotationMatrix()*Vector3f( _initEstimate( seq( 9,11 ) ) );
+    accelBias.setZero();
+    gyroBias.setZero();
+    lastGyro = _initEstimate( seq( 3,5 ) );
+
+    Matrix<float,15,1> initStd;
+    initStd << 0.5, 0.5, 0.5, 0.2, 0.2, 0.2, 0.05, 0.05, 0.05, 0.1, 0.1, 0.1, 0.01, 0.01, 0.01;
+    errorCovariance = initStd.array().square().matrix().asDiagonal();
+}
+
+
+ESKFestimator::ESKFestimator( const ESKFestimator& rhs ) : estimator( rhs )
+{
+    errorCovariance = rhs.errorCovariance;
+
+    position = rhs.position;
+    velocity = rhs.velocity;
+    attitude = rhs.attitude;
+    accelBias = rhs.accelBias;
+    gyroBias = rhs.gyroBias;
+    lastGyro = rhs.lastGyro;
+
+    accelNoise = rhs.accelNoise;
+    gyroNoise = rhs.gyroNoise;
+    accelBiasWalk = rhs.accelBiasWalk;
+    gyroBiasWalk = rhs.gyroBiasWalk;
+}
+
+
+ESKFestimator::~ESKFestimator(  ) {}
+
+
+void ESKFestimator::estimateState( VectorXf& /* _u */, VectorXf& _y, VectorXf& _x )
+{
+    // Measured IMU signals: body rates and accelerometer specific force
+    Vector3f gyro = _y( seq( 3,5 ) );
+    Vector3f specificForce = _y( seq( 6,8 ) );
+
+    /* Prediction Step */
+    propagate( gyro, specificForce );
+    lastGyro = gyro;
+    time = time + samplingTime;
+
+    /* Update Step */
+    measurement imu;
+    imu.sampleTime = time;
+    imu.arrivalTime = time;
+    imu.type = IMU_MEASUREMENT;
+    imu.size = 6;
+    imu.value = _y( seq( 0,5 ) );
+
+    update( imu );
+
+    nominalToState( );
+    _x = stateEstimate;
+}
+
+
+void ESKFestimator::update( const measurement& _measurement )
+{
+    const float eps = 1e-3;
+
+    Matrix<float,15,1> dx = Matrix<float,15,1>::Zero();
+    Matrix<float,6,1> z0, z1;
+
+    int nz = errorMeasurementModel( _measurement.type, dx, z0 );
+
+    if ( nz > _measurement.size )
+        throw std::invalid_argument("Incorrect number of measurement channels given to estimator");
+
+    // Measurement Jacobian w.r.t. error state (forward differences)
+    Matrix<float,Dynamic,15,0,6,15> H( nz,15 );
+
+    for ( int j=0; j<15; ++j )
+    {
+        dx(j) = eps;
+        errorMeasurementModel( _measurement.type, dx, z1 );
+        H.col(j) = ( z1.head(nz) - z0.head(nz) ) / eps;
+        dx(j) = 0;
+    }
+
+    // Innovation, Euler angles are wrapped to [-pi,pi]
+    Matrix<float,Dynamic,1,0,6,1> innovation = _measurement.value.head(nz) - z0.head(nz);
+
+    if ( _measurement.type == IMU_MEASUREMENT )
+        for ( int i=0; i<3; ++i )
+            innovation(i) = remainder( innovation(i), 2*M_PI );
+
+    Matrix<float,Dynamic,Dynamic,0,6,6> R = measurementNoise[_measurement.type].head(nz).array().square().matrix().asDiagonal();
+
+    // Kalman gain and Joseph-form covariance update
+    Matrix<float,Dynamic,Dynamic,0,6,6> S = H*errorCovariance*H.transpose() + R;
+    Matrix<float,15,Dynamic,0,15,6> K = S.llt().solve( H*errorCovariance ).transpose();
+    Matrix<float,15,15> IKH = Matrix<float,15,15>::Identity() - K*H;
+
+    dx = K*innovation;
+    errorCovariance = IKH*errorCovariance*IKH.transpose() + K*R*K.transpose();
+
+    // Inject error into nominal state
+    Vector3f dtheta = dx.segment<3>(6);
+
+    position += dx.segment<3>(0);
+    velocity += dx.segment<3>(3);
+    attitude = ( attitude*rotationVectorToQuaternion( dtheta ) ).normalized();
+    accelBias += dx.segment<3>(9);
+    gyroBias += dx.segment<3>(12);
+
+    // Reset error state, attitude error is now expressed around the new nominal attitude
+    Matrix<float,15,15> G = Matrix<float,15,15>::Identity();
+    G.block<3,3>(6,6) -= skew( 0.5*dtheta );
+
+    errorCovariance = G*errorCovariance*G.transpose();
+
+    nominalToState( );
+}
+
+
+void ESKFestimator::setUpdateMethod( updateMethod _method )
+{
+    if ( _method != JOSEPH_UPDATE )
+        throw std::invalid_argument("Error-state estimator only supports the Joseph-form update");
+}
+
+
+float ESKFestimator::NEES( const VectorXf& _trueState )
+{
+    Quaternionf trueAttitude = eulerToQuaternion( _trueState.head<3>() );
+
+    // Attitude error as rotation vector of q_nominal^-1 * q_true
+    Quaternionf dq = attitude.conjugate()*trueAttitude;
+    if ( dq.w() < 0 )
+        dq.coeffs() *= -1;
+
+    Matrix<float,9,1> error;
+    error.segment<3>(0) = Vector3f( _trueState( seq( 6,8 ) ) ) - position;
+    error.segment<3>(3) = trueAttitude.toRotationMatrix()*Vector3f( _trueState( seq( 9,11 ) ) ) - velocity;
+    error.segment<3>(6) = 2*dq.vec();
+
+    Matrix<float,9,9> P = errorCovariance.topLeftCorner<9,9>();
+
+    return error.dot( P.llt().solve( error ) );
+}
+
+
+void ESKFestimator::save( snapshot& _snapshot ) const
+{
+    estimator::save( _snapshot );
+
+    _snapshot.write( position );
+    _snapshot.write( velocity );
+    _snapshot.write( attitude );
+    _snapshot.write( accelBias );
+    _snapshot.write( gyroBias );
+    _snapshot.write( lastGyro );
+    _snapshot.write( errorCovariance );
+}
+
+
+void ESKFestimator::restore( snapshot& _snapshot )
+{
+    estimator::restore( _snapshot );
+
+    _snapshot.read( position );
+    _snapshot.read( velocity );
+    _snapshot.read( attitude );
+    _snapshot.read( accelBias );
+    _snapshot.read( gyroBias );
+    _snapshot.read( lastGyro );
+    _snapshot.read( errorCovariance );
+}
+
+
+void ESKFestimator::setIMUNoise( float _accelNoise, float _gyroNoise, float _accelBiasWalk, float _gyroBiasWalk )
+{
+    accelNoise = _accelNoise;
+    gyroNoise = _gyroNoise;
+    accelBiasWalk = _accelBiasWalk;
+    gyroBiasWalk = _gyroBiasWalk;
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void ESKFestimator::propagate( const Vector3f& _gyro, const Vector3f& _specificForce )
+{
+    float dt = samplingTime;
+
+    Matrix3f R = attitude.toRotationMatrix();
+    Vector3f f = _specificForce - accelBias;
+    Vector3f w = _gyro - gyroBias;
+    Vector3f g( 0.0, 0.0, 9.81 );
+
+    Quaternionf dq = rotationVectorToQuaternion( w*dt );
+
+    // Nominal state
+    Vector3f a = R*f + g;
+
+    position += velocity*dt + 0.5*a*dt*dt;
+    velocity += a*dt;
+    attitude = ( attitude*dq ).normalized();
+
+    // Error state transition matrix
+    Matrix<float,15,15> Fx = Matrix<float,15,15>::Identity();
+    Fx.block<3,3>(0,3) = Matrix3f::Identity()*dt;
+    Fx.block<3,3>(3,6) = -R*skew( f )*dt;
+    Fx.block<3,3>(3,9) = -R*dt;
+    Fx.block<3,3>(6,6) = dq.toRotationMatrix().transpose();
+    Fx.block<3,3>(6,12) = -Matrix3f::Identity()*dt;
+
+    // Discrete process noise from noise densities
+    Matrix<float,15,1> q;
+    q << Vector3f::Zero(),
+         Vector3f::Constant( accelNoise*accelNoise*dt ),
+         Vector3f::Constant( gyroNoise*gyroNoise*dt ),
+         Vector3f::Constant( accelBiasWalk*accelBiasWalk*dt ),
+         Vector3f::Constant( gyroBiasWalk*gyroBiasWalk*dt );
+
+    errorCovariance = Fx*errorCovariance*Fx.transpose();
+    errorCovariance.diagonal() += q;
+    errorCovariance = 0.5*( errorCovariance + errorCovariance.transpose() );
+}
+
+
+int ESKFestimator::errorMeasurementModel( measurementType _type, const Matrix<float,15,1>& _dx, Matrix<float,6,1>& _z )
+{
+    Vector3f p = position + _dx.segment<3>(0);
+    Vector3f v = velocity + _dx.segment<3>(3);
+    Matrix3f R = ( attitude*rotationVectorToQuaternion( _dx.segment<3>(6) ) ).toRotationMatrix();
+
+    switch ( _type )
+    {
+        case IMU_MEASUREMENT:
+            _z.head(3) = dcmToEuler( R );
+            return 3;
+
+        case POSITION_MEASUREMENT:
+            _z.head(3) = p;
+            return 3;
+
+        case BARO_MEASUREMENT:
+            _z(0) = -p(2);
+            return 1;
+
+        case GPS_MEASUREMENT:
+            _z.head(3) = p;
+            _z.tail(3) = v;
+            return 6;
+
+        case MAG_MEASUREMENT:
+            _z.head(3) = R.transpose()*magField;
+            return 3;
+
+        default:
+            throw std::invalid_argument("Unknown measurement type given to estimator");
+    }
+}
+
+
+void ESKFestimator::nominalToState(  )
+{
+    Matrix3f R = attitude.toRotationMatrix();
+
+    stateEstimate( seq( 0,2 ) ) = dcmToEuler( R );
+    stateEstimate( seq( 3,5 ) ) = lastGyro - gyroBias;
+    stateEstimate( seq( 6,8 ) ) = position;
+    stateEstimate( seq( 9,11 ) ) = R.transpose()*velocity;
+}
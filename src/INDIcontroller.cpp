@@ -43,8 +43,37 @@ INDIcontroller::INDIcontroller( const INDIcontroller& rhs ) : controller( rhs )
 }
 
 
+INDIcontroller& INDIcontroller::operator=( const INDIcontroller& rhs )
+{
+	controller::operator=( rhs );
+
+	currentInput = rhs.currentInput;
+    controlEffectiveness = rhs.controlEffectiveness;
+
+	return *this;
+}
+
+
 INDIcontroller::~INDIcontroller(  ){}
 
+
+void INDIcontroller::save( snapshot& _snapshot ) const
+{
+    controller::save( _snapshot );
+
+    _snapshot.write( currentInput );
+    _snapshot.write( controlEffectiveness );
+}
+
+
+void INDIcontroller::restore( snapshot& _snapshot )
+{
+    controller::restore( _snapshot );
+
+    _snapshot.read( currentInput );
+    _snapshot.read( controlEffectiveness );
+}
+
 //
 // PRIVATE MEMBER FUNCTIONS:
 //
@@ -54,7 +83,7 @@ void INDIcontroller::computeControlEffectiveness( VectorXf& currentAttitude, Vec
     Matrix3f temp;
 
     float theta1 = currentGimbal(0); float theta2 = currentGimbal(1);
-    float phi = currentAttitude(0); float theta = currentAttitude(1); float psi = currentAttitude(2);
+    float phi = currentAttitude(0); float theta = currentAttitude(1);
     float m = parameters(0); float kf = parameters(1);
     
     VectorXf gimbalTransformation(3);
@@ -62,21 +91,12 @@ void INDIcontroller::computeControlEffectiveness( VectorXf& currentAttitude, Vec
     gimbalTransformation(1) = -sin(theta1)*cos(theta2);
     gimbalTransformation(2) = cos(theta1)*cos(theta2);
 
-    Matrix3f bodyTransfomationPhi;
-    bodyTransfomationPhi << 0, sin(psi)*sin(phi)+cos(psi)*sin(theta)*cos(phi), sin(psi)*cos(phi)-cos(psi)*sin(theta)*sin(phi),
-                            0, -cos(psi)*sin(phi)+sin(psi)*sin(theta)*cos(phi), -cos(psi)*cos(phi)-sin(psi)*sin(theta)*sin(phi),
-                            0, cos(theta)*cos(phi), -cos(theta)*sin(phi);
-
-    Matrix3f bodyTransfomationTheta;
-    bodyTransfomationTheta <<   -cos(psi)*sin(theta), cos(psi)*cos(theta)*sin(phi), cos(psi)*cos(theta)*cos(phi),
-                                -sin(psi)*sin(theta), sin(psi)*cos(theta)*sin(phi), sin(psi)*cos(theta)*cos(phi),
-                                -cos(theta), -sin(theta)*sin(phi), -sin(theta)*cos(phi);
-
+    // Body to NED rotation and its derivatives with respect to roll and pitch, sharing the trigonometric terms
+    eulerTrig t = eulerTrigonometry( currentAttitude.head<3>() );
 
-    Matrix3f bodyTransfomation;
-    bodyTransfomation <<    cos(psi)*cos(theta), -sin(psi)*cos(phi)+cos(psi)*sin(theta)*sin(phi), sin(psi)*sin(phi)+cos(psi)*sin(theta)*cos(phi),
-                            sin(psi)*cos(theta), cos(psi)*cos(phi)+sin(psi)*sin(theta)*sin(phi), -cos(psi)*sin(phi)+sin(psi)*sin(theta)*cos(phi),
-                            -sin(theta), cos(theta)*sin(phi), cos(theta)*cos(phi);
+    Matrix3f bodyTransfomation = eulerToDCM( t );
+    Matrix3f bodyTransfomationPhi, bodyTransfomationTheta;
+    eulerToDCMPartials( t, bodyTransfomationPhi, bodyTransfomationTheta );
 
     temp( seq(0,2),0 ) = bodyTransfomationPhi*gimbalTransformation*currentOmega(0);
     temp( seq(0,2),1 ) = bodyTransfomationTheta*gimbalTransformation*currentOmega(0);
@@ -0,0 +1,443 @@
+/**
+ *	\file src/PFestimator.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+PFestimator::PFestimator(  ) : estimator(  )
+{
+    pool = std::make_unique<threadPool>( 1 );
+    stateEstimate = VectorXf::Zero( nx );
+
+    init( );
+}
+
+
+PFestimator::PFestimator( VectorXf& _initEstimate, float _initTime, float _samplingTime, int _nParticles, unsigned int _nThreads ) : estimator( _initEstimate, _initTime, _samplingTime )
+{
+    if ( _nParticles < 2 )
+        throw std::invalid_argument("Particle filter requires at least two particles");
+
+    nParticles = _nParticles;
+    pool = std::make_unique<threadPool>( _nThreads );
+
+    init( );
+}
+
+
+PFestimator::PFestimator( const PFestimator& rhs ) : estimator( rhs )
+{
+    effectiveSampleSize = rhs.effectiveSampleSize;
+
+    nParticles = rhs.nParticles;
+    nBlocks = rhs.nBlocks;
+    resampleThreshold = rhs.resampleThreshold;
+    seed = rhs.seed;
+    run = rhs.run;
+
+    particles = rhs.particles;
+    resampled = rhs.resampled;
+    logWeights = rhs.logWeights;
+    logLikelihood = rhs.logLikelihood;
+    weights = rhs.weights;
+
+    streams = rhs.streams;
+    pool = std::make_unique<threadPool>( rhs.pool->size() );
+}
+
+
+PFestimator::~PFestimator(  ) {}
+
+
+void PFestimator::init(  )
+{
+    estimator::init( );
+
+    nBlocks = ( nParticles + blockSize - 1 )/blockSize;
+
+    streams.clear();
+    for ( int b=0; b<nBlocks; ++b )
+        streams.emplace_back( seed, run, PARTICLE_STREAM + b );
+
+    particles.resize( 12,nParticles );
+    resampled.resize( 12,nParticles );
+    logWeights = VectorXf::Zero( nParticles );
+    logLikelihood = VectorXf::Zero( nParticles );
+    weights = VectorXf::Constant( nParticles, 1.0/nParticles );
+    effectiveSampleSize = nParticles;
+
+    // Particles drawn from the initial estimate and its covariance
+    Matrix<float,12,12> L = initCovariance.llt().matrixL();
+    Matrix<float,12,1> x = stateEstimate;
+
+    pool->parallelFor( nBlocks, [&]( int _begin, int _end )
+    {
+        for ( int b=_begin; b<_end; ++b )
+        {
+            int begin = b*blockSize;
+            int length = std::min( blockSize, nParticles - begin );
+
+            stateBatch noise( 12,length );
+            streams[b].normal( Map<VectorXf>( noise.data(), noise.size() ) );
+
+            particles.middleCols( begin,length ) = ( L*noise ).colwise() + x;
+        }
+    } );
+}
+
+
+void PFestimator::estimateState( VectorXf& _u, VectorXf& _y, VectorXf& _x )
+{
+    /* Prediction Step */
+    Vector3f u = _u.head(3);
+    Array<float,12,1> noiseStd = ( processNoise.diagonal()*samplingTime ).array().sqrt();
+
+    pool->parallelFor( nBlocks, [&]( int _begin, int _end )
+    {
+        for ( int b=_begin; b<_end; ++b )
+        {
+            int begin = b*blockSize;
+            int length = std::min( blockSize, nParticles - begin );
+
+            propagateBatch( particles.middleCols( begin,length ), u );
+
+            stateBatch noise( 12,length );
+            streams[b].normal( Map<VectorXf>( noise.data(), noise.size() ) );
+            particles.middleCols( begin,length ) += noiseStd.matrix().asDiagonal()*noise;
+        }
+    } );
+
+    time = time + samplingTime;
+
+    /* Update Step */
+    measurement imu;
+    imu.sampleTime = time;
+    imu.arrivalTime = time;
+    imu.type = IMU_MEASUREMENT;
+    imu.size = 6;
+    imu.value = _y( seq( 0,5 ) );
+
+    update( imu );
+
+    _x = stateEstimate;
+}
+
+
+void PFestimator::update( const measurement& _measurement )
+{
+    Matrix<float,12,1> x = stateEstimate;
+    Matrix<float,6,1> z;
+
+    int nz = measurementModel( _measurement.type, x, z );
+
+    if ( nz != _measurement.size )
+        throw std::invalid_argument("Incorrect number of measurement channels given to estimator");
+
+    // Progressive correction: a likelihood that is sharp compared to the particle spread is
+    // applied in tempered stages, with resampling in between, so that particles move towards
+    // the measurement instead of collapsing onto a few ancestors
+    float remaining = 1.0;
+
+    for ( int stage=0; remaining > 0; ++stage )
+    {
+        calculateLogLikelihood( _measurement, nz );
+
+        float fraction = remaining;
+
+        if ( stage < maxStages-1 && effectiveSamples( remaining ) < resampleThreshold*nParticles )
+        {
+            // Largest fraction of the remaining likelihood that keeps enough effective particles,
+            // searched on a logarithmic scale since the first stages can require tiny fractions
+            float lower = 1e-6*remaining;
+            float upper = remaining;
+
+            for ( int k=0; k<16; ++k )
+            {
+                float middle = sqrt( lower*upper );
+
+                if ( effectiveSamples( middle ) < resampleThreshold*nParticles )
+                    upper = middle;
+                else
+                    lower = middle;
+            }
+
+            fraction = lower;
+        }
+
+        logWeights += fraction*logLikelihood;
+        remaining -= fraction;
+
+        // Normalize weights, the largest log-weight is subtracted to avoid underflow
+        weights = ( logWeights.array() - logWeights.maxCoeff() ).exp();
+        weights /= weights.sum();
+        logWeights = weights.array().log();
+
+        effectiveSampleSize = 1.0/weights.squaredNorm();
+
+        if ( effectiveSampleSize < resampleThreshold*nParticles || remaining > 0 )
+        {
+            calculateEstimate( );
+            resample( );
+        }
+    }
+
+    calculateEstimate( );
+}
+
+
+void PFestimator::setUpdateMethod( updateMethod _method )
+{
+    if ( _method != JOSEPH_UPDATE )
+        throw std::invalid_argument("Particle filter does not support covariance update methods");
+}
+
+
+void PFestimator::setResampleThreshold( float _threshold )
+{
+    if ( _threshold < 0 || _threshold > 1 )
+        throw std::invalid_argument("Resampling threshold must be between zero and one");
+
+    resampleThreshold = _threshold;
+}
+
+
+void PFestimator::setSeed( unsigned long _seed, unsigned long _run )
+{
+    seed = _seed;
+    run = _run;
+    init( );
+}
+
+
+void PFestimator::save( snapshot& _snapshot ) const
+{
+    estimator::save( _snapshot );
+
+    _snapshot.write( particles );
+    _snapshot.write( logWeights );
+    _snapshot.write( weights );
+    _snapshot.write( effectiveSampleSize );
+
+    for ( const randomStream& stream : streams )
+        stream.save( _snapshot );
+}
+
+
+void PFestimator::restore( snapshot& _snapshot )
+{
+    estimator::restore( _snapshot );
+
+    stateBatch restored;
+    _snapshot.read( restored );
+
+    if ( restored.cols() != nParticles )
+        throw std::invalid_argument("Snapshot does not match the number of particles");
+
+    particles = restored;
+    _snapshot.read( logWeights );
+    _snapshot.read( weights );
+    _snapshot.read( effectiveSampleSize );
+
+    for ( randomStream& stream : streams )
+        stream.restore( _snapshot );
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+int PFestimator::measurementModelBatch( measurementType _type, const constStateBatchRef& _X, Matrix<float,6,Dynamic,RowMajor>& _Z )
+{
+    switch ( _type )
+    {
+        case IMU_MEASUREMENT:
+            _Z = _X.topRows(6);
+            return 6;
+
+        case POSITION_MEASUREMENT:
+            _Z.topRows(3) = _X.middleRows(6,3);
+            return 3;
+
+        case BARO_MEASUREMENT:
+            _Z.row(0) = -_X.row(8);
+            return 1;
+
+        case GPS_MEASUREMENT:
+        case MAG_MEASUREMENT:
+        {
+            eulerTrigBatch trig;
+            eulerTrigonometry( _X.topRows(3), trig );
+
+            dcmBatch Mnb;
+            eulerToDCM( trig, Mnb );
+
+            if ( _type == MAG_MEASUREMENT )
+            {
+                // Transpose of body to NED rotation applied to earth magnetic field
+                _Z.row(0) = Mnb.row(0)*magField(0) + Mnb.row(3)*magField(1) + Mnb.row(6)*magField(2);
+                _Z.row(1) = Mnb.row(1)*magField(0) + Mnb.row(4)*magField(1) + Mnb.row(7)*magField(2);
+                _Z.row(2) = Mnb.row(2)*magField(0) + Mnb.row(5)*magField(1) + Mnb.row(8)*magField(2);
+                return 3;
+            }
+
+            auto u = _X.row(9).array(); auto v = _X.row(10).array(); auto w = _X.row(11).array();
+
+            _Z.topRows(3) = _X.middleRows(6,3);
+            _Z.row(3) = Mnb.row(0)*u + Mnb.row(1)*v + Mnb.row(2)*w;
+            _Z.row(4) = Mnb.row(3)*u + Mnb.row(4)*v + Mnb.row(5)*w;
+            _Z.row(5) = Mnb.row(6)*u + Mnb.row(7)*v + Mnb.row(8)*w;
+            return 6;
+        }
+
+        default:
+            throw std::invalid_argument("Unknown measurement type given to estimator");
+    }
+}
+
+
+void PFestimator::calculateLogLikelihood( const measurement& _measurement, int _nz )
+{
+    Array<float,6,1> invStd = measurementNoise[_measurement.type].array().inverse();
+
+    pool->parallelFor( nBlocks, [&]( int _begin, int _end )
+    {
+        Matrix<float,6,Dynamic,RowMajor> Z;
+
+        for ( int b=_begin; b<_end; ++b )
+        {
+            int begin = b*blockSize;
+            int length = std::min( blockSize, nParticles - begin );
+
+            Z.resize( 6,length );
+            measurementModelBatch( _measurement.type, particles.middleCols( begin,length ), Z );
+
+            logLikelihood.segment( begin,length ).setZero();
+
+            for ( int i=0; i<_nz; ++i )
+            {
+                ArrayXf residual = _measurement.value(i) - Z.row(i).array();
+
+                // Euler angles are wrapped to [-pi,pi]
+                if ( _measurement.type == IMU_MEASUREMENT && i < 3 )
+                    residual -= 2*M_PI*( residual/( 2*M_PI ) ).round();
+
+                logLikelihood.segment( begin,length ).array() -= 0.5*( residual*invStd(i) ).square();
+            }
+        }
+    } );
+}
+
+
+float PFestimator::effectiveSamples( float _fraction )
+{
+    ArrayXf w = logWeights.array() + _fraction*logLikelihood.array();
+    w = ( w - w.maxCoeff() ).exp();
+
+    return w.sum()*w.sum()/w.square().sum();
+}
+
+
+void PFestimator::resample(  )
+{
+    VectorXf cumulative = weights;
+    pool->inclusiveScan( cumulative );
+
+    float total = cumulative( nParticles-1 );
+    float offset = streams[0].uniform( );
+
+    // Particle j is copied to all sample points (k+offset)/N that fall in its part of the
+    // cumulative weights, so every particle can be processed independently
+    auto firstSample = [&]( float _c ) { return std::min( nParticles, std::max( 0, (int) ceil( _c/total*nParticles - offset ) ) ); };
+
+    pool->parallelFor( nBlocks, [&]( int _begin, int _end )
+    {
+        for ( int j=_begin*blockSize; j<std::min( _end*blockSize, nParticles ); ++j )
+        {
+            int begin = ( j == 0 ) ? 0 : firstSample( cumulative(j-1) );
+            int end = ( j == nParticles-1 ) ? nParticles : firstSample( cumulative(j) );
+
+            for ( int k=begin; k<end; ++k )
+                resampled.col(k) = particles.col(j);
+        }
+    } );
+
+    particles.swap( resampled );
+
+    weights.setConstant( 1.0/nParticles );
+    logWeights = weights.array().log();
+
+    // Regularization: duplicated particles are spread with a Gaussian kernel scaled to the
+    // covariance before resampling, using the optimal bandwidth for a Gaussian density.
+    // Particles are first shrunk towards the mean, so that the covariance is preserved.
+    float bandwidth = pow( 4.0/( nx + 2.0 ), 1.0/( nx + 4.0 ) )*pow( nParticles, -1.0/( nx + 4.0 ) );
+    float shrinkage = sqrt( 1.0 - bandwidth*bandwidth );
+
+    LLT<Matrix<float,12,12>> covarianceFactor( stateCovariance );
+
+    if ( covarianceFactor.info() != Success )
+        return;
+
+    Matrix<float,12,12> L = bandwidth*covarianceFactor.matrixL().toDenseMatrix();
+    Matrix<float,12,1> mean = stateEstimate;
+
+    pool->parallelFor( nBlocks, [&]( int _begin, int _end )
+    {
+        for ( int b=_begin; b<_end; ++b )
+        {
+            int begin = b*blockSize;
+            int length = std::min( blockSize, nParticles - begin );
+
+            stateBatch noise( 12,length );
+            streams[b].normal( Map<VectorXf>( noise.data(), noise.size() ) );
+
+            stateBatch deviation = particles.middleCols( begin,length ).colwise() - mean;
+            deviation.topRows(3) -= 2*M_PI*( deviation.topRows(3).array()/( 2*M_PI ) ).round().matrix();
+
+            particles.middleCols( begin,length ) = ( shrinkage*deviation + L*noise ).colwise() + mean;
+        }
+    } );
+}
+
+
+void PFestimator::calculateEstimate(  )
+{
+    Matrix<float,12,1> mean = particles*weights;
+
+    // Circular mean of Euler angles
+    for ( int i=0; i<3; ++i )
+        mean(i) = atan2( particles.row(i).array().sin().matrix().dot( weights ), particles.row(i).array().cos().matrix().dot( weights ) );
+
+    // Weighted covariance, accumulated per block
+    std::vector<Matrix<float,12,12>> blockCovariance( nBlocks );
+
+    pool->parallelFor( nBlocks, [&]( int _begin, int _end )
+    {
+        for ( int b=_begin; b<_end; ++b )
+        {
+            int begin = b*blockSize;
+            int length = std::min( blockSize, nParticles - begin );
+
+            stateBatch deviation = particles.middleCols( begin,length ).colwise() - mean;
+            deviation.topRows(3) -= 2*M_PI*( deviation.topRows(3).array()/( 2*M_PI ) ).round().matrix();
+
+            blockCovariance[b] = deviation*weights.segment( begin,length ).asDiagonal()*deviation.transpose();
+        }
+    } );
+
+    stateCovariance.setZero();
+    for ( int b=0; b<nBlocks; ++b )
+        stateCovariance += blockCovariance[b];
+
+    stateEstimate = mean;
+}
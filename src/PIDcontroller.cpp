@@ -53,13 +53,54 @@ PIDcontroller::PIDcontroller( const PIDcontroller& rhs ) : controller( rhs )
 	dGains = rhs.dGains;
 
 	iValue    = rhs.iValue;
+	dValue    = rhs.dValue;
+	pValue    = rhs.pValue;
 	lastError = rhs.lastError;
 }
 
 
+PIDcontroller& PIDcontroller::operator=( const PIDcontroller& rhs )
+{
+	controller::operator=( rhs );
+
+	pGains = rhs.pGains;
+	iGains = rhs.iGains;
+	dGains = rhs.dGains;
+
+	iValue    = rhs.iValue;
+	dValue    = rhs.dValue;
+	pValue    = rhs.pValue;
+	lastError = rhs.lastError;
+
+	return *this;
+}
+
+
 PIDcontroller::~PIDcontroller(  ){}
 
 
+void PIDcontroller::save( snapshot& _snapshot ) const
+{
+    controller::save( _snapshot );
+
+    _snapshot.write( iValue );
+    _snapshot.write( dValue );
+    _snapshot.write( pValue );
+    _snapshot.write( lastError );
+}
+
+
+void PIDcontroller::restore( snapshot& _snapshot )
+{
+    controller::restore( _snapshot );
+
+    _snapshot.read( iValue );
+    _snapshot.read( dValue );
+    _snapshot.read( pValue );
+    _snapshot.read( lastError );
+}
+
+
 void PIDcontroller::setProportionalGains( const VectorXf& _pGains )
 {
     if ( _pGains.size() != nInputs )
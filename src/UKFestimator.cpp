@@ -0,0 +1,229 @@
+/**
+ *	\file src/UKFestimator.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+UKFestimator::UKFestimator(  ) : estimator(  )
+{
+    sigmaPoints = stateBatch::Zero( 12,nSigma );
+    calculateWeights( );
+}
+
+
+UKFestimator::UKFestimator( VectorXf& _initEstimate, float _initTime, float _samplingTime ) : estimator( _initEstimate, _initTime, _samplingTime )
+{
+    sigmaPoints = stateBatch::Zero( 12,nSigma );
+    calculateWeights( );
+}
+
+
+UKFestimator::UKFestimator( const UKFestimator& rhs ) : estimator( rhs )
+{
+    alpha = rhs.alpha;
+    beta = rhs.beta;
+    kappa = rhs.kappa;
+    gamma = rhs.gamma;
+
+    meanWeights = rhs.meanWeights;
+    covWeights = rhs.covWeights;
+
+    sigmaPoints = rhs.sigmaPoints;
+    covarianceFactor = rhs.covarianceFactor;
+}
+
+
+UKFestimator::~UKFestimator(  ) {}
+
+
+void UKFestimator::estimateState( VectorXf& _u, VectorXf& _y, VectorXf& _x )
+{
+    /* Prediction Step */
+    generateSigmaPoints( );
+    propagateBatch( sigmaPoints, _u.head(3) );
+
+    // Euler angles are wrapped around the mean sigma point, so that sigma points on either
+    // side of +-pi give the correct mean and deviations
+    for ( int j=0; j<3; ++j )
+        for ( int i=1; i<nSigma; ++i )
+            sigmaPoints(j,i) = sigmaPoints(j,0) + remainder( sigmaPoints(j,i) - sigmaPoints(j,0), 2*M_PI );
+
+    Matrix<float,12,1> mean = sigmaPoints*meanWeights;
+    stateBatch deviation = sigmaPoints.colwise() - mean;
+
+    for ( int j=0; j<3; ++j )
+        mean(j) = remainder( mean(j), 2*M_PI );
+
+    stateCovariance = deviation*covWeights.asDiagonal()*deviation.transpose();
+    stateCovariance += processNoise*samplingTime;
+    stateCovariance = 0.5*( stateCovariance + stateCovariance.transpose() );
+
+    stateEstimate = mean;
+    time = time + samplingTime;
+
+    /* Update Step */
+    measurement imu;
+    imu.sampleTime = time;
+    imu.arrivalTime = time;
+    imu.type = IMU_MEASUREMENT;
+    imu.size = 6;
+    imu.value = _y( seq( 0,5 ) );
+
+    update( imu );
+
+    _x = stateEstimate;
+}
+
+
+void UKFestimator::update( const measurement& _measurement )
+{
+    Matrix<float,12,1> x = stateEstimate;
+    Matrix<float,6,1> z;
+
+    int nz = measurementModel( _measurement.type, x, z );
+
+    if ( nz != _measurement.size )
+        throw std::invalid_argument("Incorrect number of measurement channels given to estimator");
+
+    // Predicted measurement of every sigma point
+    generateSigmaPoints( );
+
+    Matrix<float,6,nSigma> Z;
+
+    for ( int i=0; i<nSigma; ++i )
+    {
+        x = sigmaPoints.col(i);
+        measurementModel( _measurement.type, x, z );
+        Z.col(i) = z;
+    }
+
+    // Euler angles are wrapped around the measurement of the mean sigma point
+    if ( _measurement.type == IMU_MEASUREMENT )
+        for ( int i=1; i<nSigma; ++i )
+            for ( int j=0; j<3; ++j )
+                Z(j,i) = Z(j,0) + remainder( Z(j,i) - Z(j,0), 2*M_PI );
+
+    Matrix<float,Dynamic,1,0,6,1> zMean = Z.topRows(nz)*meanWeights;
+    Matrix<float,Dynamic,nSigma,0,6,nSigma> dZ = Z.topRows(nz).colwise() - zMean;
+    Matrix<float,12,nSigma> dX = sigmaPoints.colwise() - Matrix<float,12,1>( stateEstimate );
+
+    // Innovation covariance and cross covariance
+    Matrix<float,Dynamic,Dynamic,0,6,6> S = dZ*covWeights.asDiagonal()*dZ.transpose();
+    S.diagonal() += measurementNoise[_measurement.type].head(nz).array().square().matrix();
+
+    Matrix<float,12,Dynamic,0,12,6> Pxz = dX*covWeights.asDiagonal()*dZ.transpose();
+
+    // Innovation, Euler angles are wrapped to [-pi,pi]
+    Matrix<float,Dynamic,1,0,6,1> innovation = _measurement.value.head(nz) - zMean;
+
+    if ( _measurement.type == IMU_MEASUREMENT )
+        for ( int i=0; i<3; ++i )
+            innovation(i) = remainder( innovation(i), 2*M_PI );
+
+    // Kalman gain
+    LLT<Matrix<float,Dynamic,Dynamic,0,6,6>> Sfactor( S );
+    Matrix<float,12,Dynamic,0,12,6> K = Sfactor.solve( Pxz.transpose() ).transpose();
+
+    stateEstimate = Matrix<float,12,1>( stateEstimate ) + K*innovation;
+
+    for ( int j=0; j<3; ++j )
+        stateEstimate(j) = remainder( stateEstimate(j), 2*M_PI );
+
+    // Covariance update P = P - (K*Ls)*(K*Ls)^T as rank-one downdates of the Cholesky factor
+    Matrix<float,12,Dynamic,0,12,6> U = K*Sfactor.matrixL();
+
+    for ( int j=0; j<nz; ++j )
+        covarianceFactor.rankUpdate( U.col(j), -1 );
+
+    if ( covarianceFactor.info() == Success )
+        stateCovariance = covarianceFactor.reconstructedMatrix();
+    else
+    {
+        stateCovariance -= U*U.transpose();
+        stateCovariance = 0.5*( stateCovariance + stateCovariance.transpose() );
+    }
+}
+
+
+void UKFestimator::setUpdateMethod( updateMethod _method )
+{
+    if ( _method != JOSEPH_UPDATE )
+        throw std::invalid_argument("Unscented estimator only supports the batch update");
+}
+
+
+void UKFestimator::setSigmaPointParameters( float _alpha, float _beta, float _kappa )
+{
+    if ( _alpha <= 0 || 12 + _kappa <= 0 )
+        throw std::invalid_argument("Invalid sigma point parameters given");
+
+    alpha = _alpha;
+    beta = _beta;
+    kappa = _kappa;
+
+    calculateWeights( );
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void UKFestimator::generateSigmaPoints(  )
+{
+    covarianceFactor.compute( stateCovariance );
+
+    // Rounding in single precision can make the covariance indefinite. It is recovered by
+    // symmetrizing it, flooring its diagonal and adding a growing jitter to the diagonal.
+    if ( covarianceFactor.info() != Success )
+    {
+        stateCovariance = 0.5*( stateCovariance + stateCovariance.transpose() );
+
+        float jitter = 1e-6*std::max( stateCovariance.diagonal().cwiseAbs().maxCoeff(), 1e-6f );
+        stateCovariance.diagonal() = stateCovariance.diagonal().cwiseMax( jitter );
+
+        for ( int k=0; k<8; ++k, jitter *= 10 )
+        {
+            covarianceFactor.compute( stateCovariance );
+            if ( covarianceFactor.info() == Success )
+                break;
+
+            stateCovariance.diagonal().array() += jitter;
+        }
+
+        if ( covarianceFactor.info() != Success )
+            throw std::invalid_argument("State covariance of estimator cannot be made positive definite");
+    }
+
+    Matrix<float,12,12> L = gamma*covarianceFactor.matrixL().toDenseMatrix();
+    Matrix<float,12,1> x = stateEstimate;
+
+    sigmaPoints.col(0) = x;
+    sigmaPoints.middleCols<12>(1) = L.colwise() + x;
+    sigmaPoints.middleCols<12>(13) = ( -L ).colwise() + x;
+}
+
+
+void UKFestimator::calculateWeights(  )
+{
+    float n = 12;
+    float lambda = alpha*alpha*( n + kappa ) - n;
+
+    gamma = sqrt( n + lambda );
+
+    meanWeights.setConstant( 0.5/( n + lambda ) );
+    covWeights.setConstant( 0.5/( n + lambda ) );
+
+    meanWeights(0) = lambda/( n + lambda );
+    covWeights(0) = lambda/( n + lambda ) + 1 - alpha*alpha + beta;
+}
@@ -41,6 +41,29 @@ actuator::actuator( const actuator& rhs ) : saturator( rhs )
 
     lowerRateLimits = rhs.lowerRateLimits;
     upperRateLimits = rhs.upperRateLimits;
+
+    controlRate = rhs.controlRate;
+}
+
+
+actuator& actuator::operator=( const actuator& rhs )
+{
+    saturator::operator=( rhs );
+
+    nu = rhs.nu;
+    samplingTime = rhs.samplingTime;
+
+    lastU = rhs.lastU;
+
+    lowerLimits = rhs.lowerLimits;
+    upperLimits = rhs.upperLimits;
+
+    lowerRateLimits = rhs.lowerRateLimits;
+    upperRateLimits = rhs.upperRateLimits;
+
+    controlRate = rhs.controlRate;
+
+    return *this;
 }
 
 
@@ -61,3 +84,15 @@ void actuator::actuate( VectorXf& _u )
 }
 
 
+void actuator::save( snapshot& _snapshot ) const
+{
+    saturator::save( _snapshot );
+    _snapshot.write( controlRate );
+}
+
+
+void actuator::restore( snapshot& _snapshot )
+{
+    saturator::restore( _snapshot );
+    _snapshot.read( controlRate );
+}
@@ -0,0 +1,300 @@
+/**
+ *	\file src/compression.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+/** Append bits to a byte vector, most significant bit first
+ */
+class bitWriter
+{
+    public:
+        bitWriter( std::vector<uint8_t>& _out ) : out( _out ) {}
+
+        void write( uint64_t _bits, int _count )
+        {
+            while ( _count > 0 )
+            {
+                int take = std::min( 8 - used, _count );
+                uint8_t piece = ( _bits >> ( _count - take ) ) & ( ( 1u << take ) - 1 );
+
+                current |= piece << ( 8 - used - take );
+                used += take;
+                _count -= take;
+
+                if ( used == 8 ) { out.push_back( current ); current = 0; used = 0; }
+            }
+        }
+
+        void flush( )
+        {
+            if ( used > 0 ) { out.push_back( current ); current = 0; used = 0; }
+        }
+
+    private:
+        std::vector<uint8_t>& out;
+        uint8_t current = 0;
+        int used = 0;
+};
+
+
+/** Read bits from a byte array, most significant bit first
+ */
+class bitReader
+{
+    public:
+        bitReader( const uint8_t* _data, size_t _size ) : data( _data ), size( _size ) {}
+
+        uint64_t read( int _count )
+        {
+            uint64_t bits = 0;
+
+            while ( _count > 0 )
+            {
+                if ( position >= size )
+                    throw std::invalid_argument("Compressed block is truncated");
+
+                int take = std::min( 8 - used, _count );
+                uint8_t piece = ( data[position] >> ( 8 - used - take ) ) & ( ( 1u << take ) - 1 );
+
+                bits = ( bits << take ) | piece;
+                used += take;
+                _count -= take;
+
+                if ( used == 8 ) { ++position; used = 0; }
+            }
+            return bits;
+        }
+
+    private:
+        const uint8_t* data;
+        size_t size;
+        size_t position = 0;
+        int used = 0;
+};
+
+
+static int leadingZeros( uint32_t _x )
+{
+#ifdef __GNUC__
+    return __builtin_clz( _x );
+#else
+    int n = 0;
+    while ( !( _x & 0x80000000u ) ) { _x <<= 1; ++n; }
+    return n;
+#endif
+}
+
+
+static int trailingZeros( uint32_t _x )
+{
+#ifdef __GNUC__
+    return __builtin_ctz( _x );
+#else
+    int n = 0;
+    while ( !( _x & 1u ) ) { _x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+
+static uint32_t floatBits( float _value )
+{
+    uint32_t bits;
+    std::memcpy( &bits, &_value, 4 );
+    return bits;
+}
+
+
+static float bitsFloat( uint32_t _bits )
+{
+    float value;
+    std::memcpy( &value, &_bits, 4 );
+    return value;
+}
+
+
+/** XOR encoding: identical values take one bit, otherwise only the bits between the
+ *  leading and trailing zeros of the XOR are stored, reusing the previous window if it fits
+ */
+static void encodeXOR( const float* _values, int _n, std::vector<uint8_t>& _out )
+{
+    bitWriter bits( _out );
+    uint32_t prev = floatBits( _values[0] );
+    int prevLead = 33, prevTrail = 0;
+
+    bits.write( prev, 32 );
+
+    for ( int i=1; i<_n; ++i )
+    {
+        uint32_t cur = floatBits( _values[i] );
+        uint32_t x = cur ^ prev;
+        prev = cur;
+
+        if ( x == 0 ) { bits.write( 0, 1 ); continue; }
+
+        int lead = leadingZeros( x ), trail = trailingZeros( x );
+
+        if ( lead >= prevLead && trail >= prevTrail )
+        {
+            bits.write( 2, 2 );
+            bits.write( x >> prevTrail, 32 - prevLead - prevTrail );
+        }
+        else
+        {
+            int length = 32 - lead - trail;
+
+            bits.write( 3, 2 );
+            bits.write( lead, 5 );
+            bits.write( length - 1, 5 );
+            bits.write( x >> trail, length );
+
+            prevLead = lead;
+            prevTrail = trail;
+        }
+    }
+    bits.flush();
+}
+
+
+static void decodeXOR( const uint8_t* _data, size_t _size, int _n, float* _values )
+{
+    bitReader bits( _data, _size );
+    uint32_t prev = bits.read( 32 );
+    int lead = 0, trail = 0;
+
+    _values[0] = bitsFloat( prev );
+
+    for ( int i=1; i<_n; ++i )
+    {
+        if ( bits.read( 1 ) )
+        {
+            if ( bits.read( 1 ) )
+            {
+                lead = bits.read( 5 );
+                trail = 32 - lead - ( (int) bits.read( 5 ) + 1 );
+            }
+            prev ^= (uint32_t) bits.read( 32 - lead - trail ) << trail;
+        }
+        _values[i] = bitsFloat( prev );
+    }
+}
+
+
+/** Delta-of-delta encoding of the bit patterns: constant increments take one bit,
+ *  small changes of the increment take 9 to 16 bits
+ */
+static void encodeDeltaOfDelta( const float* _values, int _n, std::vector<uint8_t>& _out )
+{
+    bitWriter bits( _out );
+    int64_t prev = floatBits( _values[0] );
+    int64_t prevDelta = 0;
+
+    bits.write( prev, 32 );
+
+    for ( int i=1; i<_n; ++i )
+    {
+        int64_t cur = floatBits( _values[i] );
+        int64_t delta = cur - prev;
+        int64_t dod = delta - prevDelta;
+
+        prev = cur;
+        prevDelta = delta;
+
+        if ( dod == 0 )
+            bits.write( 0, 1 );
+        else if ( dod >= -64 && dod < 64 )
+            { bits.write( 2, 2 ); bits.write( dod & 0x7F, 7 ); }
+        else if ( dod >= -256 && dod < 256 )
+            { bits.write( 6, 3 ); bits.write( dod & 0x1FF, 9 ); }
+        else if ( dod >= -2048 && dod < 2048 )
+            { bits.write( 14, 4 ); bits.write( dod & 0xFFF, 12 ); }
+        else
+            { bits.write( 15, 4 ); bits.write( dod, 64 ); }
+    }
+    bits.flush();
+}
+
+
+static void decodeDeltaOfDelta( const uint8_t* _data, size_t _size, int _n, float* _values )
+{
+    bitReader bits( _data, _size );
+    int64_t prev = bits.read( 32 );
+    int64_t delta = 0;
+
+    _values[0] = bitsFloat( prev );
+
+    for ( int i=1; i<_n; ++i )
+    {
+        int64_t dod = 0;
+
+        // Prefix of up to four bits selects the width of the sign-extended value
+        int width = 0;
+        if ( bits.read( 1 ) )
+        {
+            if ( !bits.read( 1 ) ) width = 7;
+            else if ( !bits.read( 1 ) ) width = 9;
+            else if ( !bits.read( 1 ) ) width = 12;
+            else width = 64;
+        }
+
+        if ( width == 64 )
+            dod = bits.read( 64 );
+        else if ( width > 0 )
+        {
+            dod = bits.read( width );
+            if ( dod >> ( width - 1 ) )
+                dod -= (int64_t) 1 << width;
+        }
+
+        delta += dod;
+        prev += delta;
+        _values[i] = bitsFloat( prev );
+    }
+}
+
+
+
+compressionCodec compressBlock(const float* values, int n, std::vector<uint8_t>& out)
+{
+    if ( n <= 0 )
+        return XOR_CODEC;
+
+    std::vector<uint8_t> xorBytes, dodBytes;
+    encodeXOR( values, n, xorBytes );
+    encodeDeltaOfDelta( values, n, dodBytes );
+
+    if ( dodBytes.size() < xorBytes.size() )
+    {
+        out.insert( out.end(), dodBytes.begin(), dodBytes.end() );
+        return DELTA_OF_DELTA_CODEC;
+    }
+
+    out.insert( out.end(), xorBytes.begin(), xorBytes.end() );
+    return XOR_CODEC;
+}
+
+
+void decompressBlock(compressionCodec codec, const uint8_t* data, size_t size, int n, float* values)
+{
+    if ( n <= 0 )
+        return;
+
+    switch ( codec )
+    {
+        case XOR_CODEC:
+            decodeXOR( data, size, n, values );
+            break;
+
+        case DELTA_OF_DELTA_CODEC:
+            decodeDeltaOfDelta( data, size, n, values );
+            break;
+
+        default:
+            throw std::invalid_argument("Unknown compression codec");
+    }
+}
@@ -58,21 +58,64 @@ controller::controller( unsigned int _nInputs,
 }
 
 
-controller::controller( const controller& rhs ) : saturator( rhs )
+controller::controller( const controller& rhs ) : saturator( rhs ), filter( rhs )
 {
     nInputs = rhs.nInputs;
     nOutputs = rhs.nOutputs;
 
     samplingTime = rhs.samplingTime;
+    refCoeff = rhs.refCoeff;
 
     u = rhs.u;
+    uSatDiff = rhs.uSatDiff;
     yRef = rhs.yRef;
 }
 
 
+controller& controller::operator=( const controller& rhs )
+{
+    saturator::operator=( rhs );
+    filter::operator=( rhs );
+
+    nInputs = rhs.nInputs;
+    nOutputs = rhs.nOutputs;
+
+    samplingTime = rhs.samplingTime;
+    refCoeff = rhs.refCoeff;
+
+    u = rhs.u;
+    uSatDiff = rhs.uSatDiff;
+    yRef = rhs.yRef;
+
+    return *this;
+}
+
+
 controller::~controller(  ){}
 
 
+void controller::save( snapshot& _snapshot ) const
+{
+    saturator::save( _snapshot );
+    filter::save( _snapshot );
+
+    _snapshot.write( u );
+    _snapshot.write( uSatDiff );
+    _snapshot.write( yRef );
+}
+
+
+void controller::restore( snapshot& _snapshot )
+{
+    saturator::restore( _snapshot );
+    filter::restore( _snapshot );
+
+    _snapshot.read( u );
+    _snapshot.read( uSatDiff );
+    _snapshot.read( yRef );
+}
+
+
 void controller::setPolynomialReference( const MatrixXf& _refCoeff )
 {
     if ( _refCoeff.rows() != nInputs )
@@ -0,0 +1,110 @@
+/**
+ *	\file src/delayLine.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+delayLine::delayLine(  ) {}
+
+
+delayLine::delayLine( int _nu, VectorXf _initSignal, float _samplingTime, int _capacity )
+{
+    if ( _capacity < 2 )
+        throw std::invalid_argument("Delay line capacity must be at least two samples");
+
+    nu = _nu;
+    capacity = _capacity;
+    samplingTime = _samplingTime;
+
+    history = MatrixXf::Zero( nu,capacity );
+
+    if ( _initSignal.size() > _nu )
+        throw std::invalid_argument("Incorrect number of initial signal channels given");
+    else if ( _initSignal.size() == _nu )
+        history.colwise() = _initSignal;
+}
+
+
+delayLine::~delayLine(  ) {}
+
+
+void delayLine::setDelayTicks( int _ticks )
+{
+    if ( _ticks < 0 || _ticks > capacity-1 )
+        throw std::invalid_argument("Delay exceeds capacity of delay line");
+
+    delayTicks = _ticks;
+    delayFraction = 0;
+}
+
+
+void delayLine::setDelay( float _delay )
+{
+    float ticks = _delay / samplingTime;
+    int whole = (int) floor( ticks + 1e-4 );
+    float fraction = ticks - whole;
+
+    if ( fraction < 1e-4 )
+        fraction = 0;
+
+    // Interpolation requires the sample before the integer delay as well
+    if ( whole < 0 || whole + (fraction > 0) > capacity-1 )
+        throw std::invalid_argument("Delay exceeds capacity of delay line");
+
+    delayTicks = whole;
+    delayFraction = fraction;
+}
+
+
+void delayLine::delay( VectorXf& _u )
+{
+    if ( capacity == 0 )
+        throw std::invalid_argument("Delay line has no storage, construct it with a capacity");
+
+    if ( _u.size() != nu )
+        throw std::invalid_argument("Incorrect number of signals given to delay line");
+
+    // Store most recent sample
+    head = (head + 1) % capacity;
+    history.col( head ) = _u;
+
+    // Read delayed sample
+    int idx = (head - delayTicks + capacity) % capacity;
+
+    if ( delayFraction > 0 )
+    {
+        int prev = (idx - 1 + capacity) % capacity;
+        _u = (1 - delayFraction)*history.col( idx ) + delayFraction*history.col( prev );
+    }
+    else
+        _u = history.col( idx );
+}
+
+
+void delayLine::save( snapshot& _snapshot ) const
+{
+    _snapshot.write( head );
+    _snapshot.write( history );
+}
+
+
+void delayLine::restore( snapshot& _snapshot )
+{
+    MatrixXf stored;
+
+    _snapshot.read( head );
+    _snapshot.read( stored );
+
+    if ( stored.rows() != nu || stored.cols() != capacity )
+        throw std::invalid_argument("Snapshot does not match the dimensions of the delay line");
+
+    history = stored;
+}
@@ -25,9 +25,65 @@ dynamics::dynamics( VectorXf _initState,
 }
 
 
+dynamics::dynamics( const dynamics& rhs ) = default;
+
+
+dynamics& dynamics::operator=( const dynamics& rhs ) = default;
+
+
 dynamics::~dynamics( ) {}
 
 
+void dynamics::setMass( float _mass )
+{
+    if ( _mass <= 0 )
+        throw std::invalid_argument("Mass must be positive");
+
+    mass = _mass;
+}
+
+
+void dynamics::setInertia( const Vector3f& _inertia )
+{
+    if ( ( _inertia.array() <= 0 ).any() )
+        throw std::invalid_argument("Moments of inertia must be positive");
+
+    Ixx = _inertia(0); Iyy = _inertia(1); Izz = _inertia(2);
+}
+
+
+void dynamics::setPropellerConstants( float _forceConstant, float _momentConstant )
+{
+    kf1 = -_forceConstant; kf2 = _forceConstant;
+    km1 = _momentConstant; km2 = _momentConstant;
+}
+
+
+void dynamics::setThrustOffset( const Vector2f& _offset )
+{
+    thrustOffsetX = _offset(0);
+    thrustOffsetY = _offset(1);
+}
+
+
+void dynamics::save( snapshot& _snapshot ) const
+{
+    _snapshot.write( state );
+    _snapshot.write( earthVel );
+    _snapshot.write( time );
+    _snapshot.write( state_aux );
+}
+
+
+void dynamics::restore( snapshot& _snapshot )
+{
+    _snapshot.read( state );
+    _snapshot.read( earthVel );
+    _snapshot.read( time );
+    _snapshot.read( state_aux );
+}
+
+
 void dynamics::step( VectorXf& _u, VectorXf& _y )
 {
     /* Update system state */
@@ -71,15 +127,16 @@ VectorXf dynamics::EOM(   float _t, VectorXf x, const VectorXf& _u    )
     VectorXf M(3); M = calculateMoment( _t, x, _u );
     VectorXf F(3); F = calculateForce( _t, x, _u );
 
-    stateDerivative[0] = x[3] + x[4] * tan(x[1]) * sin(x[0]) + x[5] * tan(x[1]) * cos(x[0]);                                    // Phi - roll angle (E-frame)
-    stateDerivative[1] = x[4] * cos(x[0]) - x[5] * sin(x[0]);                                                                   // Theta - pitch angle (E-frame)
-    stateDerivative[2] = x[4] * sin(x[0]) / cos(x[1]) - x[5]  * cos(x[0]) / cos(x[1]);                                          // Psi - yaw angle (E-frame)
+    eulerTrig t = eulerTrigonometry( x.head<3>() );
+    Matrix3f Mnb = eulerToDCM( t );
+
+    stateDerivative[0] = x[3] + ( x[4]*t.sphi + x[5]*t.cphi )*t.sth/t.cth;                                                     // Phi - roll angle (E-frame)
+    stateDerivative[1] = x[4]*t.cphi - x[5]*t.sphi;                                                                             // Theta - pitch angle (E-frame)
+    stateDerivative[2] = ( x[4]*t.sphi - x[5]*t.cphi )/t.cth;                                                                   // Psi - yaw angle (E-frame)
     stateDerivative[3] = ((Iyy-Izz) * x[4]*x[5] + ( pow(x[5],2) - pow(x[4],2) ) * Iyz + Ixy*x[3]*x[5] - Ixz*x[3]*x[4])/Ixx + M(0)/Ixx;     // p - roll rate (B-frame)
     stateDerivative[4] = ((Izz-Ixx) * x[3]*x[5] + ( pow(x[3],2) - pow(x[5],2) ) * Ixz + Iyz*x[4]*x[3] - Ixy*x[4]*x[5])/Iyy + M(1)/Iyy;     // q - pitch rate (B-frame)
     stateDerivative[5] = ((Ixx-Iyy) * x[3]*x[4] + ( pow(x[4],2) - pow(x[3],2) ) * Ixy + Ixz*x[5]*x[4] - Iyz*x[3]*x[5])/Izz + M(2)/Izz;     // r - yaw rate (B-frame)
-    stateDerivative[6] = (cos(x[1])*cos(x[2])) * x[9] + (sin(x[0])*sin(x[1])*cos(x[2]) - cos(x[0])*sin(x[2])) * x[10] + (sin(x[0])*sin(x[2]) + cos(x[0])*sin(x[1])*cos(x[2])) * x[11];  // x - position x-axis (E-frame)
-    stateDerivative[7] = (cos(x[1])*sin(x[2])) * x[9] + (cos(x[0])*cos(x[2]) + sin(x[0])*sin(x[1])*sin(x[2])) * x[10] + (cos(x[0])*sin(x[1])*sin(x[2]) - sin(x[0])*cos(x[2])) * x[11];  // y - position y-axis (E-frame)
-    stateDerivative[8] = (-sin(x[1])) * x[9] + (sin(x[0])*cos(x[1])) * x[10] + (cos(x[0])*cos(x[1])) * x[11];                                                                    // z - position z-axis (E-frame)     
+    stateDerivative.segment<3>(6) = Mnb*x.segment<3>(9);                                                                        // x, y, z - position (E-frame)
     stateDerivative[9] = x[5]*x[10] - x[4]*x[11] + F(0)/mass;                                                                      // u - velocity x-axis (B-frame)
     stateDerivative[10] = x[3]*x[11] - x[9]*x[5] + F(1)/mass;                                                                     // v - velocity y-axis (B-frame)
     stateDerivative[11] = x[4]*x[9] - x[3]*x[10] + F(2)/mass;                                                                     // w - velocity z-axis (B-frame)
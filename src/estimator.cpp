@@ -12,7 +12,10 @@
 // PUBLIC MEMBER FUNCTIONS:
 //
 
-estimator::estimator(  ){}
+estimator::estimator(  )
+{
+    setDefaultNoise( );
+}
 
 
 estimator::estimator( VectorXf& _initState,
@@ -22,27 +25,238 @@ estimator::estimator( VectorXf& _initState,
     stateEstimate = _initState;
     time = _initTime;
     samplingTime = _samplingTime;
+
+    setDefaultNoise( );
+}
+
+
+estimator::estimator( float _initTime, float _samplingTime )
+{
+    stateEstimate = VectorXf::Zero( nx );
+    time = _initTime;
+    samplingTime = _samplingTime;
+
+    setDefaultNoise( );
+}
+
+
+estimator::estimator( const estimator& rhs )
+{
+    stateEstimate = rhs.stateEstimate;
+    time = rhs.time;
+    samplingTime = rhs.samplingTime;
+
+    stateCovariance = rhs.stateCovariance;
+    initCovariance = rhs.initCovariance;
+    processNoise = rhs.processNoise;
+    stateJacobian = rhs.stateJacobian;
+
+    for ( int i=0; i<N_MEASUREMENT_TYPES; ++i )
+        measurementNoise[i] = rhs.measurementNoise[i];
+
+    magField = rhs.magField;
+
+    covarianceUpdate = rhs.covarianceUpdate;
+    covarianceU = rhs.covarianceU;
+    covarianceD = rhs.covarianceD;
 }
 
 
 estimator::~estimator( ) {}
 
 
-void estimator::init(  ) {}
+void estimator::init(  )
+{
+    stateCovariance = initCovariance;
+
+    if ( covarianceUpdate == UD_UPDATE )
+        factorizeUD( );
+}
 
 
 void estimator::estimateState( VectorXf& _u, VectorXf& _y, VectorXf& _x )
 {
     /* Prediction Step */
+    propagateCovariance( );
     updateEstimate( _u );
 
     /* Update Step */
+    measurement imu;
+    imu.sampleTime = time;
+    imu.arrivalTime = time;
+    imu.type = IMU_MEASUREMENT;
+    imu.size = 6;
+    imu.value = _y( seq( 0,5 ) );
 
+    update( imu );
 
     _x = stateEstimate;
 }
 
 
+void estimator::estimateState( VectorXf& _u, VectorXf& _y, measurementQueue& _queue, VectorXf& _x )
+{
+    estimateState( _u, _y, _x );
+
+    // Fuse all measurements that have arrived
+    measurement m;
+
+    while ( _queue.pop( time, m ) )
+        update( m );
+
+    _x = stateEstimate;
+}
+
+
+void estimator::update( const measurement& _measurement )
+{
+    const float eps = 1e-3;
+
+    Matrix<float,12,1> x = stateEstimate;
+    Matrix<float,6,1> z0, z1;
+
+    int nz = measurementModel( _measurement.type, x, z0 );
+
+    if ( nz != _measurement.size )
+        throw std::invalid_argument("Incorrect number of measurement channels given to estimator");
+
+    // Measurement Jacobian (forward differences)
+    Matrix<float,Dynamic,12,0,6,12> H( nz,12 );
+
+    for ( int j=0; j<12; ++j )
+    {
+        Matrix<float,12,1> xp = x;
+        xp(j) += eps;
+        measurementModel( _measurement.type, xp, z1 );
+        H.col(j) = ( z1.head(nz) - z0.head(nz) ) / eps;
+    }
+
+    // Innovation, Euler angles are wrapped to [-pi,pi]
+    Matrix<float,Dynamic,1,0,6,1> innovation = _measurement.value.head(nz) - z0.head(nz);
+
+    if ( _measurement.type == IMU_MEASUREMENT )
+        for ( int i=0; i<3; ++i )
+            innovation(i) = remainder( innovation(i), 2*M_PI );
+
+    Matrix<float,Dynamic,1,0,6,1> variance = measurementNoise[_measurement.type].head(nz).array().square();
+
+    if ( covarianceUpdate == JOSEPH_UPDATE )
+    {
+        Matrix<float,Dynamic,Dynamic,0,6,6> R = variance.asDiagonal();
+
+        // Kalman gain
+        Matrix<float,Dynamic,Dynamic,0,6,6> S = H*stateCovariance*H.transpose() + R;
+        Matrix<float,12,Dynamic,0,12,6> K = S.llt().solve( H*stateCovariance ).transpose();
+
+        // Joseph-form covariance update
+        Matrix<float,12,12> IKH = Matrix<float,12,12>::Identity() - K*H;
+
+        x += K*innovation;
+        stateCovariance = IKH*stateCovariance*IKH.transpose() + K*R*K.transpose();
+    }
+    else
+    {
+        // Channels are uncorrelated and processed one at a time, the innovation of later
+        // channels is corrected for the state change of earlier ones
+        Matrix<float,12,1> xPrior = x;
+
+        for ( int i=0; i<nz; ++i )
+        {
+            float channelInnovation = innovation(i) - H.row(i).dot( x - xPrior );
+
+            if ( covarianceUpdate == UD_UPDATE )
+                biermanUpdate( H.row(i), channelInnovation, variance(i), x );
+            else
+                scalarUpdate( H.row(i), channelInnovation, variance(i), x );
+        }
+
+        if ( covarianceUpdate == UD_UPDATE )
+            stateCovariance = covarianceU*covarianceD.asDiagonal()*covarianceU.transpose();
+    }
+
+    stateEstimate = x;
+}
+
+
+void estimator::setProcessNoise( const VectorXf& _processNoise )
+{
+    if ( _processNoise.size() != nx )
+        throw std::invalid_argument("Incorrect number of process noise entries given");
+
+    processNoise = _processNoise.asDiagonal();
+}
+
+
+void estimator::setInitialCovariance( const VectorXf& _initStd )
+{
+    if ( _initStd.size() != nx )
+        throw std::invalid_argument("Incorrect number of initial state uncertainties given");
+
+    initCovariance = _initStd.array().square().matrix().asDiagonal();
+    init( );
+}
+
+
+void estimator::setMeasurementNoise( measurementType _type, const VectorXf& _noiseStd )
+{
+    Matrix<float,6,1> z;
+    Matrix<float,12,1> x = Matrix<float,12,1>::Zero();
+
+    if ( _noiseStd.size() != measurementModel( _type, x, z ) )
+        throw std::invalid_argument("Incorrect number of measurement noise entries given");
+
+    measurementNoise[_type].head( _noiseStd.size() ) = _noiseStd;
+}
+
+
+void estimator::setUpdateMethod( updateMethod _method )
+{
+    covarianceUpdate = _method;
+
+    if ( covarianceUpdate == UD_UPDATE )
+        factorizeUD( );
+}
+
+
+void estimator::setMagneticField( const Vector3f& _field )
+{
+    magField = _field;
+}
+
+
+float estimator::NEES( const VectorXf& _trueState )
+{
+    Matrix<float,12,1> error = _trueState - stateEstimate;
+
+    for ( int i=0; i<3; ++i )
+        error(i) = remainder( error(i), 2*M_PI );
+
+    return error.dot( stateCovariance.llt().solve( error ) );
+}
+
+
+void estimator::save( snapshot& _snapshot ) const
+{
+    _snapshot.write( stateEstimate );
+    _snapshot.write( time );
+    _snapshot.write( stateCovariance );
+    _snapshot.write( state_aux );
+    _snapshot.write( covarianceU );
+    _snapshot.write( covarianceD );
+}
+
+
+void estimator::restore( snapshot& _snapshot )
+{
+    _snapshot.read( stateEstimate );
+    _snapshot.read( time );
+    _snapshot.read( stateCovariance );
+    _snapshot.read( state_aux );
+    _snapshot.read( covarianceU );
+    _snapshot.read( covarianceD );
+}
+
+
 
 
 //
@@ -68,20 +282,252 @@ void estimator::updateEstimate( VectorXf& _u )
 }
 
 
+void estimator::modelBatch( const constStateBatchRef& _X, const Vector3f& _u, stateBatchRef _Xdot )
+{
+    float theta1 = _u(0);           // gimbal rotation around x-axis
+    float theta2 = _u(1);           // gimbal rotation around y-axis
+    float omega1 = _u(2);           // ccw positive rotating propeller rotational velocity (upper prop)
+    float omega2 = -_u(2);          // cw negative rotating propeller rotational velocity (bottom prop)
+
+    // Thrust and control moments only depend on the shared input. Aerodynamic terms
+    // evaluate to zero in calculateForce and calculateMoment and are left out here.
+    float thrust = kf1*omega1 + kf2*omega2;
+    float torque = km1*omega1 + km2*omega2;
+
+    Vector3f Ft( sin(theta2)*thrust, -sin(theta1)*cos(theta2)*thrust, cos(theta1)*cos(theta2)*thrust );
+
+    Vector3f M;
+    M(0) = rcg*sin(theta1)*cos(theta2)*thrust - sin(theta2)*torque + cos(theta1)*cos(theta2)*thrust*thrustOffsetY;
+    M(1) = rcg*sin(theta2)*thrust + sin(theta1)*cos(theta2)*torque - cos(theta1)*cos(theta2)*thrust*thrustOffsetX;
+    M(2) = -cos(theta1)*cos(theta2)*torque;
+
+    // Trigonometric terms and rotation to E-frame, evaluated once per sample
+    eulerTrigBatch trig;
+    eulerTrigonometry( _X.topRows(3), trig );
+
+    dcmBatch Mnb;
+    eulerToDCM( trig, Mnb );
+
+    auto sphi = trig.row(0); auto cphi = trig.row(1);
+    auto sth = trig.row(2); auto cth = trig.row(3);
+
+    auto p = _X.row(3).array(); auto q = _X.row(4).array(); auto r = _X.row(5).array();
+    auto u = _X.row(9).array(); auto v = _X.row(10).array(); auto w = _X.row(11).array();
+
+    _Xdot.row(0) = p + ( q*sphi + r*cphi )*sth/cth;                                                              // Phi - roll angle (E-frame)
+    _Xdot.row(1) = q*cphi - r*sphi;                                                                             // Theta - pitch angle (E-frame)
+    _Xdot.row(2) = ( q*sphi - r*cphi )/cth;                                                                     // Psi - yaw angle (E-frame)
+    _Xdot.row(3) = ( (Iyy-Izz)*q*r + ( r*r - q*q )*Iyz + Ixy*p*r - Ixz*p*q )/Ixx + M(0)/Ixx;                    // p - roll rate (B-frame)
+    _Xdot.row(4) = ( (Izz-Ixx)*p*r + ( p*p - r*r )*Ixz + Iyz*q*p - Ixy*q*r )/Iyy + M(1)/Iyy;                    // q - pitch rate (B-frame)
+    _Xdot.row(5) = ( (Ixx-Iyy)*p*q + ( q*q - p*p )*Ixy + Ixz*r*q - Iyz*p*r )/Izz + M(2)/Izz;                    // r - yaw rate (B-frame)
+    _Xdot.row(6) = Mnb.row(0)*u + Mnb.row(1)*v + Mnb.row(2)*w;                                                 // x - position x-axis (E-frame)
+    _Xdot.row(7) = Mnb.row(3)*u + Mnb.row(4)*v + Mnb.row(5)*w;                                                 // y - position y-axis (E-frame)
+    _Xdot.row(8) = Mnb.row(6)*u + Mnb.row(7)*v + Mnb.row(8)*w;                                                 // z - position z-axis (E-frame)
+    _Xdot.row(9) = r*v - q*w + Mnb.row(6)*9.81 + Ft(0)/mass;                                                   // u - velocity x-axis (B-frame)
+    _Xdot.row(10) = p*w - u*r + Mnb.row(7)*9.81 + Ft(1)/mass;                                                  // v - velocity y-axis (B-frame)
+    _Xdot.row(11) = q*u - p*v + Mnb.row(8)*9.81 + Ft(2)/mass;                                                  // w - velocity z-axis (B-frame)
+}
+
+
+void estimator::modelJacobian( const Matrix<float,12,1>& _x, Matrix<float,12,12>& _F )
+{
+    // Thrust and control moments only depend on the input and aerodynamic terms evaluate
+    // to zero in calculateForce and calculateMoment, so the Jacobian only depends on the state
+    const float g = 9.81;
+
+    eulerTrig t = eulerTrigonometry( _x.head<3>() );
+    Matrix3f Mnb = eulerToDCM( t );
+    Matrix3f dPhi, dTheta, dPsi;
+    eulerToDCMPartials( t, dPhi, dTheta );
+    dPsi << -Mnb.row(1), Mnb.row(0), RowVector3f::Zero();
+
+    float p = _x(3), q = _x(4), r = _x(5);
+    float u = _x(9), v = _x(10), w = _x(11);
+    float tth = t.sth/t.cth;
+
+    _F.setZero();
+
+    // Euler angle kinematics
+    _F(0,0) = ( q*t.cphi - r*t.sphi )*tth;
+    _F(0,1) = ( q*t.sphi + r*t.cphi )/( t.cth*t.cth );
+    _F(0,3) = 1;
+    _F(0,4) = t.sphi*tth;
+    _F(0,5) = t.cphi*tth;
+
+    _F(1,0) = -q*t.sphi - r*t.cphi;
+    _F(1,4) = t.cphi;
+    _F(1,5) = -t.sphi;
+
+    _F(2,0) = ( q*t.cphi + r*t.sphi )/t.cth;
+    _F(2,1) = ( q*t.sphi - r*t.cphi )*tth/t.cth;
+    _F(2,4) = t.sphi/t.cth;
+    _F(2,5) = -t.cphi/t.cth;
+
+    // Rigid body rotation
+    _F(3,3) = ( Ixy*r - Ixz*q )/Ixx;
+    _F(3,4) = ( (Iyy-Izz)*r - 2*Iyz*q - Ixz*p )/Ixx;
+    _F(3,5) = ( (Iyy-Izz)*q + 2*Iyz*r + Ixy*p )/Ixx;
+
+    _F(4,3) = ( (Izz-Ixx)*r + 2*Ixz*p + Iyz*q )/Iyy;
+    _F(4,4) = ( Iyz*p - Ixy*r )/Iyy;
+    _F(4,5) = ( (Izz-Ixx)*p - 2*Ixz*r - Ixy*q )/Iyy;
+
+    _F(5,3) = ( (Ixx-Iyy)*q - 2*Ixy*p - Iyz*r )/Izz;
+    _F(5,4) = ( (Ixx-Iyy)*p + 2*Ixy*q + Ixz*r )/Izz;
+    _F(5,5) = ( Ixz*q - Iyz*p )/Izz;
+
+    // Position, body-fixed velocity rotated to E-frame
+    Vector3f vb = _x.segment<3>(9);
+    _F.block<3,1>(6,0) = dPhi*vb;
+    _F.block<3,1>(6,1) = dTheta*vb;
+    _F.block<3,1>(6,2) = dPsi*vb;
+    _F.block<3,3>(6,9) = Mnb;
+
+    // Body-fixed velocity, transport term and gravity
+    _F(9,1) = -t.cth*g;
+    _F(9,4) = -w;
+    _F(9,5) = v;
+    _F(9,10) = r;
+    _F(9,11) = -q;
+
+    _F(10,0) = t.cphi*t.cth*g;
+    _F(10,1) = -t.sphi*t.sth*g;
+    _F(10,3) = w;
+    _F(10,5) = -u;
+    _F(10,9) = -r;
+    _F(10,11) = p;
+
+    _F(11,0) = -t.sphi*t.cth*g;
+    _F(11,1) = -t.cphi*t.sth*g;
+    _F(11,3) = -v;
+    _F(11,4) = u;
+    _F(11,9) = q;
+    _F(11,10) = -p;
+}
+
+
+void estimator::propagateBatch( stateBatchRef _X, const Vector3f& _u )
+{
+    stateBatch k1( 12,_X.cols() ), k2( 12,_X.cols() ), k3( 12,_X.cols() ), k4( 12,_X.cols() );
+    stateBatch Xk( 12,_X.cols() );
+
+    // Evaluation at start of interval
+    modelBatch( _X, _u, k1 );
+
+    // Evaluation at midway of interval
+    Xk = _X + samplingTime/2.0*k1;
+    modelBatch( Xk, _u, k2 );
+
+    Xk = _X + samplingTime/2.0*k2;
+    modelBatch( Xk, _u, k3 );
+
+    // Evaluation at end of interval
+    Xk = _X + samplingTime*k3;
+    modelBatch( Xk, _u, k4 );
+
+    _X += samplingTime/6.0*( k1 + 2.0*k2 + 2.0*k3 + k4 );
+}
+
+
+void estimator::setDefaultNoise(  )
+{
+    VectorXf q(12);
+    q << 1e-4, 1e-4, 1e-4, 1e-1, 1e-1, 1e-1, 1e-4, 1e-4, 1e-4, 1e-1, 1e-1, 1e-1;
+    processNoise = q.asDiagonal();
+
+    VectorXf p0(12);
+    p0 << 0.05, 0.05, 0.05, 0.05, 0.05, 0.05, 0.5, 0.5, 0.5, 0.2, 0.2, 0.2;
+    initCovariance = p0.array().square().matrix().asDiagonal();
+    stateCovariance = initCovariance;
+
+    stateJacobian.setZero();
+
+    for ( int i=0; i<N_MEASUREMENT_TYPES; ++i )
+        measurementNoise[i].setZero();
+
+    measurementNoise[GPS_MEASUREMENT] << 0.5, 0.5, 1.0, 0.05, 0.05, 0.1;
+    measurementNoise[BARO_MEASUREMENT](0) = 0.1;
+    measurementNoise[MAG_MEASUREMENT].head(3) << 0.005, 0.005, 0.005;
+    measurementNoise[IMU_MEASUREMENT] << 0.01, 0.01, 0.01, 0.005, 0.005, 0.005;
+    measurementNoise[POSITION_MEASUREMENT].head(3) << 0.5, 0.5, 0.5;
+
+    magField << 0.2, 0.0, 0.45;
+}
+
+
+void estimator::propagateCovariance(  )
+{
+    modelJacobian( stateEstimate, stateJacobian );
+
+    // Second order discretization of state transition matrix
+    Matrix<float,12,12> Fdt = stateJacobian*samplingTime;
+    Matrix<float,12,12> Phi = Matrix<float,12,12>::Identity() + Fdt + 0.5*Fdt*Fdt;
+
+    if ( covarianceUpdate == UD_UPDATE )
+    {
+        thorntonUpdate( Phi );
+        stateCovariance = covarianceU*covarianceD.asDiagonal()*covarianceU.transpose();
+        return;
+    }
+
+    stateCovariance = Phi*stateCovariance*Phi.transpose() + processNoise*samplingTime;
+    stateCovariance = 0.5*( stateCovariance + stateCovariance.transpose() );
+}
+
+
+int estimator::measurementModel( measurementType _type, const Matrix<float,12,1>& _x, Matrix<float,6,1>& _z )
+{
+    Matrix3f Mnb;
+
+    switch ( _type )
+    {
+        case IMU_MEASUREMENT:
+            _z = _x.head(6);
+            return 6;
+
+        case POSITION_MEASUREMENT:
+            _z.head(3) = _x.segment(6,3);
+            return 3;
+
+        case BARO_MEASUREMENT:
+            _z(0) = -_x(8);
+            return 1;
+
+        case GPS_MEASUREMENT:
+        case MAG_MEASUREMENT:
+            Mnb = eulerToDCM( _x.head<3>() );
+
+            if ( _type == MAG_MEASUREMENT )
+            {
+                _z.head(3) = Mnb.transpose()*magField;
+                return 3;
+            }
+
+            _z.head(3) = _x.segment(6,3);
+            _z.tail(3) = Mnb*_x.segment(9,3);
+            return 6;
+
+        default:
+            throw std::invalid_argument("Unknown measurement type given to estimator");
+    }
+}
+
+
 VectorXf estimator::model(   float _t, VectorXf x, const VectorXf& _u    )
 {
     VectorXf M(3); M = calculateMoment( _t, x, _u );
     VectorXf F(3); F = calculateForce( _t, x, _u );
 
-    stateDerivative[0] = x[3] + x[4] * tan(x[1]) * sin(x[0]) + x[5] * tan(x[1]) * cos(x[0]);                                    // Phi - roll angle (E-frame)
-    stateDerivative[1] = x[4] * cos(x[0]) - x[5] * sin(x[0]);                                                                   // Theta - pitch angle (E-frame)
-    stateDerivative[2] = x[4] * sin(x[0]) / cos(x[1]) - x[5]  * cos(x[0]) / cos(x[1]);                                          // Psi - yaw angle (E-frame)
+    eulerTrig t = eulerTrigonometry( x.head<3>() );
+    Matrix3f Mnb = eulerToDCM( t );
+
+    stateDerivative[0] = x[3] + ( x[4]*t.sphi + x[5]*t.cphi )*t.sth/t.cth;                                                     // Phi - roll angle (E-frame)
+    stateDerivative[1] = x[4]*t.cphi - x[5]*t.sphi;                                                                             // Theta - pitch angle (E-frame)
+    stateDerivative[2] = ( x[4]*t.sphi - x[5]*t.cphi )/t.cth;                                                                   // Psi - yaw angle (E-frame)
     stateDerivative[3] = ((Iyy-Izz) * x[4]*x[5] + ( pow(x[5],2) - pow(x[4],2) ) * Iyz + Ixy*x[3]*x[5] - Ixz*x[3]*x[4])/Ixx + M(0)/Ixx;     // p - roll rate (B-frame)
     stateDerivative[4] = ((Izz-Ixx) * x[3]*x[5] + ( pow(x[3],2) - pow(x[5],2) ) * Ixz + Iyz*x[4]*x[3] - Ixy*x[4]*x[5])/Iyy + M(1)/Iyy;     // q - pitch rate (B-frame)
     stateDerivative[5] = ((Ixx-Iyy) * x[3]*x[4] + ( pow(x[4],2) - pow(x[3],2) ) * Ixy + Ixz*x[5]*x[4] - Iyz*x[3]*x[5])/Izz + M(2)/Izz;     // r - yaw rate (B-frame)
-    stateDerivative[6] = (cos(x[1])*cos(x[2])) * x[9] + (sin(x[0])*sin(x[1])*cos(x[2]) - cos(x[0])*sin(x[2])) * x[10] + (sin(x[0])*sin(x[2]) + cos(x[0])*sin(x[1])*cos(x[2])) * x[11];  // x - position x-axis (E-frame)
-    stateDerivative[7] = (cos(x[1])*sin(x[2])) * x[9] + (cos(x[0])*cos(x[2]) + sin(x[0])*sin(x[1])*sin(x[2])) * x[10] + (cos(x[0])*sin(x[1])*sin(x[2]) - sin(x[0])*cos(x[2])) * x[11];  // y - position y-axis (E-frame)
-    stateDerivative[8] = (-sin(x[1])) * x[9] + (sin(x[0])*cos(x[1])) * x[10] + (cos(x[0])*cos(x[1])) * x[11];                                                                    // z - position z-axis (E-frame)     
+    stateDerivative.segment<3>(6) = Mnb*x.segment<3>(9);                                                                        // x, y, z - position (E-frame)
     stateDerivative[9] = x[5]*x[10] - x[4]*x[11] + F(0)/mass;                                                                      // u - velocity x-axis (B-frame)
     stateDerivative[10] = x[3]*x[11] - x[9]*x[5] + F(1)/mass;                                                                     // v - velocity y-axis (B-frame)
     stateDerivative[11] = x[4]*x[9] - x[3]*x[10] + F(2)/mass;                                                                     // w - velocity z-axis (B-frame)
@@ -157,3 +603,102 @@ VectorXf estimator::calculateMoment(  float _t, VectorXf& _x, const VectorXf& _u
 
     return Ma+Md+Mc-Mr+Mt;
 }
+
+
+void estimator::scalarUpdate( const Matrix<float,1,12>& _h, float _innovation, float _variance, Matrix<float,12,1>& _x )
+{
+    Matrix<float,12,1> b = stateCovariance*_h.transpose();
+    float s = _h.dot( b ) + _variance;
+    Matrix<float,12,1> k = b/s;
+
+    _x += k*_innovation;
+
+    // Joseph form (I-kh)P(I-kh)^T + k*r*k^T, expanded to rank-one terms
+    stateCovariance += s*k*k.transpose() - k*b.transpose() - b*k.transpose();
+    stateCovariance = 0.5*( stateCovariance + stateCovariance.transpose() );
+}
+
+
+void estimator::biermanUpdate( const Matrix<float,1,12>& _h, float _innovation, float _variance, Matrix<float,12,1>& _x )
+{
+    Matrix<float,12,1> f = covarianceU.transpose()*_h.transpose();
+    Matrix<float,12,1> v = covarianceD.cwiseProduct( f );
+    Matrix<float,12,1> b = Matrix<float,12,1>::Zero();
+
+    float alpha = _variance;
+
+    for ( int j=0; j<12; ++j )
+    {
+        float alphaPrev = alpha;
+        alpha += f(j)*v(j);
+
+        float lambda = -f(j)/alphaPrev;
+        covarianceD(j) *= alphaPrev/alpha;
+
+        b(j) = v(j);
+
+        for ( int i=0; i<j; ++i )
+        {
+            float u = covarianceU(i,j);
+            covarianceU(i,j) = u + lambda*b(i);
+            b(i) += u*v(j);
+        }
+    }
+
+    _x += b*( _innovation/alpha );
+}
+
+
+void estimator::thorntonUpdate( const Matrix<float,12,12>& _Phi )
+{
+    // Rows of W = [Phi*U, I] are orthogonalized with weights [D, Q*dt]
+    Matrix<float,12,24> W;
+    W << _Phi*covarianceU, Matrix<float,12,12>::Identity();
+
+    Matrix<float,1,24> weights;
+    weights << covarianceD.transpose(), processNoise.diagonal().transpose()*samplingTime;
+
+    covarianceU.setIdentity();
+
+    for ( int j=11; j>=0; --j )
+    {
+        Matrix<float,1,24> c = W.row(j).cwiseProduct( weights );
+        covarianceD(j) = W.row(j).dot( c );
+
+        if ( covarianceD(j) <= 0 )
+            throw std::invalid_argument("State covariance of estimator is not positive definite");
+
+        Matrix<float,1,24> d = c/covarianceD(j);
+
+        for ( int i=0; i<j; ++i )
+        {
+            covarianceU(i,j) = W.row(i).dot( d );
+            W.row(i) -= covarianceU(i,j)*W.row(j);
+        }
+    }
+}
+
+
+void estimator::factorizeUD(  )
+{
+    Matrix<float,12,12> P = stateCovariance;
+
+    covarianceU.setIdentity();
+    covarianceD.setZero();
+
+    for ( int j=11; j>=0; --j )
+    {
+        covarianceD(j) = P(j,j);
+
+        if ( covarianceD(j) <= 0 )
+            throw std::invalid_argument("State covariance of estimator is not positive definite");
+
+        for ( int i=0; i<j; ++i )
+            covarianceU(i,j) = P(i,j)/covarianceD(j);
+
+        // Remove contribution of column j from remaining upper-left block
+        for ( int i=0; i<j; ++i )
+            for ( int k=0; k<=i; ++k )
+                P(k,i) -= covarianceU(k,j)*covarianceD(j)*covarianceU(i,j);
+    }
+}
@@ -55,6 +55,7 @@ filter::filter( const filter& rhs )
 {
     omega_0 = rhs.omega_0;
     dt = rhs.dt;
+    nu = rhs.nu;
 
     prevX = rhs.prevX;
     prevY = rhs.prevY;
@@ -64,9 +65,39 @@ filter::filter( const filter& rhs )
 }
 
 
+filter& filter::operator=( const filter& rhs )
+{
+    omega_0 = rhs.omega_0;
+    dt = rhs.dt;
+    nu = rhs.nu;
+
+    prevX = rhs.prevX;
+    prevY = rhs.prevY;
+
+    a_coeff = rhs.a_coeff;
+    b_coeff = rhs.b_coeff;
+
+    return *this;
+}
+
+
 filter::~filter(  ){}
 
 
+void filter::save( snapshot& _snapshot ) const
+{
+    _snapshot.write( prevX );
+    _snapshot.write( prevY );
+}
+
+
+void filter::restore( snapshot& _snapshot )
+{
+    _snapshot.read( prevX );
+    _snapshot.read( prevY );
+}
+
+
 
 //
 // PRIVATE MEMBER FUNCTIONS:
@@ -0,0 +1,173 @@
+/**
+ *	\file src/flightRecorder.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+flightRecorder::flightRecorder( std::string _fileName, const std::vector<telemetryChannel>& _channels, float _samplingTime, float _preTime, float _postTime, float _summaryTime )
+{
+    if ( _samplingTime <= 0 || _preTime < 0 || _postTime < 0 || _summaryTime < _samplingTime )
+        throw std::invalid_argument("Invalid flight recorder windows");
+
+    fileName = _fileName;
+    channels = _channels;
+    nChannels = _channels.size();
+
+    preSamples = std::max( 1, (int) round( _preTime/_samplingTime ) );
+    postSamples = (int) round( _postTime/_samplingTime );
+    summarySamples = (int) round( _summaryTime/_samplingTime );
+
+    history = MatrixXf::Zero( nChannels,preSamples );
+
+    // Summary channels hold minimum, mean and maximum of each channel
+    std::vector<telemetryChannel> summaryChannels;
+    for ( const char* statistic : { "_min", "_mean", "_max" } )
+        for ( const telemetryChannel& channel : _channels )
+            summaryChannels.push_back( { channel.name + statistic, channel.unit } );
+
+    summary.reset( new telemetryWriter( fileName + "_summary.tlm", summaryChannels, 128 ) );
+    summaryRecord.resize( 3*nChannels );
+}
+
+
+flightRecorder::~flightRecorder(  )
+{
+    close( );
+}
+
+
+void flightRecorder::addTrigger( std::string _name, std::function<bool(const VectorXf&)> _condition )
+{
+    triggers.push_back( { _name, _condition } );
+    triggerActive.push_back( false );
+}
+
+
+void flightRecorder::record( const Ref<const VectorXf>& _record )
+{
+    if ( _record.size() != nChannels )
+        throw std::invalid_argument("Incorrect number of channels given to flight recorder");
+
+    history.col( nRecords % preSamples ) = _record;
+    ++nRecords;
+
+    // Summary statistics
+    if ( summaryFill == 0 )
+    {
+        summaryMin = _record;
+        summaryMax = _record;
+        summarySum = _record;
+    }
+    else
+    {
+        summaryMin = summaryMin.cwiseMin( _record );
+        summaryMax = summaryMax.cwiseMax( _record );
+        summarySum += _record;
+    }
+
+    if ( ++summaryFill == summarySamples )
+        writeSummary( );
+
+    // Triggers fire when their condition becomes true, so that a persisting
+    // condition does not keep the capture running
+    lastRecord = _record;
+
+    const std::string* fired = nullptr;
+    for ( size_t k=0; k<triggers.size(); ++k )
+    {
+        bool active = triggers[k].second( lastRecord );
+
+        if ( active && !triggerActive[k] && !fired )
+            fired = &triggers[k].first;
+
+        triggerActive[k] = active;
+    }
+
+    if ( capture )
+    {
+        capture->write( _record );
+        remaining = fired ? postSamples : remaining - 1;
+    }
+    else if ( fired )
+        startCapture( *fired );
+
+    if ( capture && remaining <= 0 )
+    {
+        capture->close();
+        capture.reset();
+    }
+}
+
+
+void flightRecorder::close(  )
+{
+    if ( capture )
+    {
+        capture->close();
+        capture.reset();
+    }
+
+    if ( summary )
+    {
+        if ( summaryFill > 0 )
+            writeSummary( );
+
+        summary->close();
+        summary.reset();
+    }
+}
+
+
+const std::vector<recorderEvent>& flightRecorder::events(  ) const
+{
+    return eventLog;
+}
+
+
+const std::vector<telemetryChannel>& flightRecorder::channelList(  ) const
+{
+    return channels;
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void flightRecorder::startCapture( const std::string& _trigger )
+{
+    recorderEvent event;
+    event.trigger = _trigger;
+    event.sample = nRecords - 1;
+    event.fileName = fileName + "_event" + std::to_string( eventLog.size() ) + ".tlm";
+    eventLog.push_back( event );
+
+    // Ring buffer from the oldest record up to and including the triggering record
+    int n = std::min<unsigned long>( nRecords, preSamples );
+    int first = ( nRecords - n ) % preSamples;
+    int tail = std::min( n, preSamples - first );
+
+    capture.reset( new telemetryWriter( event.fileName, channels, std::max( 1, std::min( 4096, n + postSamples ) ) ) );
+    capture->writeBlock( history.middleCols( first,tail ) );
+    capture->writeBlock( history.leftCols( n - tail ) );
+
+    remaining = postSamples;
+}
+
+
+void flightRecorder::writeSummary(  )
+{
+    summaryRecord << summaryMin, summarySum/summaryFill, summaryMax;
+    summary->write( summaryRecord );
+    summaryFill = 0;
+}
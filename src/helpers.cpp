@@ -9,23 +9,127 @@
 
 
 
-MatrixXf loadFromFile(std::string FileName, int row, int col)
+static const char binaryMagic[4] = { 'T','V','C','M' };
+static const uint32_t binaryVersion = 1;
+
+
+/** Parse comma separated values, the number of columns is taken from the first line
+ */
+static MatrixXf parseCSV( const char* _begin, const char* _end, const std::string& _fileName )
+{
+    std::vector<float> values;
+    int cols = -1;
+    int rows = 0;
+
+    // Reserve storage from the number of lines and the length of the first line
+    const char* firstEnd = std::find( _begin, _end, '\n' );
+    size_t nLines = std::count( _begin, _end, '\n' ) + 1;
+    values.reserve( nLines*( std::count( _begin, firstEnd, ',' ) + 1 ) );
+
+    const char* p = _begin;
+
+    while ( p < _end )
+    {
+        int col = 0;
+
+        // Skip empty lines
+        if ( *p == '\n' || *p == '\r' ) { ++p; continue; }
+
+        while ( true )
+        {
+            while ( p < _end && ( *p == ' ' || *p == '\t' ) ) ++p;
+            if ( p < _end && *p == '+' ) ++p;
+
+            float value;
+            std::from_chars_result result = std::from_chars( p, _end, value );
+
+            if ( result.ec != std::errc() )
+                throw std::invalid_argument("Invalid entry in row " + std::to_string( rows+1 ) + " of " + _fileName);
+
+            values.push_back( value );
+            ++col;
+            p = result.ptr;
+
+            while ( p < _end && ( *p == ' ' || *p == '\t' || *p == '\r' ) ) ++p;
+
+            if ( p < _end && *p == ',' ) { ++p; continue; }
+            if ( p < _end && *p != '\n' )
+                throw std::invalid_argument("Invalid separator in row " + std::to_string( rows+1 ) + " of " + _fileName);
+            break;
+        }
+
+        if ( cols < 0 )
+            cols = col;
+        else if ( col != cols )
+            throw std::invalid_argument("Inconsistent number of columns in row " + std::to_string( rows+1 ) + " of " + _fileName);
+
+        ++rows;
+        ++p;
+    }
+
+    if ( rows == 0 )
+        return MatrixXf( 0,0 );
+
+    return Map<Matrix<float,Dynamic,Dynamic,RowMajor>>( values.data(), rows, cols );
+}
+
+
+/** Copy binary matrix from memory, after checking its header
+ */
+static MatrixXf parseBinary( const char* _data, size_t _size, const std::string& _fileName )
 {
-    MatrixXf Matrix(row, col);
-	std::ifstream File(FileName);
-	for (int k = 0; k < row; ++k) {
-		std::string line;
-		std::getline(File, line, '\n');
-		for (int j = 0; j < col; ++j) {
-			std::string entry = line.substr(0, line.find(','));
-			line.erase(0, line.find(',') + 1);
-			Matrix(k, j) = std::stod(entry);
-		}
-	}
+    uint32_t header[4];
+
+    if ( _size < sizeof( header ) )
+        throw std::invalid_argument("Truncated header in " + _fileName);
+
+    std::memcpy( header, _data, sizeof( header ) );
+
+    if ( std::memcmp( _data, binaryMagic, 4 ) != 0 || header[1] != binaryVersion )
+        throw std::invalid_argument("Unsupported binary matrix format in " + _fileName);
+
+    size_t rows = header[2]; size_t cols = header[3];
+
+    if ( _size < sizeof( header ) + rows*cols*sizeof( float ) )
+        throw std::invalid_argument("Truncated data in " + _fileName);
+
+    MatrixXf Matrix( rows, cols );
+    std::memcpy( Matrix.data(), _data + sizeof( header ), rows*cols*sizeof( float ) );
+
     return Matrix;
 }
 
 
+MatrixXf loadFromFile(std::string FileName)
+{
+    mappedFile File( FileName );
+
+    if ( File.size() >= 4 && std::memcmp( File.data(), binaryMagic, 4 ) == 0 )
+        return parseBinary( File.data(), File.size(), FileName );
+
+    return parseCSV( File.data(), File.data() + File.size(), FileName );
+}
+
+
+MatrixXf loadFromFile(std::string FileName, int row, int col)
+{
+    MatrixXf Matrix = loadFromFile( FileName );
+
+    if ( Matrix.rows() < row || Matrix.cols() < col )
+        throw std::invalid_argument("File " + FileName + " contains less data than requested");
+
+    return Matrix.topLeftCorner( row, col );
+}
+
+
+MatrixXf loadFromBinary(std::string FileName)
+{
+    mappedFile File( FileName );
+
+    return parseBinary( File.data(), File.size(), FileName );
+}
+
+
 void saveToFile(MatrixXf &data, int rows, int cols, std::string FileName)
 {
     std::ofstream File; File.open(FileName);
@@ -42,36 +146,22 @@ void saveToFile(MatrixXf &data, int rows, int cols, std::string FileName)
 }
 
 
-VectorXf toQuaternion( VectorXf& EAngles )
-{   
-    VectorXf temp(4);
-
-    float roll = EAngles(0); float pitch = EAngles(1); float yaw = EAngles(2);
-
-    float cy = cos( yaw * 0.5 );
-    float sy = sin( yaw * 0.5);
-    float cp = cos( pitch * 0.5 );
-    float sp = sin( pitch * 0.5 );
-    float cr = cos( roll * 0.5 );
-    float sr = sin( roll * 0.5 );
-
-    temp(0) = cr * cp * cy + sr * sp * sy;
-    temp(1) = sr * cp * cy - cr * sp * sy;
-    temp(2) = cr * sp * cy + sr * cp * sy;
-    temp(3) = cr * cp * sy - sr * sp * cy;
+void saveToBinary(const MatrixXf &data, std::string FileName)
+{
+    uint32_t header[4];
+    std::memcpy( header, binaryMagic, 4 );
+    header[1] = binaryVersion;
+    header[2] = data.rows();
+    header[3] = data.cols();
 
-    return temp;
+    std::ofstream File( FileName, std::ios::binary );
+    File.write( (const char*) header, sizeof( header ) );
+    File.write( (const char*) data.data(), data.size()*sizeof( float ) );
+    File.close();
 }
 
 
-VectorXf BFRtoNED( VectorXf& EulerAngles, VectorXf& Vector )
+VectorXf BFRtoNED( const VectorXf& EulerAngles, const VectorXf& Vector )
 {
-    float phi = EulerAngles(0); float theta = EulerAngles(1); float psi = EulerAngles(2);
-
-    MatrixXf Mnb(3,3);
-    Mnb <<  cos(psi)*cos(theta), -sin(psi)*cos(phi)+cos(psi)*sin(theta)*sin(phi), sin(psi)*sin(phi)+cos(psi)*sin(theta)*cos(phi),
-            sin(psi)*cos(theta), cos(psi)*cos(phi)+sin(psi)*sin(theta)*sin(phi),-cos(psi)*sin(phi)+sin(psi)*sin(theta)*cos(phi),
-            -sin(theta), cos(theta)*sin(phi), cos(theta)*cos(phi);
-    
-    return Mnb*Vector;
+    return eulerToDCM( EulerAngles.head<3>() )*Vector.head<3>();
 }
\ No newline at end of file
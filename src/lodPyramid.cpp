@@ -0,0 +1,119 @@
+/**
+ *	\file src/lodPyramid.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+lodPyramid::lodPyramid( std::string _fileName, const std::vector<telemetryChannel>& _channels, int _factor, int _maxLevels )
+{
+    if ( _factor < 2 || _maxLevels < 1 )
+        throw std::invalid_argument("Pyramid requires a factor of at least two and one level");
+
+    fileName = _fileName;
+    nChannels = _channels.size();
+    factor = _factor;
+    maxLevels = _maxLevels;
+
+    for ( const char* statistic : { "_min", "_max" } )
+        for ( const telemetryChannel& channel : _channels )
+            levelChannels.push_back( { channel.name + statistic, channel.unit } );
+
+    bucketMin.resize( nChannels,maxLevels );
+    bucketMax.resize( nChannels,maxLevels );
+    bucketFill.assign( maxLevels, 0 );
+    levelRecord.resize( 2*nChannels );
+}
+
+
+lodPyramid::~lodPyramid(  )
+{
+    close( );
+}
+
+
+void lodPyramid::add( const Ref<const VectorXf>& _sample )
+{
+    addToLevel( 0, _sample, _sample );
+}
+
+
+void lodPyramid::close(  )
+{
+    // Partial buckets are passed on from the bottom, which may complete buckets above
+    for ( size_t l=0; l<writers.size(); ++l )
+        if ( bucketFill[l] > 0 )
+            emit( l );
+
+    for ( std::unique_ptr<telemetryWriter>& writer : writers )
+        writer->close();
+
+    bucketFill.assign( maxLevels, 0 );
+}
+
+
+int lodPyramid::levels(  ) const
+{
+    return writers.size();
+}
+
+
+std::string lodPyramid::levelFileName( const std::string& _fileName, int _level )
+{
+    std::string base = _fileName;
+
+    if ( base.size() > 4 && base.compare( base.size() - 4, 4, ".tlm" ) == 0 )
+        base.resize( base.size() - 4 );
+
+    return base + ".lod" + std::to_string( _level ) + ".tlm";
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void lodPyramid::addToLevel( int _level, const Ref<const VectorXf>& _min, const Ref<const VectorXf>& _max )
+{
+    if ( _level >= maxLevels )
+        return;
+
+    if ( bucketFill[_level] == 0 )
+    {
+        bucketMin.col( _level ) = _min;
+        bucketMax.col( _level ) = _max;
+    }
+    else
+    {
+        bucketMin.col( _level ) = bucketMin.col( _level ).cwiseMin( _min );
+        bucketMax.col( _level ) = bucketMax.col( _level ).cwiseMax( _max );
+    }
+
+    if ( ++bucketFill[_level] == factor )
+        emit( _level );
+}
+
+
+void lodPyramid::emit( int _level )
+{
+    if ( (int) writers.size() <= _level )
+    {
+        writers.emplace_back( new telemetryWriter( levelFileName( fileName, _level+1 ), levelChannels, 256 ) );
+        writers.back()->setBucketSize( (uint64_t) pow( factor, _level+1 ) );
+    }
+
+    levelRecord << bucketMin.col( _level ), bucketMax.col( _level );
+    writers[_level]->write( levelRecord );
+    bucketFill[_level] = 0;
+
+    addToLevel( _level+1, bucketMin.col( _level ), bucketMax.col( _level ) );
+}
@@ -0,0 +1,76 @@
+/**
+ *	\file src/mappedFile.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+#ifndef _WIN32
+#include <fcntl.h>              // memory-mapped files
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+mappedFile::mappedFile( const std::string& _fileName )
+{
+#ifdef _WIN32
+    std::ifstream File( _fileName, std::ios::binary );
+    if ( !File )
+        throw std::invalid_argument("Unable to open file " + _fileName);
+
+    buffer.assign( std::istreambuf_iterator<char>( File ), std::istreambuf_iterator<char>() );
+    begin = buffer.data();
+    length = buffer.size();
+#else
+    int fd = open( _fileName.c_str(), O_RDONLY );
+    if ( fd < 0 )
+        throw std::invalid_argument("Unable to open file " + _fileName);
+
+    struct stat info;
+    fstat( fd, &info );
+    length = info.st_size;
+
+    if ( length > 0 )
+    {
+        void* map = mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( map == MAP_FAILED )
+        {
+            close( fd );
+            throw std::invalid_argument("Unable to map file " + _fileName);
+        }
+
+        madvise( map, length, MADV_SEQUENTIAL );
+        begin = (const char*) map;
+    }
+    close( fd );
+#endif
+}
+
+
+mappedFile::~mappedFile(  )
+{
+#ifndef _WIN32
+    if ( length > 0 )
+        munmap( (void*) begin, length );
+#endif
+}
+
+
+const char* mappedFile::data(  ) const
+{
+    return begin;
+}
+
+
+size_t mappedFile::size(  ) const
+{
+    return length;
+}
@@ -0,0 +1,154 @@
+/**
+ *	\file src/measurementQueue.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+measurementQueue::measurementQueue(  ) : measurementQueue( 64 ) {}
+
+
+measurementQueue::measurementQueue( unsigned int _capacity )
+{
+    if ( _capacity == 0 )
+        throw std::invalid_argument("Measurement queue capacity must be larger than zero");
+
+    capacity = _capacity;
+    head = 0;
+    count = 0;
+
+    buffer.resize( capacity );
+}
+
+
+measurementQueue::measurementQueue( const measurementQueue& rhs )
+{
+    buffer = rhs.buffer;
+
+    capacity = rhs.capacity;
+    head = rhs.head;
+    count = rhs.count;
+}
+
+
+measurementQueue& measurementQueue::operator=( const measurementQueue& rhs )
+{
+    buffer = rhs.buffer;
+
+    capacity = rhs.capacity;
+    head = rhs.head;
+    count = rhs.count;
+
+    return *this;
+}
+
+
+measurementQueue::~measurementQueue(  ){}
+
+
+bool measurementQueue::push( const measurement& _measurement )
+{
+    bool dropped = false;
+
+    // Drop oldest pending measurement if full
+    if ( count == capacity )
+    {
+        head = (head + 1) % capacity;
+        --count;
+        dropped = true;
+    }
+
+    // Insert at tail and move towards head until ordered by arrival time;
+    // sensors with different latencies may publish out of order
+    unsigned int idx = (head + count) % capacity;
+    buffer[idx] = _measurement;
+
+    for ( unsigned int i=count; i>0; --i )
+    {
+        unsigned int prev = (head + i - 1) % capacity;
+
+        if ( buffer[prev].arrivalTime <= buffer[idx].arrivalTime )
+            break;
+
+        std::swap( buffer[prev], buffer[idx] );
+        idx = prev;
+    }
+
+    ++count;
+
+    return !dropped;
+}
+
+
+bool measurementQueue::pop( float _time, measurement& _measurement )
+{
+    if ( count == 0 || buffer[head].arrivalTime > _time )
+        return false;
+
+    _measurement = buffer[head];
+
+    head = (head + 1) % capacity;
+    --count;
+
+    return true;
+}
+
+
+void measurementQueue::clear(  )
+{
+    head = 0;
+    count = 0;
+}
+
+
+unsigned int measurementQueue::size(  ) const
+{
+    return count;
+}
+
+
+void measurementQueue::save( snapshot& _snapshot ) const
+{
+    _snapshot.write( count );
+
+    for ( unsigned int i=0; i<count; ++i )
+    {
+        const measurement& m = buffer[(head + i) % capacity];
+
+        _snapshot.write( m.sampleTime );
+        _snapshot.write( m.arrivalTime );
+        _snapshot.write( m.type );
+        _snapshot.write( m.size );
+        _snapshot.write( m.value );
+    }
+}
+
+
+void measurementQueue::restore( snapshot& _snapshot )
+{
+    unsigned int n;
+    _snapshot.read( n );
+
+    clear( );
+
+    // Pending measurements are stored in arrival order
+    for ( unsigned int i=0; i<n; ++i )
+    {
+        measurement m;
+
+        _snapshot.read( m.sampleTime );
+        _snapshot.read( m.arrivalTime );
+        _snapshot.read( m.type );
+        _snapshot.read( m.size );
+        _snapshot.read( m.value );
+
+        push( m );
+    }
+}
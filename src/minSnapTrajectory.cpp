@@ -0,0 +1,240 @@
+/**
+ *	\file src/minSnapTrajectory.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+#include <Eigen/SparseLU>       // sparse solver for the coefficients of all segments
+
+
+static const int nCoefficients = 8;         // Coefficients per segment, 7th-order polynomials
+
+
+/** Coefficient of s^(k-d) in the d-th derivative of s^k, k!/(k-d)!
+ */
+static double falling( int _k, int _d )
+{
+    double f = 1.0;
+    for ( int j=0; j<_d; ++j )
+        f *= _k - j;
+    return f;
+}
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+minSnapTrajectory::minSnapTrajectory(  ) : reference(  ) {}
+
+
+minSnapTrajectory::minSnapTrajectory( const MatrixXf& _waypoints, const VectorXf& _segmentTimes, float _startTime ) : reference(  )
+{
+    solve( _waypoints, _segmentTimes, _startTime );
+}
+
+
+minSnapTrajectory::minSnapTrajectory( const MatrixXf& _waypoints, float _maxVelocity, float _maxAcceleration, float _startTime ) : reference(  )
+{
+    if ( _maxVelocity <= 0 || _maxAcceleration <= 0 )
+        throw std::invalid_argument("Trajectory time allocation requires a positive velocity and acceleration");
+
+    if ( _waypoints.cols() < 2 )
+        throw std::invalid_argument("Trajectory requires at least two waypoints");
+
+    // Rest-to-rest trapezoidal profile over each segment, at least the time to reach cruise velocity
+    VectorXf segmentTimes( _waypoints.cols() - 1 );
+
+    for ( int i=0; i<segmentTimes.size(); ++i )
+    {
+        float distance = ( _waypoints.col( i+1 ) - _waypoints.col( i ) ).norm();
+
+        if ( distance >= _maxVelocity*_maxVelocity/_maxAcceleration )
+            segmentTimes(i) = distance/_maxVelocity + _maxVelocity/_maxAcceleration;
+        else
+            segmentTimes(i) = 2*sqrt( distance/_maxAcceleration );
+
+        segmentTimes(i) = std::max( segmentTimes(i), _maxVelocity/_maxAcceleration );
+    }
+
+    solve( _waypoints, segmentTimes, _startTime );
+}
+
+
+minSnapTrajectory::minSnapTrajectory( const minSnapTrajectory& rhs ) : reference(  )
+{
+    nSegments = rhs.nSegments;
+    knots = rhs.knots;
+    coefficients = rhs.coefficients;
+    cursor = rhs.cursor;
+}
+
+
+minSnapTrajectory::~minSnapTrajectory(  ) {}
+
+
+Matrix<float,3,4> minSnapTrajectory::evaluate( float _time )
+{
+    if ( nSegments == 0 )
+        throw std::invalid_argument("Trajectory has not been built");
+
+    Matrix<float,3,4> result = Matrix<float,3,4>::Zero();
+
+    // Hold first and last waypoint outside the trajectory
+    if ( _time <= knots(0) || _time >= knots( nSegments ) )
+    {
+        int k = _time <= knots(0) ? 0 : nSegments - 1;
+        double s = _time <= knots(0) ? 0.0 : 1.0;
+
+        for ( int axis=0; axis<3; ++axis )
+        {
+            double p = 0.0;
+            for ( int j=nCoefficients-1; j>=0; --j )
+                p = p*s + coefficients( axis, nCoefficients*k + j );
+            result( axis,0 ) = p;
+        }
+        return result;
+    }
+
+    // Segment containing the time, moving forward from the last evaluation in amortized
+    // constant time and searching only when going back
+    if ( _time < knots( cursor ) )
+        cursor = std::upper_bound( knots.data(), knots.data() + nSegments, (double) _time ) - knots.data() - 1;
+
+    while ( _time >= knots( cursor+1 ) )
+        ++cursor;
+
+    double T = knots( cursor+1 ) - knots( cursor );
+    double s = ( _time - knots( cursor ) )/T;
+
+    // Horner evaluation of the derivatives in normalized time, scaled to time
+    static const Matrix<double,4,nCoefficients> factors = []( )
+    {
+        Matrix<double,4,nCoefficients> f;
+        for ( int d=0; d<4; ++d )
+            for ( int j=0; j<nCoefficients; ++j )
+                f( d,j ) = falling( j,d );
+        return f;
+    }( );
+
+    const double* c = coefficients.data() + 3*nCoefficients*cursor;
+    double scale = 1.0;
+
+    for ( int d=0; d<4; ++d )
+    {
+        for ( int axis=0; axis<3; ++axis )
+        {
+            double v = 0.0;
+            for ( int j=nCoefficients-1; j>=d; --j )
+                v = v*s + factors( d,j )*c[ 3*j + axis ];
+            result( axis,d ) = v*scale;
+        }
+        scale /= T;
+    }
+
+    return result;
+}
+
+
+void minSnapTrajectory::evaluate( float _time, VectorXf& _position, VectorXf& _velocity, VectorXf& _acceleration )
+{
+    Matrix<float,3,4> result = evaluate( _time );
+
+    _position = result.col( 0 );
+    _velocity = result.col( 1 );
+    _acceleration = result.col( 2 );
+}
+
+
+float minSnapTrajectory::startTime(  ) const
+{
+    return nSegments > 0 ? knots( 0 ) : 0.0;
+}
+
+
+float minSnapTrajectory::endTime(  ) const
+{
+    return nSegments > 0 ? knots( nSegments ) : 0.0;
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void minSnapTrajectory::solve( const MatrixXf& _waypoints, const VectorXf& _segmentTimes, float _startTime )
+{
+    if ( _waypoints.rows() != 3 || _waypoints.cols() < 2 )
+        throw std::invalid_argument("Trajectory requires at least two waypoints with 3 coordinates");
+
+    if ( _segmentTimes.size() != _waypoints.cols() - 1 || ( _segmentTimes.array() <= 0 ).any() )
+        throw std::invalid_argument("Trajectory requires a positive duration for each segment");
+
+    nSegments = _segmentTimes.size();
+    int n = nCoefficients*nSegments;
+
+    knots.resize( nSegments + 1 );
+    knots(0) = _startTime;
+    for ( int i=0; i<nSegments; ++i )
+        knots( i+1 ) = knots( i ) + _segmentTimes( i );
+
+    // Each segment i is p_i(s) = sum c_ik s^k with s = (t - t_i)/T_i. Constraints: waypoints
+    // at both ends of each segment, rest (velocity, acceleration, jerk) at the start and end,
+    // continuity of derivatives 1 to 6 at interior waypoints, which is the optimality condition
+    // of the minimum-snap problem. Rows are scaled to normalized time of the segment on the left.
+    std::vector<Triplet<double>> entries;
+    MatrixXd rhs = MatrixXd::Zero( n,3 );
+    int row = 0;
+
+    for ( int i=0; i<nSegments; ++i )
+    {
+        entries.push_back( Triplet<double>( row, nCoefficients*i, 1.0 ) );
+        rhs.row( row++ ) = _waypoints.col( i ).cast<double>().transpose();
+
+        for ( int k=0; k<nCoefficients; ++k )
+            entries.push_back( Triplet<double>( row, nCoefficients*i + k, 1.0 ) );
+        rhs.row( row++ ) = _waypoints.col( i+1 ).cast<double>().transpose();
+    }
+
+    for ( int d=1; d<=3; ++d )
+    {
+        entries.push_back( Triplet<double>( row++, d, falling( d,d ) ) );
+
+        for ( int k=d; k<nCoefficients; ++k )
+            entries.push_back( Triplet<double>( row, nCoefficients*( nSegments-1 ) + k, falling( k,d ) ) );
+        ++row;
+    }
+
+    for ( int i=1; i<nSegments; ++i )
+    {
+        double ratio = _segmentTimes( i-1 )/_segmentTimes( i );
+
+        for ( int d=1; d<=6; ++d )
+        {
+            for ( int k=d; k<nCoefficients; ++k )
+                entries.push_back( Triplet<double>( row, nCoefficients*( i-1 ) + k, falling( k,d ) ) );
+
+            entries.push_back( Triplet<double>( row, nCoefficients*i + d, -falling( d,d )*pow( ratio, d ) ) );
+            ++row;
+        }
+    }
+
+    SparseMatrix<double> A( n,n );
+    A.setFromTriplets( entries.begin(), entries.end() );
+
+    SparseLU<SparseMatrix<double>> solver;
+    solver.compute( A );
+    if ( solver.info() != Success )
+        throw std::invalid_argument("Unable to solve for minimum-snap trajectory");
+
+    MatrixXd c = solver.solve( rhs );
+
+    coefficients.resize( 3,n );
+    coefficients = c.transpose();
+    cursor = 0;
+}
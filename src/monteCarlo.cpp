@@ -0,0 +1,206 @@
+/**
+ *	\file src/monteCarlo.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+monteCarlo::monteCarlo( const scenario& _nominal, unsigned long _seed ) : nominal( _nominal ), seed( _seed )
+{
+    fieldNames.push_back( "run" );
+
+    // Only elements with a spread are stored per run
+    for ( const dispersion& d : nominal.dispersions )
+    {
+        if ( d.spread.size() != nominal.parameter( d.parameter ).size() )
+            throw std::invalid_argument("Dispersion of " + d.parameter + " has an incorrect number of elements");
+
+        for ( int j=0; j<d.spread.size(); ++j )
+        {
+            if ( d.spread(j) == 0 )
+                continue;
+
+            dispersed.push_back( { d.parameter, j } );
+            fieldNames.push_back( d.spread.size() == 1 ? d.parameter : d.parameter + "[" + std::to_string( j ) + "]" );
+        }
+    }
+
+    for ( const char* name : { "steps", "maxTilt", "maxPositionError", "rmsPositionError", "meanNEES" } )
+        fieldNames.push_back( name );
+}
+
+
+scenario monteCarlo::sample( unsigned long _run ) const
+{
+    scenario Scenario = nominal;
+
+    // Dispersion stream of the run, sensor and filter noise have their own streams keyed by
+    // the same seed and run number
+    randomStream stream( seed, _run, DISPERSION_STREAM );
+
+    for ( const dispersion& d : nominal.dispersions )
+    {
+        VectorXf deviation( d.spread.size() );
+
+        if ( d.distribution == NORMAL_DISTRIBUTION )
+            stream.normal( deviation );
+        else
+            stream.uniform( deviation, -1.0, 1.0 );
+
+        Scenario.parameter( d.parameter ) += d.spread.cwiseProduct( deviation );
+    }
+
+    Scenario.seed = seed;
+    Scenario.run = _run;
+    Scenario.name = nominal.name + "_" + std::to_string( _run );
+
+    return Scenario;
+}
+
+
+void monteCarlo::setForkTime( float _forkTime )
+{
+    if ( _forkTime >= nominal.finalTime )
+        throw std::invalid_argument("Fork time must be before the final time");
+
+    // Forked runs start from the state of the nominal flight, a dispersed initial state
+    // would be cataloged without having been flown
+    if ( _forkTime > nominal.initialTime )
+        for ( const dispersion& d : nominal.dispersions )
+            if ( d.parameter == "initialState" && !d.spread.isZero() )
+                throw std::invalid_argument("Dispersions of the initial state cannot be forked");
+
+    forkTime = _forkTime;
+}
+
+
+snapshot monteCarlo::prefix(  ) const
+{
+    if ( forkTime <= nominal.initialTime )
+        return snapshot( );
+
+    scenario Prefix = nominal;
+    Prefix.seed = seed;
+    Prefix.telemetry = false;
+
+    simulation Simulation( Prefix );
+    Simulation.setVerbose( false );
+
+    int forkStep = (int) round( ( forkTime - nominal.initialTime )/nominal.samplingTime );
+    while ( Simulation.iteration( ) < forkStep && Simulation.step( ) );
+
+    return Simulation.save( );
+}
+
+
+double monteCarlo::run( unsigned long _runs, unsigned int _nThreads, runCatalog* _catalog, resultCache* _cache,
+                        progressReporter* _progress )
+{
+    if ( _catalog && _catalog->fields() != fieldNames )
+        throw std::invalid_argument("Catalog fields do not match the Monte Carlo analysis");
+
+    uint64_t scenarioHash = runCatalog::hash( canonicalScenario( nominal ) );
+    values.assign( _runs, VectorXf() );
+    std::atomic<unsigned long> incompleteRuns{ 0 };
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Common prefix, flown once
+    snapshot Prefix = prefix( );
+    bool forked = Prefix.size() > 0;
+
+    if ( _progress )
+        _progress->start( _runs );
+
+    threadPool Pool( _nThreads );
+    Pool.parallelForEach( _runs, [&]( int _run )
+    {
+        scenario Scenario = sample( _run );
+        unsigned long id = 0;
+
+        Scenario.telemetry = Scenario.telemetry && _catalog;
+        if ( _catalog )
+        {
+            id = _catalog->beginRun( );
+            Scenario.outputDirectory = _catalog->runDirectory( id );
+        }
+
+        VectorXf metrics;
+        int steps;
+        bool complete = true;
+        progressCounter* counter = _progress ? &_progress->counter( _run ) : nullptr;
+
+        // The cache key does not cover the prefix of forked runs
+        resultCache* cache = forked ? nullptr : _cache;
+
+        if ( !cache || !cache->lookup( Scenario, metrics, steps ) )
+        {
+            simulation Simulation( Scenario );
+            Simulation.setVerbose( false );
+            Simulation.setProgress( counter );
+            if ( forked )
+                Simulation.restore( Prefix );
+
+            metrics = Simulation.run( );
+            steps = Simulation.iteration( );
+
+            // Incomplete telemetry is not persisted
+            complete = Simulation.dropped( ) == 0;
+            if ( !complete )
+                ++incompleteRuns;
+
+            if ( cache && complete )
+                cache->store( Scenario, metrics, steps );
+        }
+        else if ( counter )
+        {
+            counter->totalSteps.store( steps, std::memory_order_relaxed );
+            counter->steps.store( steps, std::memory_order_relaxed );
+            counter->finished.store( true, std::memory_order_release );
+        }
+
+        VectorXf& v = values[_run];
+        v.resize( fieldNames.size() );
+        v(0) = _run;
+        for ( size_t k=0; k<dispersed.size(); ++k )
+            v(k+1) = Scenario.parameter( dispersed[k].first )( dispersed[k].second );
+        v( dispersed.size()+1 ) = steps;
+        v.tail( 4 ) = metrics;
+
+        if ( _catalog && complete )
+            _catalog->addRun( id, Scenario.seed, scenarioHash, v );
+    } );
+
+    nIncomplete = incompleteRuns;
+
+    if ( _progress )
+        _progress->stop( );
+
+    return _runs / std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+
+const std::vector<std::string>& monteCarlo::fields(  ) const
+{
+    return fieldNames;
+}
+
+
+const std::vector<VectorXf>& monteCarlo::results(  ) const
+{
+    return values;
+}
+
+
+unsigned long monteCarlo::incomplete(  ) const
+{
+    return nIncomplete;
+}
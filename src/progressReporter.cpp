@@ -0,0 +1,157 @@
+/**
+ *	\file src/progressReporter.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+#include <unistd.h>
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+progressReporter::progressReporter( reportFormat _format, double _interval )
+{
+    if ( _interval <= 0 )
+        throw std::invalid_argument("Progress reports require a positive interval");
+
+    format = _format;
+    interval = _interval;
+    terminal = isatty( STDERR_FILENO );
+}
+
+
+progressReporter::~progressReporter(  )
+{
+    stop( );
+}
+
+
+void progressReporter::start( unsigned long _runs )
+{
+    stop( );
+
+    counters.reset( new progressCounter[_runs] );
+    nRuns = _runs;
+    startTime = std::chrono::steady_clock::now();
+
+    running = true;
+    thread = std::thread( &progressReporter::reporter, this );
+}
+
+
+progressCounter& progressReporter::counter( unsigned long _run )
+{
+    if ( _run >= nRuns )
+        throw std::invalid_argument("Run " + std::to_string( _run ) + " has no progress counter");
+
+    return counters[_run];
+}
+
+
+void progressReporter::stop(  )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( !running )
+            return;
+        running = false;
+    }
+    wake.notify_all();
+    thread.join();
+
+    report( true );
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void progressReporter::reporter(  )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+
+    while ( !wake.wait_for( lock, std::chrono::duration<double>( interval ), [this](){ return !running; } ) )
+        report( false );
+}
+
+
+void progressReporter::report( bool _final )
+{
+    double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+
+    // Sample the counters, the steps of runs that have not started are estimated from the
+    // length of the finished runs, or the length to the final time of the started runs
+    unsigned long finished = 0, started = 0;
+    double steps = 0, remaining = 0, finishedSteps = 0, startedSteps = 0;
+
+    for ( unsigned long k=0; k<nRuns; ++k )
+    {
+        const progressCounter& c = counters[k];
+        bool done = c.finished.load( std::memory_order_acquire );
+        int taken = c.steps.load( std::memory_order_relaxed );
+        int total = c.totalSteps.load( std::memory_order_relaxed );
+
+        steps += taken;
+        if ( done )
+        {
+            ++finished;
+            finishedSteps += taken;
+        }
+        else if ( total > 0 )
+        {
+            ++started;
+            startedSteps += total;
+            remaining += std::max( 0, total - taken );
+        }
+    }
+
+    unsigned long waiting = nRuns - finished - started;
+    if ( finished > 0 )
+        remaining += waiting*finishedSteps/finished;
+    else if ( started > 0 )
+        remaining += waiting*startedSteps/started;
+
+    double fraction = steps + remaining > 0 ? steps/( steps + remaining ) : ( finished == nRuns ? 1.0 : 0.0 );
+    double simsPerSecond = elapsed > 0 ? finished/elapsed : 0.0;
+    double stepsPerSecond = elapsed > 0 ? steps/elapsed : 0.0;
+    double eta = _final ? 0.0 : stepsPerSecond > 0 ? remaining/stepsPerSecond : -1.0;
+
+    // Each report is written at once, so that reports do not interleave with other output
+    char line[256];
+    if ( format == JSON_REPORT )
+    {
+        // The time to completion is null until the first step has been taken
+        char etaText[32] = "null";
+        if ( eta >= 0 )
+            snprintf( etaText, sizeof( etaText ), "%.3f", eta );
+
+        snprintf( line, sizeof( line ), "{\"elapsed\":%.3f,\"runs\":%lu,\"finished\":%lu,\"steps\":%.0f,\"progress\":%.4f,"
+                  "\"simsPerSecond\":%.3f,\"stepsPerSecond\":%.0f,\"eta\":%s,\"final\":%s}\n",
+                  elapsed, nRuns, finished, steps, fraction, simsPerSecond, stepsPerSecond, etaText, _final ? "true" : "false" );
+    }
+    else
+    {
+        char timeText[32];
+        if ( _final )
+            snprintf( timeText, sizeof( timeText ), "elapsed %.0f s", elapsed );
+        else if ( eta < 0 )
+            snprintf( timeText, sizeof( timeText ), "ETA -" );
+        else
+            snprintf( timeText, sizeof( timeText ), "ETA %.0f s", eta );
+
+        // On a terminal the report is rewritten in place until the final report
+        snprintf( line, sizeof( line ), "%sProgress: %lu/%lu runs, %.1f %%, %.2f sims/s, %.0f steps/s, %s%s%s",
+                  terminal ? "\r" : "", finished, nRuns, 100*fraction, simsPerSecond, stepsPerSecond, timeText,
+                  terminal ? "\033[K" : "", terminal && !_final ? "" : "\n" );
+    }
+
+    std::cerr << line << std::flush;
+}
@@ -0,0 +1,238 @@
+/**
+ *	\file src/randomStream.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+/** Mix 64 bits (splitmix64 finalizer)
+ */
+static uint64_t mix( uint64_t _x )
+{
+    _x = ( _x ^ ( _x >> 30 ) )*0xBF58476D1CE4E5B9ull;
+    _x = ( _x ^ ( _x >> 27 ) )*0x94D049BB133111EBull;
+    return _x ^ ( _x >> 31 );
+}
+
+
+/** Philox4x32-10 of consecutive counter blocks, four numbers per block. The loop over blocks
+ *  has no dependencies, so the compiler can vectorize it.
+ */
+static void philox( const uint32_t _key[2], uint32_t _block, uint64_t _tick, uint32_t _component, int _nBlocks, uint32_t* _out )
+{
+    for ( int b=0; b<_nBlocks; ++b )
+    {
+        uint32_t c0 = _block + b, c1 = (uint32_t) _tick, c2 = (uint32_t)( _tick >> 32 ), c3 = _component;
+        uint32_t k0 = _key[0], k1 = _key[1];
+
+        for ( int round=0; round<10; ++round )
+        {
+            uint64_t p0 = (uint64_t) 0xD2511F53u*c0;
+            uint64_t p1 = (uint64_t) 0xCD9E8D57u*c2;
+
+            c0 = (uint32_t)( p1 >> 32 ) ^ c1 ^ k0;
+            c2 = (uint32_t)( p0 >> 32 ) ^ c3 ^ k1;
+            c1 = (uint32_t) p1;
+            c3 = (uint32_t) p0;
+
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+
+        _out[4*b] = c0; _out[4*b+1] = c1; _out[4*b+2] = c2; _out[4*b+3] = c3;
+    }
+}
+
+
+/** Uniform number in (0,1) of the upper 24 bits of a raw number
+ */
+static float toUnit( uint32_t _raw )
+{
+    return ( ( _raw >> 8 ) + 0.5f )*( 1.0f/16777216.0f );
+}
+
+
+/** Inverse of the standard normal distribution function (Acklam), relative error below 1.2e-9
+ */
+static double inverseNormal( double _p )
+{
+    static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00 };
+
+    if ( _p < 0.02425 )
+    {
+        double q = sqrt( -2*log( _p ) );
+        return ( ((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5] )/( (((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1 );
+    }
+
+    if ( _p > 1 - 0.02425 )
+        return -inverseNormal( 1 - _p );
+
+    double q = _p - 0.5, r = q*q;
+    return ( ((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5] )*q/( ((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1 );
+}
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+randomStream::randomStream(  ) : randomStream( 1, 0, 0 ) {}
+
+
+randomStream::randomStream( uint64_t _seed, uint64_t _run, uint32_t _component )
+{
+    uint64_t k = mix( mix( _seed ) ^ _run );
+    key[0] = (uint32_t) k;
+    key[1] = (uint32_t)( k >> 32 );
+    component = _component;
+}
+
+
+void randomStream::seek( uint64_t _tick )
+{
+    tick = _tick;
+    block = 0;
+    buffered = 0;
+}
+
+
+float randomStream::uniform(  )
+{
+    uint32_t raw;
+    next( &raw, 1 );
+    return ( raw >> 8 )*( 1.0f/16777216.0f );
+}
+
+
+float randomStream::normal(  )
+{
+    float value;
+    normal( Map<VectorXf>( &value, 1 ) );
+    return value;
+}
+
+
+void randomStream::uniform( Ref<VectorXf> _values, float _low, float _high )
+{
+    Array<uint32_t,Dynamic,1> raw( _values.size() );
+    next( raw.data(), raw.size() );
+
+    _values = ( _low + ( _high - _low )*( raw.unaryExpr( []( uint32_t _r ){ return _r >> 8; } ).cast<float>()*( 1.0f/16777216.0f ) ) ).matrix();
+}
+
+
+void randomStream::normal( Ref<VectorXf> _values, float _mean, float _std )
+{
+    int n = _values.size();
+    int nPairs = ( n + 1 )/2;
+
+    // Each pair of numbers gives two normal numbers
+    Array<uint32_t,Dynamic,1> raw( 2*nPairs );
+    next( raw.data(), raw.size() );
+
+    ArrayXf radius( nPairs ), angle( nPairs );
+    for ( int k=0; k<nPairs; ++k )
+    {
+        radius(k) = toUnit( raw(2*k) );
+        angle(k) = toUnit( raw(2*k+1) );
+    }
+
+    radius = ( -2*radius.log() ).sqrt()*_std;
+    angle *= 2*M_PI;
+
+    ArrayXf cosine = radius*angle.cos() + _mean;
+    ArrayXf sine = radius*angle.sin() + _mean;
+
+    for ( int k=0; k<n; ++k )
+        _values(k) = k%2 == 0 ? cosine( k/2 ) : sine( k/2 );
+}
+
+
+void randomStream::truncatedNormal( Ref<VectorXf> _values, float _mean, float _std, float _low, float _high )
+{
+    if ( _std <= 0 || _low >= _high )
+        throw std::invalid_argument("Truncated normal distribution requires a positive standard deviation and interval");
+
+    // Work in the lower tail, where the distribution function is accurate
+    double a = ( _low - _mean )/_std, b = ( _high - _mean )/_std;
+    double sign = 1.0;
+    if ( a > 0 )
+    {
+        std::swap( a,b );
+        a = -a; b = -b;
+        sign = -1.0;
+    }
+
+    double pa = 0.5*erfc( -a/M_SQRT2 ), pb = 0.5*erfc( -b/M_SQRT2 );
+
+    Array<uint32_t,Dynamic,1> raw( _values.size() );
+    next( raw.data(), raw.size() );
+
+    for ( int k=0; k<_values.size(); ++k )
+    {
+        double x = inverseNormal( pa + toUnit( raw(k) )*( pb - pa ) );
+        _values(k) = _mean + _std*sign*std::min( b, std::max( a, x ) );
+    }
+}
+
+
+
+void randomStream::save( snapshot& _snapshot ) const
+{
+    _snapshot.write( tick );
+    _snapshot.write( block );
+    _snapshot.write( buffered );
+}
+
+
+void randomStream::restore( snapshot& _snapshot )
+{
+    _snapshot.read( tick );
+    _snapshot.read( block );
+    _snapshot.read( buffered );
+
+    if ( buffered < 0 || buffered > 4 || ( buffered > 0 && block == 0 ) )
+        throw std::invalid_argument("Snapshot holds an invalid random stream position");
+
+    // Remainder of the last block, drawn with the key of this stream
+    if ( buffered > 0 )
+        philox( key, block - 1, tick, component, 1, buffer );
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void randomStream::next( uint32_t* _values, int _n )
+{
+    int k = 0;
+
+    // Remainder of the last block
+    while ( buffered > 0 && k < _n )
+        _values[k++] = buffer[4 - buffered--];
+
+    // Whole blocks
+    int nBlocks = ( _n - k )/4;
+    philox( key, block, tick, component, nBlocks, _values + k );
+    block += nBlocks;
+    k += 4*nBlocks;
+
+    // Start of a new block
+    if ( k < _n )
+    {
+        philox( key, block++, tick, component, 1, buffer );
+        buffered = 4;
+
+        while ( k < _n )
+            _values[k++] = buffer[4 - buffered--];
+    }
+}
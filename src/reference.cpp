@@ -0,0 +1,27 @@
+/**
+ *	\file src/reference.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+reference::reference(  ) {}
+
+
+reference::~reference(  ) {}
+
+
+VectorXf reference::value( float _time )
+{
+    VectorXf value, rate, acceleration;
+    evaluate( _time, value, rate, acceleration );
+
+    return value;
+}
@@ -0,0 +1,269 @@
+/**
+ *	\file src/resultCache.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+#include <sstream>
+#include <unistd.h>
+
+
+#include "simulatorVersion.h"    // Version of the simulator code, generated by the build
+
+static const char resultMagic[8] = { 'T','V','C','R','E','S',0,0 };
+
+
+/** Canonical description of a scenario and the simulator version
+ */
+static std::string describe( const scenario& _scenario )
+{
+    return canonicalScenario( _scenario ) + "version = " + SIMULATOR_VERSION + "\n";
+}
+
+
+/** Directory name of a key
+ */
+static std::string keyName( uint64_t _key )
+{
+    char name[17];
+    snprintf( name, sizeof( name ), "%016llx", (unsigned long long) _key );
+    return name;
+}
+
+
+/** Size of the files in a directory [bytes]
+ */
+static uintmax_t directorySize( const std::filesystem::path& _directory )
+{
+    uintmax_t size = 0;
+    std::error_code error;
+
+    for ( const auto& entry : std::filesystem::directory_iterator( _directory, error ) )
+        if ( entry.is_regular_file( error ) )
+            size += entry.file_size( error );
+
+    return size;
+}
+
+
+/** Copy telemetry files, and their level-of-detail pyramids, between directories
+ */
+static void copyTelemetry( const std::filesystem::path& _from, const std::filesystem::path& _to )
+{
+    for ( const auto& entry : std::filesystem::directory_iterator( _from ) )
+        if ( entry.path().extension() == ".tlm" )
+            std::filesystem::copy_file( entry.path(), _to / entry.path().filename(), std::filesystem::copy_options::overwrite_existing );
+}
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+resultCache::resultCache( std::string _directory, uintmax_t _maxSize )
+{
+    directory = _directory;
+    maxSize = _maxSize;
+    std::filesystem::create_directories( directory );
+
+    // Results left half-written by an interrupted process are removed after an hour
+    auto stale = std::filesystem::file_time_type::clock::now() - std::chrono::hours( 1 );
+
+    for ( const auto& entry : std::filesystem::directory_iterator( directory ) )
+    {
+        if ( entry.path().filename().string().compare( 0, 4, "tmp-" ) == 0 )
+        {
+            if ( std::filesystem::last_write_time( entry.path() ) < stale )
+                std::filesystem::remove_all( entry.path() );
+        }
+        else if ( entry.is_directory() )
+            totalSize += directorySize( entry.path() );
+    }
+
+    // The size may have been reduced since the cache was last used
+    evict( );
+}
+
+
+bool resultCache::lookup( const scenario& _scenario, VectorXf& _metrics, int& _steps )
+{
+    std::string description = describe( _scenario );
+    std::filesystem::path entry = std::filesystem::path( directory ) / keyName( runCatalog::hash( description ) );
+
+    try
+    {
+        std::ifstream file( entry / "result.bin", std::ios::binary );
+        std::ifstream stored( entry / "scenario.txt", std::ios::binary );
+
+        std::ostringstream storedDescription;
+        storedDescription << stored.rdbuf();
+
+        char magic[8];
+        int32_t dims[2];
+
+        // The stored description guards against hash collisions
+        if ( !file || !file.read( magic, 8 ) || std::memcmp( magic, resultMagic, 8 ) != 0 || storedDescription.str() != description ||
+             !file.read( (char*) dims, sizeof( dims ) ) )
+        {
+            ++nMisses;
+            return false;
+        }
+
+        VectorXf metrics( dims[1] );
+        if ( !file.read( (char*) metrics.data(), sizeof( float )*dims[1] ) )
+        {
+            ++nMisses;
+            return false;
+        }
+
+        if ( _scenario.telemetry )
+        {
+            std::filesystem::create_directories( _scenario.outputDirectory );
+            copyTelemetry( entry, _scenario.outputDirectory );
+        }
+
+        // Most recently used results are evicted last
+        std::filesystem::last_write_time( entry / "result.bin", std::filesystem::file_time_type::clock::now() );
+
+        _steps = dims[0];
+        _metrics = metrics;
+    }
+    catch ( const std::filesystem::filesystem_error& )
+    {
+        // Evicted while being restored
+        ++nMisses;
+        return false;
+    }
+
+    ++nHits;
+    return true;
+}
+
+
+void resultCache::store( const scenario& _scenario, const Ref<const VectorXf>& _metrics, int _steps )
+{
+    static std::atomic<unsigned long> nextTemporary{ 0 };
+
+    std::string description = describe( _scenario );
+    std::string name = keyName( runCatalog::hash( description ) );
+    std::filesystem::path entry = std::filesystem::path( directory ) / name;
+
+    if ( std::filesystem::exists( entry ) )
+        return;
+
+    // Results are written to a temporary directory and renamed, so that a result is
+    // either complete or absent for other threads and processes
+    std::filesystem::path temporary = std::filesystem::path( directory ) / ( "tmp-" + name + "-" + std::to_string( getpid() ) + "-" + std::to_string( nextTemporary++ ) );
+    std::filesystem::create_directories( temporary );
+
+    if ( _scenario.telemetry )
+        copyTelemetry( _scenario.outputDirectory, temporary );
+
+    std::ofstream( temporary / "scenario.txt", std::ios::binary ) << description;
+
+    std::ofstream file( temporary / "result.bin", std::ios::binary );
+    int32_t dims[2] = { _steps, (int32_t) _metrics.size() };
+    VectorXf metrics = _metrics;
+
+    file.write( resultMagic, 8 );
+    file.write( (const char*) dims, sizeof( dims ) );
+    file.write( (const char*) metrics.data(), sizeof( float )*metrics.size() );
+    file.close();
+
+    if ( !file )
+    {
+        std::filesystem::remove_all( temporary );
+        throw std::runtime_error("Unable to write result to cache " + directory);
+    }
+
+    std::error_code error;
+    std::filesystem::rename( temporary, entry, error );
+
+    // Stored by another thread or process in the meantime
+    if ( error )
+    {
+        std::filesystem::remove_all( temporary );
+        return;
+    }
+
+    if ( ( totalSize += directorySize( entry ) ) > maxSize )
+        evict( );
+}
+
+
+void resultCache::evict(  )
+{
+    std::lock_guard<std::mutex> guard( lock );
+
+    if ( totalSize <= maxSize )
+        return;
+
+    struct cacheEntry
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type used;
+        uintmax_t size;
+    };
+
+    std::vector<cacheEntry> entries;
+    uintmax_t size = 0;
+    std::error_code error;
+
+    for ( const auto& entry : std::filesystem::directory_iterator( directory ) )
+    {
+        if ( !entry.is_directory( error ) || entry.path().filename().string().compare( 0, 4, "tmp-" ) == 0 )
+            continue;
+
+        cacheEntry e{ entry.path(), std::filesystem::last_write_time( entry.path() / "result.bin", error ), directorySize( entry.path() ) };
+        if ( error )
+            e.used = std::filesystem::file_time_type::min();
+
+        entries.push_back( e );
+        size += e.size;
+    }
+
+    // Least recently used first
+    std::sort( entries.begin(), entries.end(), []( const cacheEntry& _a, const cacheEntry& _b ){ return _a.used < _b.used; } );
+
+    for ( size_t k=0; k<entries.size() && size > maxSize; ++k )
+    {
+        std::filesystem::remove_all( entries[k].path, error );
+        size -= entries[k].size;
+    }
+
+    totalSize = size;
+}
+
+
+unsigned long resultCache::hits(  ) const
+{
+    return nHits;
+}
+
+
+unsigned long resultCache::misses(  ) const
+{
+    return nMisses;
+}
+
+
+uintmax_t resultCache::size(  ) const
+{
+    return totalSize;
+}
+
+
+uint64_t resultCache::key( const scenario& _scenario )
+{
+    return runCatalog::hash( describe( _scenario ) );
+}
+
+
+const char* resultCache::version(  )
+{
+    return SIMULATOR_VERSION;
+}
@@ -0,0 +1,366 @@
+/**
+ *	\file src/runCatalog.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+#ifndef _WIN32
+#include <fcntl.h>              // advisory lock of the index
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+
+static const char catalogMagic[8] = { 'T','V','C','R','U','N','S',0 };
+static const uint32_t catalogVersion = 1;
+
+static const int headerSize = 64;           // Size of index header [bytes]
+static const int fieldSize = 32;            // Size of field name entry [bytes]
+static const int runsOffset = 24;           // Offset of number of runs in header [bytes]
+static const int keySize = 24;              // Size of id, seed and scenario hash of a record [bytes]
+
+
+/** Condition on a catalog field
+ */
+struct runCondition
+{
+    int field;                  // Field index, -1 for the run number
+    std::string op;             // Comparison operator
+    double value;               // Value compared with
+};
+
+
+/** Value of a field of an index record
+ */
+static double recordValue( const char* _record, int _field )
+{
+    if ( _field < 0 )
+    {
+        uint64_t id;
+        std::memcpy( &id, _record, 8 );
+        return id;
+    }
+
+    float value;
+    std::memcpy( &value, _record + keySize + 4*_field, 4 );
+    return value;
+}
+
+
+static bool compare( double _a, const std::string& _op, double _b )
+{
+    if ( _op == "<" )  return _a < _b;
+    if ( _op == "<=" ) return _a <= _b;
+    if ( _op == ">" )  return _a > _b;
+    if ( _op == ">=" ) return _a >= _b;
+    if ( _op == "==" ) return _a == _b;
+    return _a != _b;
+}
+
+
+static std::string trim( const std::string& _text )
+{
+    size_t first = _text.find_first_not_of( " \t" );
+    size_t last = _text.find_last_not_of( " \t" );
+    return first == std::string::npos ? "" : _text.substr( first, last - first + 1 );
+}
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+runCatalog::runCatalog( std::string _directory, const std::vector<std::string>& _fields )
+{
+    directory = _directory;
+    std::filesystem::create_directories( directory );
+
+    std::string indexName = directory + "/catalog.idx";
+
+    if ( std::filesystem::exists( indexName ) )
+    {
+        // Existing catalog
+        mappedFile Map( indexName );
+
+        uint32_t dims[3];
+        if ( Map.size() < headerSize || std::memcmp( Map.data(), catalogMagic, 8 ) != 0 )
+            throw std::invalid_argument("Not a run catalog: " + indexName);
+
+        std::memcpy( dims, Map.data() + 8, sizeof( dims ) );
+        std::memcpy( &nRuns, Map.data() + runsOffset, 8 );
+
+        if ( dims[0] != catalogVersion )
+            throw std::invalid_argument("Unsupported run catalog version in " + indexName);
+
+        recordSize = dims[2];
+        dataOffset = headerSize + fieldSize*dims[1];
+
+        if ( Map.size() < dataOffset + nRuns*recordSize )
+            throw std::invalid_argument("Run catalog index is truncated: " + indexName);
+
+        for ( uint32_t i=0; i<dims[1]; ++i )
+        {
+            const char* entry = Map.data() + headerSize + fieldSize*i;
+            fieldNames.push_back( std::string( entry, strnlen( entry, fieldSize ) ) );
+        }
+
+        if ( !_fields.empty() && _fields != fieldNames )
+            throw std::invalid_argument("Fields do not match the fields of run catalog " + indexName);
+
+        for ( unsigned long i=0; i<nRuns; ++i )
+            nextId = std::max( nextId.load(), (unsigned long) recordValue( Map.data() + dataOffset + i*recordSize, -1 ) + 1 );
+
+        // Records after the last complete run are overwritten by the next run
+        Index.open( indexName, std::ios::binary | std::ios::in | std::ios::out );
+    }
+    else
+    {
+        // New catalog, records are padded to a multiple of 8 bytes
+        if ( _fields.empty() )
+            throw std::invalid_argument("Fields are required to create run catalog " + indexName);
+
+        fieldNames = _fields;
+        recordSize = ( keySize + 4*fieldNames.size() + 7 )/8*8;
+        dataOffset = headerSize + fieldSize*fieldNames.size();
+
+        Index.open( indexName, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc );
+        if ( !Index )
+            throw std::invalid_argument("Unable to create run catalog " + indexName);
+
+        uint32_t dims[3] = { catalogVersion, (uint32_t) fieldNames.size(), (uint32_t) recordSize };
+
+        char header[headerSize] = {};
+        std::memcpy( header, catalogMagic, 8 );
+        std::memcpy( header + 8, dims, sizeof( dims ) );
+        Index.write( header, headerSize );
+
+        for ( const std::string& name : fieldNames )
+        {
+            if ( name.size() >= fieldSize )
+                throw std::invalid_argument("Run catalog field name too long: " + name);
+
+            char entry[fieldSize] = {};
+            std::memcpy( entry, name.data(), name.size() );
+            Index.write( entry, fieldSize );
+        }
+        Index.flush();
+    }
+
+    if ( !Index )
+        throw std::invalid_argument("Unable to open run catalog " + indexName);
+
+#ifndef _WIN32
+    lockFile = open( indexName.c_str(), O_RDWR );
+    if ( lockFile < 0 )
+        throw std::invalid_argument("Unable to open run catalog " + indexName);
+#endif
+}
+
+
+runCatalog::~runCatalog(  )
+{
+#ifndef _WIN32
+    if ( lockFile >= 0 )
+        close( lockFile );
+#endif
+}
+
+
+unsigned long runCatalog::beginRun(  )
+{
+    // Skip directories of runs reserved but never added to the index
+    unsigned long id = nextId++;
+
+    while ( !std::filesystem::create_directory( runDirectory( id ) ) )
+        id = nextId++;
+
+    return id;
+}
+
+
+std::string runCatalog::runDirectory( unsigned long _id ) const
+{
+    std::string number = std::to_string( _id );
+    return directory + "/run" + std::string( number.size() < 6 ? 6 - number.size() : 0, '0' ) + number;
+}
+
+
+void runCatalog::addRun( unsigned long _id, uint64_t _seed, uint64_t _scenarioHash, const Ref<const VectorXf>& _values )
+{
+    if ( _values.size() != (int) fieldNames.size() )
+        throw std::invalid_argument("Incorrect number of fields given to run catalog");
+
+    std::vector<char> record( recordSize, 0 );
+    uint64_t key[3] = { _id, _seed, _scenarioHash };
+    std::memcpy( record.data(), key, keySize );
+    for ( int i=0; i<_values.size(); ++i )
+    {
+        float value = _values(i);
+        std::memcpy( record.data() + keySize + 4*i, &value, 4 );
+    }
+
+    std::lock_guard<std::mutex> guard( lock );
+
+    // Other processes may append to the same index, so the run count is read again
+    // while the index is locked
+#ifndef _WIN32
+    if ( flock( lockFile, LOCK_EX ) != 0 )
+        throw std::invalid_argument("Unable to lock run catalog " + directory + "/catalog.idx");
+#endif
+
+    Index.seekg( runsOffset );
+    Index.read( (char*) &nRuns, 8 );
+
+    // Record first, run count last, so readers never see an incomplete record
+    Index.seekp( dataOffset + nRuns*recordSize );
+    Index.write( record.data(), recordSize );
+    Index.flush();
+
+    ++nRuns;
+    Index.seekp( runsOffset );
+    Index.write( (const char*) &nRuns, 8 );
+    Index.flush();
+
+#ifndef _WIN32
+    flock( lockFile, LOCK_UN );
+#endif
+
+    if ( !Index )
+        throw std::invalid_argument("Unable to write run catalog " + directory + "/catalog.idx");
+}
+
+
+std::vector<runRecord> runCatalog::query( const std::string& _condition, const std::string& _orderBy, bool _descending, size_t _limit ) const
+{
+    // Parse conditions
+    std::vector<runCondition> conditions;
+    size_t begin = 0;
+
+    while ( begin < _condition.size() )
+    {
+        size_t end = _condition.find( " and ", begin );
+        std::string clause = _condition.substr( begin, end == std::string::npos ? std::string::npos : end - begin );
+        begin = end == std::string::npos ? _condition.size() : end + 5;
+
+        size_t opBegin = clause.find_first_of( "<>=!" );
+        size_t opEnd = clause.find_first_not_of( "<>=!", opBegin );
+        if ( trim( clause ).empty() )
+            continue;
+        if ( opBegin == std::string::npos || opEnd == std::string::npos )
+            throw std::invalid_argument("Invalid run catalog condition: " + clause);
+
+        runCondition condition;
+        std::string field = trim( clause.substr( 0, opBegin ) );
+        condition.field = field == "id" ? -1 : fieldIndex( field );
+        condition.op = clause.substr( opBegin, opEnd - opBegin );
+
+        if ( condition.op != "<" && condition.op != "<=" && condition.op != ">" && condition.op != ">=" && condition.op != "==" && condition.op != "!=" )
+            throw std::invalid_argument("Invalid operator in run catalog condition: " + clause);
+
+        try
+        {
+            condition.value = std::stod( clause.substr( opEnd ) );
+        }
+        catch ( const std::exception& )
+        {
+            throw std::invalid_argument("Invalid value in run catalog condition: " + clause);
+        }
+
+        conditions.push_back( condition );
+    }
+
+    int orderField = _orderBy.empty() ? 0 : _orderBy == "id" ? -1 : fieldIndex( _orderBy );
+
+    // Scan the index, runs added by other processes are included
+    std::lock_guard<std::mutex> guard( lock );
+    mappedFile Map( directory + "/catalog.idx" );
+
+    uint64_t n;
+    std::memcpy( &n, Map.data() + runsOffset, 8 );
+    n = std::min( n, (uint64_t) ( Map.size() - dataOffset )/recordSize );
+
+    std::vector<const char*> selection;
+
+    for ( uint64_t i=0; i<n; ++i )
+    {
+        const char* record = Map.data() + dataOffset + i*recordSize;
+        bool match = true;
+
+        for ( const runCondition& condition : conditions )
+            match = match && compare( recordValue( record, condition.field ), condition.op, condition.value );
+
+        if ( match )
+            selection.push_back( record );
+    }
+
+    // Sort, only the runs returned are ordered when a limit is given
+    size_t count = _limit > 0 ? std::min( _limit, selection.size() ) : selection.size();
+
+    if ( !_orderBy.empty() )
+    {
+        auto order = [&]( const char* a, const char* b )
+        {
+            double va = recordValue( a, orderField ), vb = recordValue( b, orderField );
+            return _descending ? va > vb : va < vb;
+        };
+        std::partial_sort( selection.begin(), selection.begin() + count, selection.end(), order );
+    }
+
+    std::vector<runRecord> result( count );
+
+    for ( size_t i=0; i<count; ++i )
+    {
+        uint64_t key[3];
+        std::memcpy( key, selection[i], keySize );
+
+        result[i].id = key[0];
+        result[i].seed = key[1];
+        result[i].scenarioHash = key[2];
+        result[i].values.resize( fieldNames.size() );
+        std::memcpy( result[i].values.data(), selection[i] + keySize, 4*fieldNames.size() );
+        result[i].directory = runDirectory( key[0] );
+    }
+
+    return result;
+}
+
+
+unsigned long runCatalog::runs(  ) const
+{
+    std::lock_guard<std::mutex> guard( lock );
+    return nRuns;
+}
+
+
+const std::vector<std::string>& runCatalog::fields(  ) const
+{
+    return fieldNames;
+}
+
+
+int runCatalog::fieldIndex( const std::string& _name ) const
+{
+    for ( size_t i=0; i<fieldNames.size(); ++i )
+        if ( fieldNames[i] == _name )
+            return i;
+
+    throw std::invalid_argument("Unknown run catalog field: " + _name);
+}
+
+
+uint64_t runCatalog::hash( const std::string& _text )
+{
+    uint64_t h = 14695981039346656037ull;
+
+    for ( unsigned char c : _text )
+    {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+
+    return h;
+}
@@ -0,0 +1,218 @@
+/**
+ *	\file src/runDiff.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+static const char binaryMagic[4] = { 'T','V','C','M' };     // Binary matrix file, see saveToBinary
+static const uint32_t binaryVersion = 1;
+
+
+/** Run output read in blocks of samples from a file mapped once: a telemetry file, a binary
+ *  matrix file or a CSV file, the matrix files with one row per channel
+ */
+struct runSource
+{
+    std::string fileName;                       // Name of run file
+    std::unique_ptr<mappedFile> file;           // Mapped matrix file
+    std::unique_ptr<telemetryReader> reader;    // Telemetry file, if any
+    const float* matrix = nullptr;              // Binary matrix in the mapped file, column-major
+    std::vector<const char*> cursor;            // CSV, next value of each row
+    std::vector<const char*> lineEnd;           // CSV, end of each row
+
+    int nChannels = 0;                          // Number of channels of a matrix file
+    unsigned long nSamples = 0;                 // Number of samples of a matrix file
+    unsigned long position = 0;                 // CSV, next sample to be parsed
+
+    int channels( ) const { return reader ? reader->channels() : nChannels; }
+    unsigned long samples( ) const { return reader ? reader->samples() : nSamples; }
+
+    std::string name( int _index ) const
+    {
+        return reader ? reader->channelInfo( _index ).name : "row " + std::to_string( _index );
+    }
+
+    /** Read samples [_first, _first+_count) of all channels, CSV files in increasing order only
+     */
+    void read( unsigned long _first, unsigned long _count, MatrixXf& _block )
+    {
+        if ( reader )
+            reader->block( _first, _count, _block );
+        else if ( matrix )
+            _block = Map<const MatrixXf>( matrix, nChannels, nSamples ).middleCols( _first, _count );
+        else
+        {
+            if ( _first != position )
+                throw std::invalid_argument("CSV run " + fileName + " is read in order");
+
+            _block.resize( nChannels, _count );
+            for ( int i=0; i<nChannels; ++i )
+                for ( unsigned long j=0; j<_count; ++j )
+                    _block( i,j ) = parseValue( i, position + j );
+            position += _count;
+        }
+    }
+
+    /** Parse next value of a CSV row
+     */
+    float parseValue( int _row, unsigned long _sample )
+    {
+        const char*& p = cursor[_row];
+        const char* end = lineEnd[_row];
+
+        while ( p < end && ( *p == ' ' || *p == '\t' ) ) ++p;
+        if ( p < end && *p == '+' ) ++p;
+
+        float value;
+        std::from_chars_result result = std::from_chars( p, end, value );
+        if ( result.ec != std::errc() )
+            throw std::invalid_argument("Invalid entry in row " + std::to_string( _row+1 ) + " of " + fileName);
+        p = result.ptr;
+
+        while ( p < end && ( *p == ' ' || *p == '\t' || *p == '\r' ) ) ++p;
+
+        bool last = _sample + 1 == nSamples;
+        if ( last ? p != end : ( p == end || *p != ',' ) )
+            throw std::invalid_argument("Inconsistent number of columns in row " + std::to_string( _row+1 ) + " of " + fileName);
+        if ( !last )
+            ++p;
+
+        return value;
+    }
+};
+
+
+static void openRun( const std::string& _fileName, runSource& _source )
+{
+    _source.fileName = _fileName;
+    _source.file.reset( new mappedFile( _fileName ) );
+
+    const char* data = _source.file->data();
+    size_t size = _source.file->size();
+
+    if ( size >= 6 && std::memcmp( data, "TVCLOG", 6 ) == 0 )
+    {
+        _source.file.reset( );
+        _source.reader.reset( new telemetryReader( _fileName ) );
+    }
+    else if ( size >= 4 && std::memcmp( data, binaryMagic, 4 ) == 0 )
+    {
+        // Samples are used in place in the mapped file
+        uint32_t header[4];
+        if ( size < sizeof( header ) )
+            throw std::invalid_argument("Truncated header in " + _fileName);
+        std::memcpy( header, data, sizeof( header ) );
+
+        if ( header[1] != binaryVersion )
+            throw std::invalid_argument("Unsupported binary matrix format in " + _fileName);
+        if ( size < sizeof( header ) + (size_t) header[2]*header[3]*sizeof( float ) )
+            throw std::invalid_argument("Truncated data in " + _fileName);
+
+        _source.nChannels = header[2];
+        _source.nSamples = header[3];
+        _source.matrix = (const float*) ( data + sizeof( header ) );
+    }
+    else
+    {
+        // Rows of a CSV file are parsed block by block as the samples are compared
+        const char* end = data + size;
+        for ( const char* p = data; p < end; )
+        {
+            const char* eol = std::find( p, end, '\n' );
+            if ( std::find_if( p, eol, []( char c ){ return c != '\r'; } ) != eol )
+            {
+                _source.cursor.push_back( p );
+                _source.lineEnd.push_back( eol );
+            }
+            p = eol + 1;
+        }
+
+        _source.nChannels = _source.cursor.size();
+        if ( _source.nChannels > 0 )
+            _source.nSamples = std::count( _source.cursor[0], _source.lineEnd[0], ',' ) + 1;
+    }
+}
+
+
+
+runDifference compareRuns( std::string _fileA, std::string _fileB, float _absTol, float _relTol, unsigned long _blockSamples )
+{
+    runSource A, B;
+    openRun( _fileA, A );
+    openRun( _fileB, B );
+
+    if ( A.channels() != B.channels() )
+        throw std::invalid_argument("Runs " + _fileA + " and " + _fileB + " have a different number of channels");
+
+    if ( _blockSamples < 1 )
+        throw std::invalid_argument("Runs are compared in blocks of at least one sample");
+
+    int nChannels = A.channels();
+
+    runDifference difference;
+    difference.samplesA = A.samples();
+    difference.samplesB = B.samples();
+    difference.compared = std::min( difference.samplesA, difference.samplesB );
+    difference.channels.resize( nChannels );
+
+    for ( int i=0; i<nChannels; ++i )
+        difference.channels[i].name = A.name( i );
+
+    std::vector<double> sumSquares( nChannels, 0.0 );
+    MatrixXf blockA, blockB;
+    ArrayXXf error;
+    Array<bool,Dynamic,Dynamic> outside;
+
+    for ( unsigned long first=0; first<difference.compared; first+=_blockSamples )
+    {
+        unsigned long n = std::min( _blockSamples, difference.compared - first );
+
+        A.read( first, n, blockA );
+        B.read( first, n, blockB );
+        auto a = blockA.array();
+        auto b = blockB.array();
+
+        // Vectorized over the whole block, a NaN in one run only is an infinite error
+        error = ( a.isNaN() && b.isNaN() ).select( 0.0f, ( a.isNaN() || b.isNaN() ).select( std::numeric_limits<float>::infinity(), ( a - b ).abs() ) );
+        outside = error > _absTol + _relTol*a.abs().max( b.abs() ) || a.isNaN() != b.isNaN();
+
+        for ( int i=0; i<nChannels; ++i )
+        {
+            channelDifference& channel = difference.channels[i];
+
+            Index j;
+            float maxError = error.row( i ).maxCoeff( &j );
+            if ( maxError > channel.maxError )
+            {
+                channel.maxError = maxError;
+                channel.maxErrorSample = first + j;
+            }
+
+            sumSquares[i] += error.row( i ).cast<double>().square().sum();
+
+            unsigned long violations = outside.row( i ).count();
+            channel.violations += violations;
+
+            if ( violations > 0 && channel.firstDivergence < 0 )
+            {
+                for ( j=0; !outside( i,j ); ++j );
+                channel.firstDivergence = first + j;
+
+                if ( difference.firstDivergence < 0 || channel.firstDivergence < difference.firstDivergence )
+                {
+                    difference.firstDivergence = channel.firstDivergence;
+                    difference.firstChannel = i;
+                }
+            }
+        }
+    }
+
+    for ( int i=0; i<nChannels; ++i )
+        difference.channels[i].rms = difference.compared > 0 ? sqrt( sumSquares[i]/difference.compared ) : 0.0;
+
+    return difference;
+}
@@ -0,0 +1,150 @@
+/**
+ *	\file src/sampledReference.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+sampledReference::sampledReference(  ) : reference(  ) {}
+
+
+sampledReference::sampledReference( const MatrixXf& _samples, float _samplingTime, float _startTime, interpolationMethod _method ) : reference(  )
+{
+    if ( _samplingTime <= 0 )
+        throw std::invalid_argument("Reference requires a positive sampling time");
+
+    // Same expression as the simulation time of iteration i, so samples are hit exactly
+    times.resize( _samples.cols() );
+    for ( int i=0; i<times.size(); ++i )
+        times(i) = _startTime + i*_samplingTime;
+
+    samples = _samples;
+    method = _method;
+
+    init( );
+}
+
+
+sampledReference::sampledReference( const VectorXf& _times, const MatrixXf& _samples, interpolationMethod _method ) : reference(  )
+{
+    if ( _times.size() != _samples.cols() )
+        throw std::invalid_argument("Reference requires one time per sample");
+
+    times = _times;
+    samples = _samples;
+    method = _method;
+
+    init( );
+}
+
+
+sampledReference::sampledReference( const sampledReference& rhs ) : reference(  )
+{
+    times = rhs.times;
+    samples = rhs.samples;
+    slopes = rhs.slopes;
+    method = rhs.method;
+    cursor = rhs.cursor;
+}
+
+
+sampledReference::~sampledReference(  ) {}
+
+
+void sampledReference::evaluate( float _time, VectorXf& _value, VectorXf& _rate, VectorXf& _acceleration )
+{
+    int n = times.size();
+
+    if ( n == 0 )
+        throw std::invalid_argument("Reference has no samples");
+
+    _rate.setZero( samples.rows() );
+    _acceleration.setZero( samples.rows() );
+
+    // Hold first and last sample outside the time base
+    if ( _time <= times(0) || _time >= times( n-1 ) )
+    {
+        _value = _time <= times(0) ? samples.col( 0 ) : samples.col( n-1 );
+        return;
+    }
+
+    // Interval containing the time, moving forward from the last evaluation in amortized
+    // constant time and searching only when going back
+    if ( _time < times( cursor ) )
+        cursor = std::upper_bound( times.data(), times.data() + n, _time ) - times.data() - 1;
+
+    while ( _time >= times( cursor+1 ) )
+        ++cursor;
+
+    int k = cursor;
+    float h = times( k+1 ) - times( k );
+    float s = ( _time - times( k ) )/h;
+
+    switch ( method )
+    {
+        case ZERO_ORDER_HOLD:
+            _value = samples.col( k );
+            break;
+
+        case LINEAR_INTERPOLATION:
+            _value = ( 1 - s )*samples.col( k ) + s*samples.col( k+1 );
+            _rate = ( samples.col( k+1 ) - samples.col( k ) )/h;
+            break;
+
+        case HERMITE_INTERPOLATION:
+        {
+            // Hermite basis functions and their derivatives in normalized time
+            float s2 = s*s, s3 = s2*s;
+            float h00 = 2*s3 - 3*s2 + 1, h10 = s3 - 2*s2 + s, h01 = -2*s3 + 3*s2, h11 = s3 - s2;
+            float d00 = 6*s2 - 6*s, d10 = 3*s2 - 4*s + 1, d01 = -6*s2 + 6*s, d11 = 3*s2 - 2*s;
+            float a00 = 12*s - 6, a10 = 6*s - 4, a01 = -12*s + 6, a11 = 6*s - 2;
+
+            _value = h00*samples.col( k ) + h10*h*slopes.col( k ) + h01*samples.col( k+1 ) + h11*h*slopes.col( k+1 );
+            _rate = ( d00*samples.col( k ) + d10*h*slopes.col( k ) + d01*samples.col( k+1 ) + d11*h*slopes.col( k+1 ) )/h;
+            _acceleration = ( a00*samples.col( k ) + a10*h*slopes.col( k ) + a01*samples.col( k+1 ) + a11*h*slopes.col( k+1 ) )/( h*h );
+            break;
+        }
+    }
+}
+
+
+void sampledReference::setInterpolation( interpolationMethod _method )
+{
+    method = _method;
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void sampledReference::init(  )
+{
+    int n = times.size();
+
+    if ( n == 0 )
+        throw std::invalid_argument("Reference requires at least one sample");
+
+    for ( int i=1; i<n; ++i )
+        if ( !( times(i) > times( i-1 ) ) )
+            throw std::invalid_argument("Reference sample times are not strictly increasing");
+
+    // Slopes of the Hermite spline: central differences inside, one-sided at the ends
+    slopes = MatrixXf::Zero( samples.rows(), n );
+
+    for ( int i=0; i<n && n>1; ++i )
+    {
+        int a = std::max( i-1, 0 ), b = std::min( i+1, n-1 );
+        slopes.col( i ) = ( samples.col( b ) - samples.col( a ) )/( times( b ) - times( a ) );
+    }
+
+    cursor = 0;
+}
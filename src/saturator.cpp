@@ -42,6 +42,22 @@ saturator::saturator( const saturator& rhs )
 }
 
 
+saturator& saturator::operator=( const saturator& rhs )
+{
+    lowerLimits = rhs.lowerLimits;
+    upperLimits = rhs.upperLimits;
+
+    lowerRateLimits = rhs.lowerRateLimits;
+    upperRateLimits = rhs.upperRateLimits;
+
+    nU = rhs.nU;
+    samplingTime = rhs.samplingTime;
+    lastU = rhs.lastU;
+
+    return *this;
+}
+
+
 saturator::~saturator(  ){}
 
 
@@ -121,6 +137,19 @@ void saturator::setUpperRateLimit( int idx, float _upperRateLimit )
 
 
 
+void saturator::save( snapshot& _snapshot ) const
+{
+    _snapshot.write( lastU );
+}
+
+
+void saturator::restore( snapshot& _snapshot )
+{
+    _snapshot.read( lastU );
+}
+
+
+
 //
 // PROTECTED MEMBER FUNCTIONS:
 //
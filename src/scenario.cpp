@@ -0,0 +1,426 @@
+/**
+ *	\file src/scenario.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+#include <sstream>
+
+
+/** Values of a comma or space separated list
+ */
+static std::vector<float> parseValues( const std::string& _text, const std::string& _where )
+{
+    std::string text = _text;
+    std::replace( text.begin(), text.end(), ',', ' ' );
+
+    std::istringstream stream( text );
+    std::vector<float> values;
+    std::string token;
+
+    while ( stream >> token )
+    {
+        float value;
+        auto result = std::from_chars( token.data(), token.data() + token.size(), value );
+        if ( result.ec != std::errc() || result.ptr != token.data() + token.size() )
+            throw std::invalid_argument( _where + ": '" + token + "' is not a number" );
+        values.push_back( value );
+    }
+
+    return values;
+}
+
+
+/** Vector of given length
+ */
+static VectorXf parseVector( const std::string& _text, int _size, const std::string& _where )
+{
+    std::vector<float> values = parseValues( _text, _where );
+
+    // A single value applies to all channels
+    if ( values.size() == 1 )
+        return VectorXf::Constant( _size, values[0] );
+
+    if ( (int) values.size() != _size )
+        throw std::invalid_argument( _where + ": expected " + std::to_string( _size ) + " values" );
+
+    return Map<VectorXf>( values.data(), _size );
+}
+
+
+static float parseScalar( const std::string& _text, const std::string& _where )
+{
+    return parseVector( _text, 1, _where )(0);
+}
+
+
+static unsigned long parseInteger( const std::string& _text, const std::string& _where )
+{
+    unsigned long value;
+    auto result = std::from_chars( _text.data(), _text.data() + _text.size(), value );
+    if ( result.ec != std::errc() || result.ptr != _text.data() + _text.size() )
+        throw std::invalid_argument( _where + ": '" + _text + "' is not a non-negative integer" );
+    return value;
+}
+
+
+static bool parseFlag( const std::string& _text, const std::string& _where )
+{
+    if ( _text == "true" || _text == "on" || _text == "1" )
+        return true;
+    if ( _text == "false" || _text == "off" || _text == "0" )
+        return false;
+    throw std::invalid_argument( _where + ": expected true or false" );
+}
+
+
+static std::string trim( const std::string& _text )
+{
+    size_t begin = _text.find_first_not_of( " \t\r" );
+    size_t end = _text.find_last_not_of( " \t\r" );
+    return begin == std::string::npos ? "" : _text.substr( begin, end - begin + 1 );
+}
+
+
+
+/** Set parameter of a scenario by key and value of a scenario file line, relative paths are
+ *  relative to a directory
+ */
+static void applyParameter( scenario& _scenario, const std::string& _key, const std::string& _value, const std::string& _where,
+                            const std::filesystem::path& _directory )
+{
+    auto relative = [&]( const std::string& _path )
+    {
+        return std::filesystem::path( _path ).is_absolute() ? _path : ( _directory / _path ).string();
+    };
+
+    if ( _key == "particles" ) _scenario.particles = (int) parseScalar( _value, _where );
+    else if ( _key == "seed" ) _scenario.seed = parseInteger( _value, _where );
+    else if ( _key == "run" ) _scenario.run = parseInteger( _value, _where );
+    else if ( _key == "telemetry" ) _scenario.telemetry = parseFlag( _value, _where );
+    else if ( _key == "levelOfDetail" ) _scenario.levelOfDetail = parseFlag( _value, _where );
+    else if ( _key == "recorder" ) _scenario.recorder = parseFlag( _value, _where );
+    else if ( _key == "recorder.saturation" ) _scenario.saturationTrigger = parseFlag( _value, _where );
+    else if ( _key == "recorder.ground" ) _scenario.groundTrigger = parseFlag( _value, _where );
+    else if ( _key == "outputDirectory" ) _scenario.outputDirectory = relative( _value );
+    else if ( _key == "referenceFile" )
+    {
+        _scenario.referenceFile = relative( _value );
+        _scenario.reference = FILE_REFERENCE;
+    }
+    else if ( _key == "waypoints" )
+    {
+        std::vector<std::vector<float>> columns;
+        std::istringstream stream( _value );
+        std::string waypoint;
+
+        while ( std::getline( stream, waypoint, ';' ) )
+        {
+            columns.push_back( parseValues( waypoint, _where ) );
+            if ( columns.back().size() != 3 )
+                throw std::invalid_argument( _where + ": waypoints require 3 coordinates" );
+        }
+
+        _scenario.waypoints.resize( 3,columns.size() );
+        for ( size_t i=0; i<columns.size(); ++i )
+            _scenario.waypoints.col( i ) = Map<Vector3f>( columns[i].data() );
+        _scenario.reference = WAYPOINT_REFERENCE;
+    }
+    else if ( _key == "reference" )
+    {
+        if ( _value == "waypoints" ) _scenario.reference = WAYPOINT_REFERENCE;
+        else if ( _value == "file" ) _scenario.reference = FILE_REFERENCE;
+        else throw std::invalid_argument( _where + ": reference is 'waypoints' or 'file'" );
+    }
+    else if ( _key == "interpolation" )
+    {
+        if ( _value == "hold" ) _scenario.interpolation = ZERO_ORDER_HOLD;
+        else if ( _value == "linear" ) _scenario.interpolation = LINEAR_INTERPOLATION;
+        else if ( _value == "hermite" ) _scenario.interpolation = HERMITE_INTERPOLATION;
+        else throw std::invalid_argument( _where + ": interpolation is 'hold', 'linear' or 'hermite'" );
+    }
+    else if ( _key == "estimator" )
+    {
+        if ( _value == "ekf" ) _scenario.estimator = EKF_ESTIMATOR;
+        else if ( _value == "eskf" ) _scenario.estimator = ESKF_ESTIMATOR;
+        else if ( _value == "ukf" ) _scenario.estimator = UKF_ESTIMATOR;
+        else if ( _value == "pf" ) _scenario.estimator = PF_ESTIMATOR;
+        else throw std::invalid_argument( _where + ": estimator is 'ekf', 'eskf', 'ukf' or 'pf'" );
+    }
+    else
+    {
+        // Numeric parameter or dispersion of a numeric parameter
+        bool dispersed = _key.compare( 0, 11, "dispersion." ) == 0;
+        std::string parameter = dispersed ? _key.substr( 11 ) : _key;
+        int size;
+
+        try
+        {
+            size = _scenario.parameter( parameter ).size();
+        }
+        catch ( const std::invalid_argument& )
+        {
+            throw std::invalid_argument( _where + ": unknown key '" + _key + "'" );
+        }
+
+        if ( !dispersed )
+            _scenario.parameter( parameter ) = parseVector( _value, size, _where );
+        else
+        {
+            size_t space = _value.find_first_of( " \t" );
+            std::string distribution = _value.substr( 0, space );
+
+            dispersion Dispersion;
+            Dispersion.parameter = parameter;
+            Dispersion.spread = parseVector( space == std::string::npos ? "" : _value.substr( space ), size, _where );
+
+            if ( distribution == "normal" ) Dispersion.distribution = NORMAL_DISTRIBUTION;
+            else if ( distribution == "uniform" ) Dispersion.distribution = UNIFORM_DISTRIBUTION;
+            else throw std::invalid_argument( _where + ": dispersion is 'normal' or 'uniform' followed by the spread" );
+
+            _scenario.dispersions.push_back( Dispersion );
+        }
+    }
+}
+
+
+scenario::scenario(  )
+{
+    initialTime = 0.0;
+    finalTime = 35.0;
+    samplingTime = 0.01;
+
+    initialState = VectorXf::Zero( 12 );
+    initialState(8) = -0.05;
+    mass = 1.75;
+    inertia << 0.118825, 0.118825, 0.0735875;
+    forceConstant = 0.00377;
+    momentConstant = 0.01;
+    thrustOffset.setZero();
+
+    positionGains = { Vector3f( 0.7, 0.7, 1.0 ), Vector3f::Constant( 0.5 ), Vector3f::Zero() };
+    velocityGains = { Vector3f::Constant( 2.5 ), Vector3f::Constant( 1.0 ), Vector3f::Zero() };
+    attitudeGains = { Vector2f::Constant( 3.0 ), Vector2f::Constant( 1.0 ), Vector2f::Zero() };
+    rateGains = { Vector2f::Constant( -1.0 ), Vector2f::Zero(), Vector2f::Zero() };
+
+    servoDelay = 0.0;
+    propellerDelay = 0.0;
+    imuDelay = 0.0;
+
+    imuNoise.resize( 6 ); imuNoise << 0.01, 0.01, 0.01, 0.005, 0.005, 0.005;
+    imuBias = VectorXf::Zero( 6 );
+    accelNoise = VectorXf::Constant( 3, 0.05 );
+    accelBias = VectorXf::Zero( 3 );
+    gpsNoise.resize( 6 ); gpsNoise << 0.5, 0.5, 1.0, 0.05, 0.05, 0.1;
+    gpsBias = VectorXf::Zero( 6 );
+    baroNoise = VectorXf::Constant( 1, 0.1 );
+    baroBias = VectorXf::Zero( 1 );
+    magNoise = VectorXf::Constant( 3, 0.005 );
+    magBias = VectorXf::Zero( 3 );
+    seed = 1;
+    run = 0;
+
+    reference = WAYPOINT_REFERENCE;
+    waypoints.resize( 3,4 );
+    waypoints << 0.0,   0.0,  1.0,  0.0,
+                 0.0,   0.0,  1.0,  0.0,
+                -0.05, -1.0, -2.0, -2.0;
+    maxVelocity = 0.5;
+    maxAcceleration = 0.2;
+    referenceSamplingTime = 0.01;
+    interpolation = HERMITE_INTERPOLATION;
+
+    estimator = EKF_ESTIMATOR;
+    particles = 2000;
+
+    outputDirectory = "../data";
+    telemetry = true;
+    levelOfDetail = true;
+
+    recorder = false;
+    recorderPreTime = 2.0;
+    recorderPostTime = 2.0;
+    recorderSummaryTime = 1.0;
+    saturationTrigger = true;
+    groundTrigger = true;
+    trackingErrorTrigger = 0.5;
+    tiltTrigger = 30.0;
+}
+
+
+Map<VectorXf> scenario::parameter( const std::string& _key )
+{
+    auto scalar = []( float& _value ){ return Map<VectorXf>( &_value, 1 ); };
+    auto vector = []( auto& _value ){ return Map<VectorXf>( _value.data(), _value.size() ); };
+
+    if ( _key == "initialTime" ) return scalar( initialTime );
+    if ( _key == "finalTime" ) return scalar( finalTime );
+    if ( _key == "samplingTime" ) return scalar( samplingTime );
+    if ( _key == "initialState" ) return vector( initialState );
+    if ( _key == "mass" ) return scalar( mass );
+    if ( _key == "inertia" ) return vector( inertia );
+    if ( _key == "forceConstant" ) return scalar( forceConstant );
+    if ( _key == "momentConstant" ) return scalar( momentConstant );
+    if ( _key == "thrustOffset" ) return vector( thrustOffset );
+    if ( _key == "servo.delay" ) return scalar( servoDelay );
+    if ( _key == "propeller.delay" ) return scalar( propellerDelay );
+    if ( _key == "imu.delay" ) return scalar( imuDelay );
+    if ( _key == "imu.noise" ) return vector( imuNoise );
+    if ( _key == "imu.bias" ) return vector( imuBias );
+    if ( _key == "imu.accelNoise" ) return vector( accelNoise );
+    if ( _key == "imu.accelBias" ) return vector( accelBias );
+    if ( _key == "gps.noise" ) return vector( gpsNoise );
+    if ( _key == "gps.bias" ) return vector( gpsBias );
+    if ( _key == "baro.noise" ) return vector( baroNoise );
+    if ( _key == "baro.bias" ) return vector( baroBias );
+    if ( _key == "mag.noise" ) return vector( magNoise );
+    if ( _key == "mag.bias" ) return vector( magBias );
+    if ( _key == "maxVelocity" ) return scalar( maxVelocity );
+    if ( _key == "maxAcceleration" ) return scalar( maxAcceleration );
+    if ( _key == "referenceSamplingTime" ) return scalar( referenceSamplingTime );
+    if ( _key == "recorder.preTime" ) return scalar( recorderPreTime );
+    if ( _key == "recorder.postTime" ) return scalar( recorderPostTime );
+    if ( _key == "recorder.summaryTime" ) return scalar( recorderSummaryTime );
+    if ( _key == "recorder.trackingError" ) return scalar( trackingErrorTrigger );
+    if ( _key == "recorder.tilt" ) return scalar( tiltTrigger );
+
+    // Gains and limits of each loop
+    size_t dot = _key.find( '.' );
+    std::string group = _key.substr( 0, dot );
+    std::string item = dot == std::string::npos ? "" : _key.substr( dot + 1 );
+
+    pidGains* gains = group == "position" ? &positionGains : group == "velocity" ? &velocityGains :
+                      group == "attitude" ? &attitudeGains : group == "rate" ? &rateGains : nullptr;
+
+    signalLimits* limits = group == "position" ? &positionLimits : group == "velocity" ? &velocityLimits :
+                           group == "attitudeCommand" ? &attitudeCommandLimits : group == "attitude" ? &attitudeLimits :
+                           group == "servo" ? &servoLimits : group == "propeller" ? &propellerLimits : nullptr;
+
+    if ( gains && item == "p" ) return vector( gains->p );
+    if ( gains && item == "i" ) return vector( gains->i );
+    if ( gains && item == "d" ) return vector( gains->d );
+    if ( limits && item == "limit" ) return scalar( limits->control );
+    if ( limits && item == "rateLimit" ) return scalar( limits->rate );
+
+    throw std::invalid_argument("Unknown scenario parameter '" + _key + "'");
+}
+
+
+scenario loadScenario( const std::string& _fileName )
+{
+    std::ifstream file( _fileName );
+    if ( !file )
+        throw std::invalid_argument("Unable to open scenario " + _fileName);
+
+    scenario Scenario;
+    std::filesystem::path path( _fileName );
+    Scenario.name = path.stem().string();
+
+    std::string line;
+    int lineNumber = 0;
+
+    while ( std::getline( file, line ) )
+    {
+        ++lineNumber;
+        std::string where = _fileName + ":" + std::to_string( lineNumber );
+
+        line = trim( line.substr( 0, line.find( '#' ) ) );
+        if ( line.empty() )
+            continue;
+
+        size_t equals = line.find( '=' );
+        if ( equals == std::string::npos )
+            throw std::invalid_argument( where + ": expected 'key = value'" );
+
+        std::string key = trim( line.substr( 0, equals ) );
+        std::string value = trim( line.substr( equals + 1 ) );
+
+        applyParameter( Scenario, key, value, where, path.parent_path() );
+    }
+
+    if ( Scenario.samplingTime <= 0 || Scenario.finalTime <= Scenario.initialTime )
+        throw std::invalid_argument( _fileName + ": requires a positive sampling time and duration" );
+
+    if ( Scenario.reference == FILE_REFERENCE && Scenario.referenceFile.empty() )
+        throw std::invalid_argument( _fileName + ": file reference requires a referenceFile" );
+
+    return Scenario;
+}
+
+
+void setScenarioParameter( scenario& _scenario, const std::string& _key, const std::string& _value )
+{
+    applyParameter( _scenario, _key, trim( _value ), _key, "" );
+}
+
+
+std::string canonicalScenario( const scenario& _scenario )
+{
+    scenario Scenario = _scenario;
+    std::ostringstream text;
+    text << std::hexfloat;
+
+    auto write = [&]( const std::string& _key, const Ref<const VectorXf>& _values )
+    {
+        text << _key << " =";
+        for ( int j=0; j<_values.size(); ++j )
+            text << " " << _values(j);
+        text << "\n";
+    };
+
+    for ( const char* key : { "initialTime", "finalTime", "samplingTime", "initialState", "mass", "inertia", "forceConstant",
+                              "momentConstant", "thrustOffset", "servo.delay", "propeller.delay", "imu.delay",
+                              "imu.noise", "imu.bias", "imu.accelNoise", "imu.accelBias", "gps.noise", "gps.bias", "baro.noise",
+                              "baro.bias", "mag.noise", "mag.bias" } )
+        write( key, Scenario.parameter( key ) );
+
+    for ( const char* loop : { "position", "velocity", "attitude", "rate" } )
+        for ( const char* gain : { ".p", ".i", ".d" } )
+            write( std::string( loop ) + gain, Scenario.parameter( std::string( loop ) + gain ) );
+
+    for ( const char* loop : { "position", "velocity", "attitudeCommand", "attitude", "servo", "propeller" } )
+        for ( const char* limit : { ".limit", ".rateLimit" } )
+            write( std::string( loop ) + limit, Scenario.parameter( std::string( loop ) + limit ) );
+
+    text << "seed = " << Scenario.seed << "\nrun = " << Scenario.run << "\n";
+
+    if ( Scenario.reference == WAYPOINT_REFERENCE )
+    {
+        write( "waypoints", Map<VectorXf>( Scenario.waypoints.data(), Scenario.waypoints.size() ) );
+        write( "maxVelocity", Scenario.parameter( "maxVelocity" ) );
+        write( "maxAcceleration", Scenario.parameter( "maxAcceleration" ) );
+    }
+    else
+    {
+        std::ifstream file( Scenario.referenceFile, std::ios::binary );
+        if ( !file )
+            throw std::invalid_argument("Unable to open reference " + Scenario.referenceFile);
+
+        std::ostringstream contents;
+        contents << file.rdbuf();
+
+        text << "referenceFile = " << std::hex << runCatalog::hash( contents.str() ) << std::dec << "\n";
+        write( "referenceSamplingTime", Scenario.parameter( "referenceSamplingTime" ) );
+        text << "interpolation = " << Scenario.interpolation << "\n";
+    }
+
+    text << "estimator = " << Scenario.estimator << "\n";
+    if ( Scenario.estimator == PF_ESTIMATOR )
+        text << "particles = " << Scenario.particles << "\n";
+
+    text << "telemetry = " << Scenario.telemetry << "\nlevelOfDetail = " << ( Scenario.telemetry && Scenario.levelOfDetail ) << "\n";
+
+    // The flight recorder only changes the telemetry files
+    text << "recorder = " << ( Scenario.telemetry && Scenario.recorder ) << "\n";
+    if ( Scenario.telemetry && Scenario.recorder )
+    {
+        for ( const char* key : { "recorder.preTime", "recorder.postTime", "recorder.summaryTime", "recorder.trackingError", "recorder.tilt" } )
+            write( key, Scenario.parameter( key ) );
+        text << "recorder.saturation = " << Scenario.saturationTrigger << "\nrecorder.ground = " << Scenario.groundTrigger << "\n";
+    }
+
+    return text.str();
+}
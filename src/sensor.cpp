@@ -32,7 +32,8 @@ void sensor::processOutput( VectorXf& _y )
     
     omega = _y( seq( 3,5 ) );
     EulerAnglesVector = _y( seq( 0,2 ) );
-    QuaternionVector = toQuaternion( EulerAnglesVector );
+    Quaternionf q = eulerToQuaternion( EulerAnglesVector );
+    QuaternionVector << q.w(), q.vec();
     AccelVector = _y( seq( 12,14 ) );
     GravityVector = _y( seq( 15,17 ) );
     LinAccelVector = _y( seq( 12,14 ) ) - _y( seq( 15,17 ) );
@@ -40,7 +41,139 @@ void sensor::processOutput( VectorXf& _y )
 }
 
 
-IMUsensor::IMUsensor(  ) : sensor(  ) {}
+void sensor::setUpdateRate( float _updateRate )
+{
+    if ( _updateRate < 0 )
+        throw std::invalid_argument("Sensor update rate must be positive");
+
+    updateRate = _updateRate;
+}
+
+
+void sensor::setLatency( float _latency )
+{
+    if ( _latency < 0 )
+        throw std::invalid_argument("Sensor latency must be positive");
+
+    latency = _latency;
+}
+
+
+void sensor::setNoise( const VectorXf& _noise )
+{
+    if ( _noise.size() != nChannels )
+        throw std::invalid_argument("Incorrect number of sensor noise channels given");
+
+    noise = _noise;
+}
+
+
+void sensor::setBias( const VectorXf& _bias )
+{
+    if ( _bias.size() != nChannels )
+        throw std::invalid_argument("Incorrect number of sensor bias channels given");
+
+    bias = _bias;
+}
+
+
+void sensor::setDropout( float _dropout )
+{
+    if ( _dropout < 0 || _dropout > 1 )
+        throw std::invalid_argument("Sensor dropout probability must be between 0 and 1");
+
+    dropout = _dropout;
+}
+
+
+void sensor::setSeed( unsigned long _seed, unsigned long _run )
+{
+    seed = _seed;
+    run = _run;
+}
+
+
+void sensor::save( snapshot& _snapshot ) const
+{
+    _snapshot.write( nextSampleTime );
+    _snapshot.write( samples );
+}
+
+
+void sensor::restore( snapshot& _snapshot )
+{
+    _snapshot.read( nextSampleTime );
+    _snapshot.read( samples );
+}
+
+
+
+//
+// PROTECTED MEMBER FUNCTIONS:
+//
+
+bool sensor::sampleDue( float _time )
+{
+    // Small margin to avoid missing samples due to floating point round-off
+    if ( _time + 1e-6 < nextSampleTime )
+        return false;
+
+    ++samples;
+
+    if ( updateRate > 0 )
+    {
+        nextSampleTime += 1.0 / updateRate;
+
+        if ( nextSampleTime < _time )
+            nextSampleTime = _time + 1.0 / updateRate;
+    }
+
+    return true;
+}
+
+
+void sensor::publish( float _time, measurementType _type, const Matrix<float,6,1>& _value, measurementQueue& _queue )
+{
+    measurement m;
+    m.sampleTime = _time;
+    m.arrivalTime = _time + latency;
+    m.type = _type;
+    m.size = nChannels;
+    m.value.setZero();
+    m.value.head( nChannels ) = _value.head( nChannels );
+
+    if ( corrupt( m.value ) )
+        _queue.push( m );
+}
+
+
+bool sensor::corrupt( Matrix<float,6,1>& _value )
+{
+    randomStream stream( seed, run, component );
+    stream.seek( samples );
+
+    // Dropped sample
+    if ( dropout > 0 && stream.uniform( ) < dropout )
+        return false;
+
+    Matrix<float,6,1> n;
+    stream.normal( n.head( nChannels ) );
+
+    _value.head( nChannels ) += bias + noise.cwiseProduct( n.head( nChannels ) );
+
+    return true;
+}
+
+
+IMUsensor::IMUsensor(  ) : sensor(  )
+{
+    component = IMU_STREAM;
+    nChannels = 6;
+
+    noise = VectorXf::Zero( nChannels );
+    noise << 0.01, 0.01, 0.01, 0.005, 0.005, 0.005;
+    bias = VectorXf::Zero( nChannels );
+}
 
 
 void IMUsensor::EulerAngles( VectorXf& _yout )
@@ -97,4 +230,141 @@ void IMUsensor::PositionVec( VectorXf& _yout )
         throw std::invalid_argument("Incorrect number of output dimensions for position vector");
     else
         _yout = PositionVector;
-}
\ No newline at end of file
+}
+
+void IMUsensor::setAccelerometerNoise( const VectorXf& _noise )
+{
+    if ( _noise.size() != 3 )
+        throw std::invalid_argument("Incorrect number of accelerometer noise channels given");
+
+    accelNoise = _noise;
+}
+
+
+void IMUsensor::setAccelerometerBias( const VectorXf& _bias )
+{
+    if ( _bias.size() != 3 )
+        throw std::invalid_argument("Incorrect number of accelerometer bias channels given");
+
+    accelBias = _bias;
+}
+
+
+void IMUsensor::sample( float _time, VectorXf& _y, VectorXf& _ymeas )
+{
+    if ( _ymeas.size() != 9 )
+    {
+        _ymeas.resize( 9 );
+        _ymeas << _y.head<6>(), specificForce( _y );
+    }
+
+    if ( !sampleDue( _time ) )
+        return;
+
+    Matrix<float,6,1> value = _y( seq( 0,5 ) );
+
+    if ( !corrupt( value ) )
+        return;
+
+    // Accelerometer draws from its own stream, at the tick of the attitude and rate sample
+    randomStream stream( seed, run, ACCEL_STREAM );
+    stream.seek( samples );
+
+    Vector3f n;
+    stream.normal( n );
+
+    _ymeas << value, specificForce( _y ) + accelBias + accelNoise.cwiseProduct( n );
+}
+
+
+Vector3f IMUsensor::specificForce( const VectorXf& _y )
+{
+    Vector3f rates = _y.segment<3>( 3 );
+
+    return _y.segment<3>( 12 ) + rates.cross( _y.segment<3>( 9 ) ) - _y.segment<3>( 15 );
+}
+
+
+GPSsensor::GPSsensor(  ) : sensor(  )
+{
+    component = GPS_STREAM;
+    nChannels = 6;
+    updateRate = 5.0;
+    latency = 0.1;
+
+    noise = VectorXf::Zero( nChannels );
+    noise << 0.5, 0.5, 1.0, 0.05, 0.05, 0.1;
+    bias = VectorXf::Zero( nChannels );
+}
+
+
+void GPSsensor::sample( float _time, VectorXf& _y, measurementQueue& _queue )
+{
+    if ( !sampleDue( _time ) )
+        return;
+
+    Matrix3f Mnb = eulerToDCM( _y.head<3>() );
+
+    Matrix<float,6,1> value;
+    value << _y.segment<3>( 6 ), Mnb*_y.segment<3>( 9 );
+
+    publish( _time, GPS_MEASUREMENT, value, _queue );
+}
+
+
+BAROsensor::BAROsensor(  ) : sensor(  )
+{
+    component = BARO_STREAM;
+    nChannels = 1;
+    updateRate = 50.0;
+    latency = 0.02;
+
+    noise = VectorXf::Constant( nChannels, 0.1 );
+    bias = VectorXf::Zero( nChannels );
+}
+
+
+void BAROsensor::sample( float _time, VectorXf& _y, measurementQueue& _queue )
+{
+    if ( !sampleDue( _time ) )
+        return;
+
+    Matrix<float,6,1> value = Matrix<float,6,1>::Zero();
+    value(0) = -_y(8);
+
+    publish( _time, BARO_MEASUREMENT, value, _queue );
+}
+
+
+MAGsensor::MAGsensor(  ) : sensor(  )
+{
+    component = MAG_STREAM;
+    nChannels = 3;
+    updateRate = 100.0;
+    latency = 0.005;
+
+    noise = VectorXf::Constant( nChannels, 0.005 );
+    bias = VectorXf::Zero( nChannels );
+
+    field << 0.2, 0.0, 0.45;
+}
+
+
+void MAGsensor::setField( const Vector3f& _field )
+{
+    field = _field;
+}
+
+
+void MAGsensor::sample( float _time, VectorXf& _y, measurementQueue& _queue )
+{
+    if ( !sampleDue( _time ) )
+        return;
+
+    Matrix3f Mnb = eulerToDCM( _y.head<3>() );
+
+    Matrix<float,6,1> value = Matrix<float,6,1>::Zero();
+    value( seq( 0,2 ) ) = Mnb.transpose()*field;
+
+    publish( _time, MAG_MEASUREMENT, value, _queue );
+}
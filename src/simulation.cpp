@@ -0,0 +1,696 @@
+/**
+ *	\file src/simulation.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+// Telemetry channels of the exported data
+const std::vector<telemetryChannel> stateChannels = {
+    { "roll", "rad" }, { "pitch", "rad" }, { "yaw", "rad" },
+    { "roll_rate", "rad/s" }, { "pitch_rate", "rad/s" }, { "yaw_rate", "rad/s" },
+    { "x_position", "m" }, { "y_position", "m" }, { "z_position", "m" },
+    { "u_velocity", "m/s" }, { "v_velocity", "m/s" }, { "w_velocity", "m/s" },
+    { "x_velocity", "m/s" }, { "y_velocity", "m/s" }, { "z_velocity", "m/s" },
+    { "x_acceleration", "m/s2" }, { "y_acceleration", "m/s2" }, { "z_acceleration", "m/s2" } };
+
+const std::vector<telemetryChannel> estimateChannels = {
+    { "roll", "rad" }, { "pitch", "rad" }, { "yaw", "rad" },
+    { "roll_rate", "rad/s" }, { "pitch_rate", "rad/s" }, { "yaw_rate", "rad/s" },
+    { "x_position", "m" }, { "y_position", "m" }, { "z_position", "m" },
+    { "u_velocity", "m/s" }, { "v_velocity", "m/s" }, { "w_velocity", "m/s" },
+    { "NEES", "-" } };
+
+const std::vector<telemetryChannel> inputChannels = {
+    { "x_gimbal", "rad" }, { "y_gimbal", "rad" }, { "propeller", "rad/s" },
+    { "x_gimbal_rate", "rad/s" }, { "y_gimbal_rate", "rad/s" }, { "propeller_rate", "rad/s2" } };
+
+const std::vector<telemetryChannel> referenceChannels = {
+    { "roll_rate_ref", "rad/s" }, { "pitch_rate_ref", "rad/s" },
+    { "roll_ref", "rad" }, { "pitch_ref", "rad" },
+    { "x_acceleration_ref", "m/s2" }, { "y_acceleration_ref", "m/s2" }, { "z_acceleration_ref", "m/s2" },
+    { "x_velocity_ref", "m/s" }, { "y_velocity_ref", "m/s" }, { "z_velocity_ref", "m/s" },
+    { "x_position_ref", "m" }, { "y_position_ref", "m" }, { "z_position_ref", "m" } };
+
+const std::vector<telemetryChannel> timeChannels = { { "time", "s" } };
+
+static std::vector<telemetryChannel> concatenate( std::initializer_list<const std::vector<telemetryChannel>*> _lists )
+{
+    std::vector<telemetryChannel> channels;
+    for ( const auto* list : _lists )
+        channels.insert( channels.end(), list->begin(), list->end() );
+    return channels;
+}
+
+const std::vector<telemetryChannel> recordChannels = concatenate( { &stateChannels, &estimateChannels, &referenceChannels, &inputChannels, &timeChannels } );
+
+
+// Identifies simulation snapshots
+static const uint64_t snapshotMagic = 0x3130504e53435654ull;       // "TVCSNP01"
+
+
+/** Assign symmetric control and rate limits to all channels
+ */
+static void applyLimits( saturator& _saturator, const signalLimits& _limits )
+{
+    if ( std::isfinite( _limits.control ) )
+    {
+        _saturator.setLowerControlLimit( -1,-_limits.control );
+        _saturator.setUpperControlLimit( -1, _limits.control );
+    }
+
+    if ( std::isfinite( _limits.rate ) )
+    {
+        _saturator.setLowerRateLimit( -1,-_limits.rate );
+        _saturator.setUpperRateLimit( -1, _limits.rate );
+    }
+}
+
+
+static void applyGains( PIDcontroller& _controller, const pidGains& _gains )
+{
+    _controller.setProportionalGains( _gains.p );
+    _controller.setIntegralGains( _gains.i );
+    _controller.setDerivativeGains( _gains.d );
+}
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+simulation::simulation( const scenario& _scenario ) : Scenario( _scenario )
+{
+    if ( Scenario.reference == FILE_REFERENCE )
+        ownedReference.reset( new sampledReference( loadFromFile( Scenario.referenceFile ), Scenario.referenceSamplingTime, Scenario.initialTime, Scenario.interpolation ) );
+    else
+        ownedReference.reset( new minSnapTrajectory( Scenario.waypoints, Scenario.maxVelocity, Scenario.maxAcceleration, Scenario.initialTime ) );
+
+    Reference = ownedReference.get();
+    build( );
+}
+
+
+simulation::simulation( const scenario& _scenario, reference& _reference ) : Scenario( _scenario )
+{
+    Reference = &_reference;
+    build( );
+}
+
+
+simulation::~simulation(  )
+{
+    close( );
+}
+
+
+void simulation::init(  )
+{
+    if ( initialized )
+        return;
+
+    float initTime = Scenario.initialTime;
+
+    open( );
+
+    logRecord = VectorXf::Zero( recordChannels.size() );
+    Ref<VectorXf> X = logRecord.segment( 0,18 ), E = logRecord.segment( 18,13 ), R = logRecord.segment( 31,13 ), U = logRecord.segment( 44,6 ), T = logRecord.segment( 50,1 );
+
+    X( seq(0,11) )=Drone.state;
+    E( seq(0,11) )=Drone.state;
+    U( seq(0,1) )=u_serv; U( seq(2,2) )=u_prop;
+    T( 0 ) = initTime;
+    R( seq(0,1) ) = ref_omega; R( seq(2,3) ) = ref_attitude; R( seq(4,6) ) = ref_acc; R( seq(7,9) ) = ref_vel; R( seq(10,12) ) = ref_pos;
+
+    log( );
+    if ( recording )
+        recordBuffer.col( 0 ) = logRecord;
+
+    // Initialize controllers
+    PIDpos.init( y_position,y_vel,initTime );
+    PIDvel.init( y_vel,y_acc,ref_vel,initTime );
+    PID.init( y_attitude(seq(0,1)),y_omega,ref_attitude,initTime );
+    PIDinner.init( y_omega(seq(0,1)),u,ref_omega,initTime );
+
+    // Initialize estimators
+    Estimator->init();
+
+    initialized = true;
+}
+
+
+bool simulation::step(  )
+{
+    init( );
+
+    // No further samples once the final time, ground contact or divergence ended the run
+    if ( stopped || i >= Nsim )
+    {
+        if ( progress )
+            progress->finished.store( true, std::memory_order_release );
+        return false;
+    }
+
+    float samplingTime = Scenario.samplingTime;
+
+    // Drone has not hit ground
+    if (Drone.state[8] <= 0.0)
+    {
+        /* Guidance */
+        Reference->evaluate( Scenario.initialTime + i*samplingTime,ref_pos,ff_vel,ff_acc );
+
+
+        /* Control Software */
+        PIDpos.step( Drone.time,y_position,ref_pos );
+        PIDpos.getU( ref_vel );
+        ref_vel += ff_vel;
+
+        PIDvel.step( Drone.time,y_vel,ref_vel );
+        PIDvel.getU( ref_acc );
+        ref_acc += ff_acc;
+
+        y_acc = BFRtoNED( y_attitude,y_acc );
+        INDI.computeControlEffectiveness( y_attitude,u_serv,u_prop,p );
+        INDI.step( Drone.time, y_acc, ref_acc );
+        INDI.getU( u );
+
+        ref_attitude << u( seq(0,1) );
+        Attitude.actuate( ref_attitude );
+        u_prop = u( seq(2,2) );
+
+        PID.step( Drone.time,y_attitude( seq(0,1) ),ref_attitude );
+        PID.getU( ref_omega );
+
+        PIDinner.step( Drone.time,y_omega( seq(0,1) ),ref_omega );
+        PIDinner.getU( u_serv );
+
+
+        /* Physical System */
+        // Actuator
+        ServoDelay.delay( u_serv );
+        PropellerDelay.delay( u_prop );
+
+        Servos.actuate( u_serv );
+        Propellers.actuate( u_prop );
+
+        u << u_serv, u_prop;
+
+        // System
+        Drone.step( u,ySystem );
+
+        // Sensor
+        BNO055.processOutput( ySystem );
+
+        BNO055.AngularVel( y_omega );
+        BNO055.EulerAngles( y_attitude );
+        BNO055.Acceleration( y_acc );
+        GyroDelay.delay( y_omega );
+        AttitudeDelay.delay( y_attitude );
+        BNO055.PositionVec( y_position );
+        y_vel = Drone.earthVel;
+
+        GPS.sample( Drone.time, ySystem, Measurements );
+        Barometer.sample( Drone.time, ySystem, Measurements );
+        Magnetometer.sample( Drone.time, ySystem, Measurements );
+        BNO055.sample( Drone.time, ySystem, yIMU );
+
+        /* Navigation Software */
+        auto start = std::chrono::steady_clock::now();
+        Estimator->estimateState( u, yIMU, Measurements, e );
+        estimatorTime += std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    record( );
+    ++i;
+
+    // Stop once the drone has hit the ground or the state has diverged
+    bool running = Drone.state[8] <= 0.0 && Drone.state.allFinite() && i < Nsim;
+    stopped = !running;
+
+    if ( progress )
+    {
+        progress->steps.store( i - firstStep, std::memory_order_relaxed );
+        if ( !running )
+            progress->finished.store( true, std::memory_order_release );
+    }
+
+    return running;
+}
+
+
+VectorXf simulation::run(  )
+{
+    while ( step( ) );
+
+    if ( verbose )
+        std::cout << "Estimator: " << estimatorTime/Nsim*1e6 << " us per step, mean NEES " << neesSum/(Nsim+1) << std::endl;
+
+    close( );
+
+    return metrics( );
+}
+
+
+VectorXf simulation::metrics(  ) const
+{
+    VectorXf result = summary;
+    result(2) = i > 0 ? sqrt( errorSum/i ) : 0.0;
+    result(3) = neesSum/(i+1);
+    return result;
+}
+
+
+int simulation::iteration(  ) const
+{
+    return i;
+}
+
+
+unsigned long simulation::dropped(  ) const
+{
+    return Log.dropped( );
+}
+
+
+int simulation::iterations(  ) const
+{
+    return Nsim;
+}
+
+
+const dynamics& simulation::vehicle(  ) const
+{
+    return Drone;
+}
+
+
+snapshot simulation::save(  )
+{
+    init( );
+
+    snapshot Snapshot;
+
+    // Header, checked when restored
+    Snapshot.write( snapshotMagic );
+    Snapshot.write( Scenario.estimator );
+    Snapshot.write( Scenario.initialTime );
+    Snapshot.write( Scenario.samplingTime );
+    Snapshot.write( i );
+
+    Drone.save( Snapshot );
+
+    PIDpos.save( Snapshot );
+    PIDvel.save( Snapshot );
+    INDI.save( Snapshot );
+    PID.save( Snapshot );
+    PIDinner.save( Snapshot );
+
+    Servos.save( Snapshot );
+    Propellers.save( Snapshot );
+    Attitude.save( Snapshot );
+    ServoDelay.save( Snapshot );
+    PropellerDelay.save( Snapshot );
+    AttitudeDelay.save( Snapshot );
+    GyroDelay.save( Snapshot );
+
+    BNO055.save( Snapshot );
+    GPS.save( Snapshot );
+    Barometer.save( Snapshot );
+    Magnetometer.save( Snapshot );
+    Measurements.save( Snapshot );
+    Estimator->save( Snapshot );
+
+    for ( const VectorXf* signal : { &u, &u_serv, &u_prop, &e, &ySystem, &yIMU, &y_position, &y_vel, &y_acc, &y_attitude, &y_omega,
+                                     &ref_pos, &ref_vel, &ref_acc, &ref_attitude, &ref_omega, &ff_vel, &ff_acc, &logRecord, &summary } )
+        Snapshot.write( *signal );
+
+    Snapshot.write( neesSum );
+    Snapshot.write( errorSum );
+    Snapshot.write( estimatorTime );
+
+    return Snapshot;
+}
+
+
+void simulation::restore( const snapshot& _snapshot )
+{
+    if ( initialized )
+        throw std::invalid_argument("Simulation is restored before the first step");
+
+    snapshot Snapshot( _snapshot.blob() );
+
+    uint64_t magic;
+    estimatorType type;
+    float initialTime, samplingTime;
+
+    Snapshot.read( magic );
+    Snapshot.read( type );
+    Snapshot.read( initialTime );
+    Snapshot.read( samplingTime );
+
+    if ( magic != snapshotMagic )
+        throw std::invalid_argument("Not a simulation snapshot");
+
+    if ( type != Scenario.estimator || initialTime != Scenario.initialTime || samplingTime != Scenario.samplingTime )
+        throw std::invalid_argument("Snapshot does not match the estimator, initial time or sampling time of scenario " + Scenario.name);
+
+    Snapshot.read( i );
+
+    Drone.restore( Snapshot );
+
+    PIDpos.restore( Snapshot );
+    PIDvel.restore( Snapshot );
+    INDI.restore( Snapshot );
+    PID.restore( Snapshot );
+    PIDinner.restore( Snapshot );
+
+    Servos.restore( Snapshot );
+    Propellers.restore( Snapshot );
+    Attitude.restore( Snapshot );
+    ServoDelay.restore( Snapshot );
+    PropellerDelay.restore( Snapshot );
+    AttitudeDelay.restore( Snapshot );
+    GyroDelay.restore( Snapshot );
+
+    BNO055.restore( Snapshot );
+    GPS.restore( Snapshot );
+    Barometer.restore( Snapshot );
+    Magnetometer.restore( Snapshot );
+    Measurements.restore( Snapshot );
+    Estimator->restore( Snapshot );
+
+    for ( VectorXf* signal : { &u, &u_serv, &u_prop, &e, &ySystem, &yIMU, &y_position, &y_vel, &y_acc, &y_attitude, &y_omega,
+                               &ref_pos, &ref_vel, &ref_acc, &ref_attitude, &ref_omega, &ff_vel, &ff_acc, &logRecord, &summary } )
+        Snapshot.read( *signal );
+
+    Snapshot.read( neesSum );
+    Snapshot.read( errorSum );
+    Snapshot.read( estimatorTime );
+
+    // Telemetry starts with the last record before the snapshot
+    open( );
+    log( );
+
+    firstStep = i;
+    if ( progress )
+        progress->totalSteps.store( Nsim - firstStep, std::memory_order_relaxed );
+    if ( recording )
+    {
+        recordBuffer.resize( logRecord.size(), Nsim - i + 1 );
+        recordBuffer.col( 0 ) = logRecord;
+    }
+
+    initialized = true;
+}
+
+
+void simulation::setVerbose( bool _verbose )
+{
+    verbose = _verbose;
+}
+
+
+void simulation::setLosslessTelemetry( bool _lossless )
+{
+    if ( initialized )
+        throw std::invalid_argument("Lossless telemetry is set before the first step");
+
+    Log.setLossless( _lossless );
+}
+
+
+void simulation::setRecording( bool _recording )
+{
+    if ( initialized )
+        throw std::invalid_argument("Recording is set before the first step");
+
+    recording = _recording;
+    recordBuffer.resize( recordChannels.size(), recording ? Nsim + 1 : 0 );
+}
+
+
+void simulation::setProgress( progressCounter* _counter )
+{
+    if ( initialized )
+        throw std::invalid_argument("Progress is set before the first step");
+
+    progress = _counter;
+    if ( progress )
+        progress->totalSteps.store( Nsim, std::memory_order_relaxed );
+}
+
+
+const float* simulation::records(  ) const
+{
+    return recordBuffer.data();
+}
+
+
+int simulation::recordedSamples(  ) const
+{
+    return recording && initialized ? i - firstStep + 1 : 0;
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void simulation::build(  )
+{
+    float samplingTime = Scenario.samplingTime;
+    float initTime = Scenario.initialTime;
+    Nsim = (int) round( (Scenario.finalTime-initTime)/samplingTime );
+
+    if ( Scenario.initialState.size() != 12 )
+        throw std::invalid_argument("Scenario requires an initial state with 12 elements");
+
+    if ( Reference->value( initTime ).size() != 3 )
+        throw std::invalid_argument("Reference trajectory requires 3 channels");
+
+    // Vehicle
+    Drone = dynamics( Scenario.initialState, initTime, samplingTime );
+    Drone.setMass( Scenario.mass );
+    Drone.setInertia( Scenario.inertia );
+    Drone.setPropellerConstants( Scenario.forceConstant, Scenario.momentConstant );
+    Drone.setThrustOffset( Scenario.thrustOffset );
+
+    // Parameters, input, output and reference signals
+    p.resize(2); p << Scenario.mass, -2*Scenario.forceConstant;          // Mass and twice the force constant of one propeller
+
+    u = VectorXf::Zero(3);
+    u_serv = VectorXf::Zero(2);
+    u_prop.resize(1); u_prop << 2276.856764;
+
+    e.resize(12);
+    ySystem.resize(18);
+    yIMU.resize(9);
+    y_position = Drone.state( seq( 6,8 ) );
+    y_vel = VectorXf::Zero(3);
+    y_acc = VectorXf::Zero(3);
+    y_attitude = Drone.state( seq( 0,2 ) );
+    y_omega = Drone.state( seq( 3,5 ) );
+
+    ref_pos = VectorXf::Zero(3);
+    ref_vel = VectorXf::Zero(3);
+    ref_acc = VectorXf::Zero(3);
+    ref_attitude = VectorXf::Zero(2);
+    ref_omega = VectorXf::Zero(2);
+    ff_vel = VectorXf::Zero(3);                                          // Velocity and acceleration feedforward
+    ff_acc = VectorXf::Zero(3);
+
+    // Define controllers
+    PIDpos = PIDcontroller( 3,3,samplingTime, 10 );
+    PIDvel = PIDcontroller( 3,3,samplingTime, 10 );
+    INDI = INDIcontroller( 3,3,samplingTime );
+    PID = PIDcontroller( 2,2,samplingTime, 10 );
+    PIDinner = PIDcontroller( 2,2,samplingTime, 10 );
+
+    applyGains( PIDpos, Scenario.positionGains );
+    applyGains( PIDvel, Scenario.velocityGains );
+    applyGains( PID, Scenario.attitudeGains );
+    applyGains( PIDinner, Scenario.rateGains );
+
+    applyLimits( PIDpos, Scenario.positionLimits );
+    applyLimits( PIDvel, Scenario.velocityLimits );
+    applyLimits( PID, Scenario.attitudeLimits );
+
+    // Define and initialize actuators
+    Servos = actuator( 2,u_serv,samplingTime );
+    Propellers = actuator( 1,u_prop,samplingTime );
+    Attitude = actuator( 2,y_attitude(seq(0,1)),samplingTime );
+
+    applyLimits( Servos, Scenario.servoLimits );
+    applyLimits( Propellers, Scenario.propellerLimits );
+    applyLimits( Attitude, Scenario.attitudeCommandLimits );
+
+    // Define transport and compute delays
+    ServoDelay = delayLine( 2,u_serv,samplingTime,64 );
+    PropellerDelay = delayLine( 1,u_prop,samplingTime,64 );
+    AttitudeDelay = delayLine( 3,y_attitude,samplingTime,64 );
+    GyroDelay = delayLine( 3,y_omega,samplingTime,64 );
+
+    ServoDelay.setDelay( Scenario.servoDelay );
+    PropellerDelay.setDelay( Scenario.propellerDelay );
+    AttitudeDelay.setDelay( Scenario.imuDelay );
+    GyroDelay.setDelay( Scenario.imuDelay );
+
+    // Define sensors and estimator
+    BNO055.setNoise( Scenario.imuNoise );
+    BNO055.setBias( Scenario.imuBias );
+    BNO055.setAccelerometerNoise( Scenario.accelNoise );
+    BNO055.setAccelerometerBias( Scenario.accelBias );
+    GPS.setNoise( Scenario.gpsNoise );
+    GPS.setBias( Scenario.gpsBias );
+    Barometer.setNoise( Scenario.baroNoise );
+    Barometer.setBias( Scenario.baroBias );
+    Magnetometer.setNoise( Scenario.magNoise );
+    Magnetometer.setBias( Scenario.magBias );
+
+    BNO055.setSeed( Scenario.seed, Scenario.run );
+    GPS.setSeed( Scenario.seed, Scenario.run );
+    Barometer.setSeed( Scenario.seed, Scenario.run );
+    Magnetometer.setSeed( Scenario.seed, Scenario.run );
+
+    Measurements = measurementQueue( 64 );
+
+    switch ( Scenario.estimator )
+    {
+        case EKF_ESTIMATOR:
+            Estimator.reset( new estimator( Drone.state, initTime, samplingTime ) );
+            break;
+
+        case ESKF_ESTIMATOR:
+        {
+            // Noise densities of the IMU signals that drive the propagation, from the noise of a sample
+            ESKFestimator* errorStateFilter = new ESKFestimator( Drone.state, initTime, samplingTime );
+            errorStateFilter->setIMUNoise( Scenario.accelNoise.maxCoeff()*sqrt( samplingTime ), Scenario.imuNoise.tail<3>().maxCoeff()*sqrt( samplingTime ),
+                                           1e-3, 1e-4 );
+            Estimator.reset( errorStateFilter );
+            break;
+        }
+
+        case UKF_ESTIMATOR:
+            Estimator.reset( new UKFestimator( Drone.state, initTime, samplingTime ) );
+            break;
+
+        case PF_ESTIMATOR:
+        {
+            PFestimator* particleFilter = new PFestimator( Drone.state, initTime, samplingTime, Scenario.particles, 1 );
+            particleFilter->setSeed( Scenario.seed, Scenario.run );
+            Estimator.reset( particleFilter );
+            break;
+        }
+    }
+
+    // The IMU update is weighted with the noise of the IMU measurements
+    Estimator->setMeasurementNoise( IMU_MEASUREMENT, Scenario.imuNoise );
+}
+
+
+void simulation::record(  )
+{
+    Ref<VectorXf> X = logRecord.segment( 0,18 ), E = logRecord.segment( 18,13 ), R = logRecord.segment( 31,13 ), U = logRecord.segment( 44,6 ), T = logRecord.segment( 50,1 );
+
+    // Save data
+    X(seq(0, 11)) = Drone.state;
+    X(seq(12, 14)) = y_vel;
+    X(seq(15, 17)) = y_acc;
+
+    R(seq(0,1)) = ref_omega;
+    R(seq(2,3)) = ref_attitude;
+    R(seq(4,6)) = ref_acc;
+    R(seq(7,9)) = ref_vel;
+    R(seq(10,12)) = PIDpos.yRef;
+
+    U(seq(0, 2)) = u;
+    U(seq(3,4)) = Servos.controlRate;
+    U(seq(5,5)) = Propellers.controlRate;
+
+    E(seq(0, 11)) = e;
+    E(12) = Estimator->NEES( Drone.state );
+    neesSum += E(12);
+
+    float positionError = ( Drone.state( seq(6,8) ) - PIDpos.yRef ).norm();
+    errorSum += positionError*positionError;
+    summary(0) = std::max( summary(0), (float) ( acos( cos( Drone.state(0) )*cos( Drone.state(1) ) )*180/M_PI ) );
+    summary(1) = std::max( summary(1), positionError );
+
+    T(0) = Scenario.initialTime + (i+1)*Scenario.samplingTime;
+
+    log( );
+    if ( recording )
+        recordBuffer.col( i+1 - firstStep ) = logRecord;
+}
+
+
+void simulation::open(  )
+{
+    // Flight recorder, full-rate windows around the triggers and summaries of the channels
+    if ( Scenario.telemetry && Scenario.recorder )
+    {
+        std::unique_ptr<flightRecorder> Recorder( new flightRecorder( Scenario.outputDirectory + "/flight", recordChannels, Scenario.samplingTime,
+                                                                      Scenario.recorderPreTime, Scenario.recorderPostTime, Scenario.recorderSummaryTime ) );
+
+        // Channels of a record: state 0-17, estimate 18-30, reference 31-43, input 44-49
+        float servoLimit = Scenario.servoLimits.control;
+        float maxError = Scenario.trackingErrorTrigger;
+        float maxTilt = Scenario.tiltTrigger*M_PI/180;
+
+        if ( Scenario.saturationTrigger && std::isfinite( servoLimit ) )
+            Recorder->addTrigger( "saturation", [servoLimit]( const VectorXf& r ){ return r.segment( 44,2 ).cwiseAbs().maxCoeff() >= servoLimit - 1e-6; } );
+        if ( maxError > 0 )
+            Recorder->addTrigger( "trackingError", [maxError]( const VectorXf& r ){ return ( r.segment( 6,3 ) - r.segment( 41,3 ) ).norm() > maxError; } );
+        if ( maxTilt > 0 )
+            Recorder->addTrigger( "tilt", [maxTilt]( const VectorXf& r ){ return acos( cos( r(0) )*cos( r(1) ) ) > maxTilt; } );
+        if ( Scenario.groundTrigger )
+            Recorder->addTrigger( "ground", []( const VectorXf& r ){ return r(8) > 0; } );
+
+        // Triggers are evaluated and captures written by the writer thread
+        Log.setRecorder( std::move( Recorder ) );
+        Log.start( );
+    }
+
+    // Telemetry, streamed to disk by a writer thread during the simulation
+    else if ( Scenario.telemetry )
+    {
+        Log.addFile( Scenario.outputDirectory + "/state.tlm", stateChannels );
+        Log.addFile( Scenario.outputDirectory + "/estimate.tlm", estimateChannels );
+        Log.addFile( Scenario.outputDirectory + "/ref.tlm", referenceChannels );
+        Log.addFile( Scenario.outputDirectory + "/input.tlm", inputChannels );
+        Log.addFile( Scenario.outputDirectory + "/time.tlm", timeChannels );
+        Log.setLevelOfDetail( Scenario.levelOfDetail );
+        Log.start( );
+    }
+}
+
+
+void simulation::log(  )
+{
+    if ( Scenario.telemetry )
+        Log.push( logRecord );
+}
+
+
+void simulation::close(  )
+{
+    if ( closed || !Scenario.telemetry || !initialized )
+        return;
+
+    // Write remaining data
+    closed = true;
+
+    Log.close( );
+
+    if ( Log.recorder() && verbose )
+        for ( const recorderEvent& event : Log.recorder()->events() )
+            std::cout << "Flight recorder: " << event.trigger << " at record " << event.sample << ", " << event.fileName << std::endl;
+
+    if ( Log.dropped() > 0 && verbose )
+        std::cout << "Telemetry: " << Log.dropped() << " records dropped" << std::endl;
+}
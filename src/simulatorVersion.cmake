@@ -0,0 +1,43 @@
+# Writes the version of the simulator code to a header, run by the build (cmake -P) before
+# resultCache is compiled:
+#
+#   SOURCE_DIR      root of the project
+#   VERSION         version of the project
+#   TOOLCHAIN       compiler id and version, build type, language standard and compiler flags
+#   OUTPUT          header to write
+#
+# The version is the project version and a hash of the contents of the simulator sources and
+# the toolchain, so that every change to the code, committed or not, and every change of
+# compiler or flags gives a new version, and unchanged code built the same way keeps its
+# version. The header is only rewritten when the version changes, so that
+# resultCache is not compiled again on every build.
+
+file(GLOB SOURCES
+    ${SOURCE_DIR}/header.h
+    ${SOURCE_DIR}/main.cpp
+    ${SOURCE_DIR}/include/*.h
+    ${SOURCE_DIR}/include/*.ipp
+    ${SOURCE_DIR}/src/*.cpp
+    ${SOURCE_DIR}/scripts/*.h
+    ${SOURCE_DIR}/scripts/*.cpp
+)
+list(SORT SOURCES)
+
+set(CONTENTS "toolchain ${TOOLCHAIN}\n")
+foreach(SOURCE ${SOURCES})
+    file(SHA256 ${SOURCE} SOURCE_HASH)
+    file(RELATIVE_PATH SOURCE_NAME ${SOURCE_DIR} ${SOURCE})
+    string(APPEND CONTENTS "${SOURCE_NAME} ${SOURCE_HASH}\n")
+endforeach()
+
+string(SHA256 HASH "${CONTENTS}")
+string(SUBSTRING ${HASH} 0 16 HASH)
+
+set(HEADER "// Generated by src/simulatorVersion.cmake\n#define SIMULATOR_VERSION \"${VERSION}-${HASH}\"\n")
+
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} PREVIOUS)
+endif()
+if(NOT "${PREVIOUS}" STREQUAL "${HEADER}")
+    file(WRITE ${OUTPUT} "${HEADER}")
+endif()
@@ -0,0 +1,73 @@
+/**
+ *	\file src/snapshot.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+snapshot::snapshot(  ) {}
+
+
+snapshot::snapshot( std::vector<char> _blob ) : data( std::move( _blob ) ) {}
+
+
+void snapshot::write( const Quaternionf& _quaternion )
+{
+    write( _quaternion.coeffs() );
+}
+
+
+void snapshot::read( Quaternionf& _quaternion )
+{
+    Vector4f coeffs;
+    read( coeffs );
+    _quaternion.coeffs() = coeffs;
+}
+
+
+void snapshot::rewind(  )
+{
+    position = 0;
+}
+
+
+const std::vector<char>& snapshot::blob(  ) const
+{
+    return data;
+}
+
+
+size_t snapshot::size(  ) const
+{
+    return data.size();
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void snapshot::append( const void* _data, size_t _size )
+{
+    const char* bytes = (const char*) _data;
+    data.insert( data.end(), bytes, bytes + _size );
+}
+
+
+void snapshot::extract( void* _data, size_t _size )
+{
+    if ( position + _size > data.size() )
+        throw std::invalid_argument("Snapshot is truncated");
+
+    std::memcpy( _data, data.data() + position, _size );
+    position += _size;
+}
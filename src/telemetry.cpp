@@ -0,0 +1,506 @@
+/**
+ *	\file src/telemetry.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+static const char telemetryMagic[8] = { 'T','V','C','L','O','G',0,0 };
+static const uint32_t telemetryVersion = 1;
+static const uint32_t compressedFlag = 1;
+
+static const int headerSize = 64;           // Size of file header [bytes]
+static const int entrySize = 64;            // Size of channel table entry [bytes]
+static const int nameSize = 40;             // Size of channel name field [bytes]
+static const int unitSize = 16;             // Size of channel unit field [bytes]
+static const int flagsOffset = 20;          // Offset of flags in header [bytes]
+static const int samplesOffset = 24;        // Offset of number of samples in header [bytes]
+static const int indexOffset = 40;          // Offset of chunk index offset in header [bytes]
+static const int bucketOffset = 48;         // Offset of bucket size in header [bytes]
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+telemetryWriter::telemetryWriter( std::string _fileName, const std::vector<telemetryChannel>& _channels, int _chunkSamples, bool _compressed )
+{
+    if ( _channels.empty() || _chunkSamples < 1 )
+        throw std::invalid_argument("Telemetry requires at least one channel and one sample per chunk");
+
+    nChannels = _channels.size();
+    chunkSamples = _chunkSamples;
+    compressed = _compressed;
+    fileName = _fileName;
+    channelTable = _channels;
+    chunk = MatrixXf::Zero( chunkSamples,nChannels );
+
+    File.open( _fileName, std::ios::binary | std::ios::trunc );
+    if ( !File )
+        throw std::invalid_argument("Unable to create telemetry file " + _fileName);
+
+    // Header, chunks start on a 64 byte boundary directly after the channel table
+    uint64_t dataOffset = headerSize + entrySize*nChannels;
+    uint32_t dims[4] = { telemetryVersion, (uint32_t) nChannels, (uint32_t) chunkSamples, compressed ? compressedFlag : 0 };
+    uint64_t bucketSize = 1;
+
+    char header[headerSize] = {};
+    std::memcpy( header, telemetryMagic, 8 );
+    std::memcpy( header + 8, dims, sizeof( dims ) );
+    std::memcpy( header + samplesOffset, &nSamples, 8 );
+    std::memcpy( header + samplesOffset + 8, &dataOffset, 8 );
+    std::memcpy( header + bucketOffset, &bucketSize, 8 );
+    File.write( header, headerSize );
+
+    // Channel table
+    for ( const telemetryChannel& channel : _channels )
+    {
+        if ( channel.name.size() >= nameSize || channel.unit.size() >= unitSize )
+            throw std::invalid_argument("Telemetry channel name or unit too long: " + channel.name);
+
+        char entry[entrySize] = {};
+        std::memcpy( entry, channel.name.data(), channel.name.size() );
+        std::memcpy( entry + nameSize, channel.unit.data(), channel.unit.size() );
+        std::memcpy( entry + nameSize + unitSize, "<f4", 3 );
+        File.write( entry, entrySize );
+    }
+}
+
+
+telemetryWriter::~telemetryWriter(  )
+{
+    close( );
+}
+
+
+void telemetryWriter::write( const Ref<const VectorXf>& _sample )
+{
+    if ( _sample.size() != nChannels )
+        throw std::invalid_argument("Incorrect number of channels given to telemetry writer");
+
+    chunk.row( fill ) = _sample.transpose();
+
+    if ( pyramid )
+        pyramid->add( _sample );
+
+    if ( ++fill == chunkSamples )
+        writeChunk( );
+}
+
+
+void telemetryWriter::writeBlock( const Ref<const MatrixXf>& _samples )
+{
+    if ( _samples.rows() != nChannels )
+        throw std::invalid_argument("Incorrect number of channels given to telemetry writer");
+
+    int i = 0;
+
+    while ( i < _samples.cols() )
+    {
+        int n = std::min( (int) _samples.cols() - i, chunkSamples - fill );
+
+        chunk.middleRows( fill,n ) = _samples.middleCols( i,n ).transpose();
+
+        if ( pyramid )
+            for ( int j=i; j<i+n; ++j )
+                pyramid->add( _samples.col( j ) );
+
+        fill += n;
+        i += n;
+
+        if ( fill == chunkSamples )
+            writeChunk( );
+    }
+}
+
+
+void telemetryWriter::enableLevelOfDetail( int _factor )
+{
+    if ( nSamples > 0 || fill > 0 )
+        throw std::invalid_argument("Level of detail is enabled before writing telemetry");
+
+    pyramid.reset( new lodPyramid( fileName, channelTable, _factor ) );
+}
+
+
+void telemetryWriter::setBucketSize( uint64_t _bucketSize )
+{
+    if ( _bucketSize < 1 )
+        throw std::invalid_argument("Bucket size must be at least one sample");
+
+    File.seekp( bucketOffset );
+    File.write( (const char*) &_bucketSize, 8 );
+    File.seekp( 0, std::ios::end );
+}
+
+
+void telemetryWriter::close(  )
+{
+    if ( pyramid )
+        pyramid->close();
+
+    if ( !File.is_open() )
+        return;
+
+    if ( fill > 0 )
+    {
+        chunk.bottomRows( chunkSamples - fill ).setZero();
+        writeChunk( );
+    }
+
+    // Chunk index of compressed files
+    if ( compressed )
+    {
+        uint64_t offset = File.tellp();
+
+        for ( size_t k=0; k<chunkOffsets.size(); ++k )
+        {
+            File.write( (const char*) &chunkOffsets[k], 8 );
+            File.write( (const char*) &chunkKeys[k*nChannels], nChannels*sizeof( float ) );
+        }
+
+        File.seekp( indexOffset );
+        File.write( (const char*) &offset, 8 );
+    }
+
+    File.close();
+}
+
+
+unsigned long telemetryWriter::samples(  ) const
+{
+    return nSamples + fill;
+}
+
+
+telemetryReader::telemetryReader( std::string _fileName )
+{
+    File.reset( new mappedFile( _fileName ) );
+
+    const char* data = File->data();
+    uint32_t dims[4];
+    uint64_t index;
+
+    if ( File->size() < headerSize || std::memcmp( data, telemetryMagic, 8 ) != 0 )
+        throw std::invalid_argument("Not a telemetry file: " + _fileName);
+
+    std::memcpy( dims, data + 8, sizeof( dims ) );
+    std::memcpy( &nSamples, data + samplesOffset, 8 );
+    std::memcpy( &dataOffset, data + samplesOffset + 8, 8 );
+    std::memcpy( &index, data + indexOffset, 8 );
+
+    if ( dims[0] != telemetryVersion )
+        throw std::invalid_argument("Unsupported telemetry version in " + _fileName);
+
+    nChannels = dims[1];
+    chunkSamples = dims[2];
+    compressed = dims[3] & compressedFlag;
+
+    // Chunks are only counted once they are completely written
+    nChunks = ( nSamples + chunkSamples - 1 ) / chunkSamples;
+
+    if ( dataOffset < headerSize + (uint64_t) entrySize*nChannels || File->size() < dataOffset )
+        throw std::invalid_argument("Truncated telemetry file " + _fileName);
+
+    if ( !compressed && File->size() < dataOffset + nChunks*chunkSamples*nChannels*sizeof( float ) )
+        throw std::invalid_argument("Truncated telemetry file " + _fileName);
+
+    for ( int c=0; c<nChannels; ++c )
+    {
+        const char* entry = data + headerSize + c*entrySize;
+
+        if ( std::strncmp( entry + nameSize + unitSize, "<f4", 8 ) != 0 )
+            throw std::invalid_argument("Unsupported telemetry data type in " + _fileName);
+
+        telemetryChannel channel;
+        channel.name = std::string( entry, strnlen( entry, nameSize ) );
+        channel.unit = std::string( entry + nameSize, strnlen( entry + nameSize, unitSize ) );
+        channelTable.push_back( channel );
+    }
+
+    // Chunk offsets and first values, from the index or, for files that were not
+    // closed, from the chunk headers
+    chunkOffsets.resize( nChunks );
+    chunkKeys.resize( nChannels,nChunks );
+
+    if ( compressed && index > 0 )
+    {
+        size_t stride = 8 + nChannels*sizeof( float );
+
+        if ( File->size() < index + nChunks*stride )
+            throw std::invalid_argument("Truncated telemetry index in " + _fileName);
+
+        for ( uint64_t k=0; k<nChunks; ++k )
+        {
+            std::memcpy( &chunkOffsets[k], data + index + k*stride, 8 );
+            std::memcpy( chunkKeys.col(k).data(), data + index + k*stride + 8, nChannels*sizeof( float ) );
+        }
+    }
+    else if ( compressed )
+    {
+        uint64_t offset = dataOffset;
+
+        for ( uint64_t k=0; k<nChunks; ++k )
+        {
+            uint64_t size = 4 + 8*nChannels;
+            std::vector<uint32_t> sizes( 2*nChannels );
+
+            if ( File->size() < offset + size )
+                throw std::invalid_argument("Truncated telemetry file " + _fileName);
+
+            std::memcpy( sizes.data(), data + offset + 4, 8*nChannels );
+            for ( int c=0; c<nChannels; ++c )
+                size += sizes[2*c];
+
+            if ( File->size() < offset + size )
+                throw std::invalid_argument("Truncated telemetry file " + _fileName);
+
+            // Both codecs start with the first value, most significant byte first
+            const uint8_t* stream = (const uint8_t*) data + offset + 4 + 8*nChannels;
+            for ( int c=0; c<nChannels; ++c )
+            {
+                uint32_t bits = ( (uint32_t) stream[0] << 24 ) | ( stream[1] << 16 ) | ( stream[2] << 8 ) | stream[3];
+                std::memcpy( &chunkKeys( c,k ), &bits, 4 );
+                stream += sizes[2*c];
+            }
+
+            chunkOffsets[k] = offset;
+            offset += size;
+        }
+    }
+    else
+    {
+        const float* values = (const float*) ( data + dataOffset );
+
+        for ( uint64_t k=0; k<nChunks; ++k )
+        {
+            chunkOffsets[k] = dataOffset + k*chunkSamples*nChannels*sizeof( float );
+            for ( int c=0; c<nChannels; ++c )
+                chunkKeys( c,k ) = values[( k*nChannels + c )*chunkSamples];
+        }
+    }
+}
+
+
+telemetryReader::~telemetryReader(  ) {}
+
+
+int telemetryReader::channels(  ) const
+{
+    return nChannels;
+}
+
+
+unsigned long telemetryReader::samples(  ) const
+{
+    return nSamples;
+}
+
+
+const telemetryChannel& telemetryReader::channelInfo( int _index ) const
+{
+    if ( _index < 0 || _index >= nChannels )
+        throw std::invalid_argument("Telemetry channel index out of range");
+
+    return channelTable[_index];
+}
+
+
+int telemetryReader::channelIndex( const std::string& _name ) const
+{
+    for ( int c=0; c<nChannels; ++c )
+        if ( channelTable[c].name == _name )
+            return c;
+
+    throw std::invalid_argument("Unknown telemetry channel " + _name);
+}
+
+
+VectorXf telemetryReader::channel( int _index ) const
+{
+    return channel( _index, 0, nSamples );
+}
+
+
+VectorXf telemetryReader::channel( const std::string& _name ) const
+{
+    return channel( channelIndex( _name ) );
+}
+
+
+VectorXf telemetryReader::channel( int _index, unsigned long _first, unsigned long _count ) const
+{
+    if ( _index < 0 || _index >= nChannels )
+        throw std::invalid_argument("Telemetry channel index out of range");
+
+    if ( _first + _count > nSamples )
+        throw std::invalid_argument("Telemetry sample range out of range");
+
+    VectorXf values( _count );
+    std::vector<float> buffer( chunkSamples );
+
+    uint64_t i = _first;
+    while ( i < _first + _count )
+    {
+        uint64_t k = i/chunkSamples;
+        uint64_t begin = i - k*chunkSamples;
+        uint64_t n = std::min<uint64_t>( chunkLength( k ) - begin, _first + _count - i );
+
+        readChunk( k, _index, buffer.data() );
+        std::memcpy( values.data() + ( i - _first ), buffer.data() + begin, n*sizeof( float ) );
+        i += n;
+    }
+
+    return values;
+}
+
+
+void telemetryReader::block( unsigned long _first, unsigned long _count, MatrixXf& _values ) const
+{
+    if ( _first + _count > nSamples )
+        throw std::invalid_argument("Telemetry sample range out of range");
+
+    _values.resize( nChannels,_count );
+    VectorXf buffer( chunkSamples );
+
+    uint64_t i = _first;
+    while ( i < _first + _count )
+    {
+        uint64_t k = i/chunkSamples;
+        uint64_t begin = i - k*chunkSamples;
+        uint64_t n = std::min<uint64_t>( chunkLength( k ) - begin, _first + _count - i );
+
+        for ( int c=0; c<nChannels; ++c )
+        {
+            readChunk( k, c, buffer.data() );
+            _values.row( c ).segment( i - _first,n ) = buffer.segment( begin,n ).transpose();
+        }
+        i += n;
+    }
+}
+
+
+unsigned long telemetryReader::findSample( int _index, float _value ) const
+{
+    if ( _index < 0 || _index >= nChannels )
+        throw std::invalid_argument("Telemetry channel index out of range");
+
+    if ( nChunks == 0 )
+        return 0;
+
+    // Last chunk starting below the value, then search within that chunk
+    uint64_t low = 0, high = nChunks;
+    while ( high - low > 1 )
+    {
+        uint64_t mid = ( low + high )/2;
+        if ( chunkKeys( _index,mid ) < _value ) low = mid;
+        else high = mid;
+    }
+
+    std::vector<float> buffer( chunkSamples );
+    int n = chunkLength( low );
+    readChunk( low, _index, buffer.data() );
+
+    return low*chunkSamples + ( std::lower_bound( buffer.begin(), buffer.begin() + n, _value ) - buffer.begin() );
+}
+
+
+MatrixXf telemetryReader::matrix(  ) const
+{
+    MatrixXf values( nChannels,nSamples );
+    VectorXf buffer( chunkSamples );
+
+    for ( uint64_t k=0; k<nChunks; ++k )
+    {
+        int n = chunkLength( k );
+
+        for ( int c=0; c<nChannels; ++c )
+        {
+            readChunk( k, c, buffer.data() );
+            values.row( c ).segment( k*chunkSamples,n ) = buffer.head( n ).transpose();
+        }
+    }
+
+    return values;
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void telemetryWriter::writeChunk(  )
+{
+    if ( compressed )
+    {
+        // Chunk header with number of samples and size and codec of each channel
+        chunkBytes.assign( 4 + 8*nChannels, 0 );
+        std::memcpy( chunkBytes.data(), &fill, 4 );
+
+        for ( int c=0; c<nChannels; ++c )
+        {
+            size_t begin = chunkBytes.size();
+            uint32_t codec = compressBlock( chunk.col(c).data(), fill, chunkBytes );
+            uint32_t size = chunkBytes.size() - begin;
+
+            std::memcpy( chunkBytes.data() + 4 + 8*c, &size, 4 );
+            std::memcpy( chunkBytes.data() + 8 + 8*c, &codec, 4 );
+
+            chunkKeys.push_back( chunk( 0,c ) );
+        }
+
+        chunkOffsets.push_back( File.tellp() );
+        File.write( (const char*) chunkBytes.data(), chunkBytes.size() );
+    }
+    else
+        File.write( (const char*) chunk.data(), chunk.size()*sizeof( float ) );
+
+    // Samples are counted only after their chunk is written, so that an interrupted
+    // run leaves a readable file
+    nSamples += fill;
+    fill = 0;
+
+    File.seekp( samplesOffset );
+    File.write( (const char*) &nSamples, 8 );
+    File.seekp( 0, std::ios::end );
+}
+
+
+void telemetryReader::readChunk( uint64_t _chunk, int _index, float* _values ) const
+{
+    const char* data = File->data() + chunkOffsets[_chunk];
+    int n = chunkLength( _chunk );
+
+    if ( !compressed )
+    {
+        std::memcpy( _values, data + _index*chunkSamples*sizeof( float ), n*sizeof( float ) );
+        return;
+    }
+
+    // Skip compressed channels before the requested channel
+    uint32_t sizes[2];
+    uint64_t offset = 4 + 8*nChannels;
+
+    for ( int c=0; c<_index; ++c )
+    {
+        std::memcpy( sizes, data + 4 + 8*c, 8 );
+        offset += sizes[0];
+    }
+    std::memcpy( sizes, data + 4 + 8*_index, 8 );
+
+    if ( chunkOffsets[_chunk] + offset + sizes[0] > File->size() )
+        throw std::invalid_argument("Truncated telemetry chunk");
+
+    decompressBlock( (compressionCodec) sizes[1], (const uint8_t*) data + offset, sizes[0], n, _values );
+}
+
+
+int telemetryReader::chunkLength( uint64_t _chunk ) const
+{
+    return std::min<uint64_t>( chunkSamples, nSamples - _chunk*chunkSamples );
+}
@@ -0,0 +1,218 @@
+/**
+ *	\file src/telemetryStream.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+telemetryStream::telemetryStream( int _capacity, int _chunkSamples, bool _compressed )
+{
+    if ( _capacity < 1 || _chunkSamples < 1 )
+        throw std::invalid_argument("Telemetry stream requires a buffer of at least one record");
+
+    capacity = _capacity;
+    chunkSamples = _chunkSamples;
+    compressed = _compressed;
+}
+
+
+telemetryStream::~telemetryStream(  )
+{
+    try { close( ); }
+    catch ( ... ) {}
+}
+
+
+void telemetryStream::addFile( std::string _fileName, const std::vector<telemetryChannel>& _channels )
+{
+    if ( thread.joinable() )
+        throw std::invalid_argument("Telemetry files are added before the stream is started");
+
+    if ( Recorder )
+        throw std::invalid_argument("Telemetry stream already passes its records to a flight recorder");
+
+    files.emplace_back( new telemetryWriter( _fileName, _channels, chunkSamples, compressed ) );
+    firstChannel.push_back( nChannels );
+    nChannels += _channels.size();
+    channelTable.insert( channelTable.end(), _channels.begin(), _channels.end() );
+}
+
+
+void telemetryStream::setRecorder( std::unique_ptr<flightRecorder> _recorder )
+{
+    if ( thread.joinable() )
+        throw std::invalid_argument("Flight recorder is assigned before the stream is started");
+
+    if ( !files.empty() )
+        throw std::invalid_argument("Telemetry stream already writes telemetry files");
+
+    Recorder = std::move( _recorder );
+    channelTable = Recorder->channelList();
+    nChannels = channelTable.size();
+}
+
+
+void telemetryStream::start(  )
+{
+    if ( files.empty() && !Recorder )
+        throw std::invalid_argument("Telemetry stream requires at least one file or a flight recorder");
+
+    if ( thread.joinable() )
+        return;
+
+    if ( levelOfDetail )
+        for ( std::unique_ptr<telemetryWriter>& file : files )
+            file->enableLevelOfDetail( );
+
+    buffer = MatrixXf::Zero( nChannels,capacity );
+    thread = std::thread( &telemetryStream::writer, this );
+}
+
+
+bool telemetryStream::push( const Ref<const VectorXf>& _record )
+{
+    if ( _record.size() != nChannels )
+        throw std::invalid_argument("Incorrect number of channels given to telemetry stream");
+
+    uint64_t h = head.load( std::memory_order_relaxed );
+
+    // Drop the record when the buffer is full, or wait for the writer thread to free a
+    // slot if the stream is lossless
+    while ( h - tail.load( std::memory_order_acquire ) == (uint64_t) capacity )
+    {
+        if ( !lossless || failed.load() || !thread.joinable() )
+        {
+            ++nDropped;
+            return false;
+        }
+        std::this_thread::yield();
+    }
+
+    buffer.col( h % capacity ) = _record;
+    head.store( h+1, std::memory_order_release );
+
+    return true;
+}
+
+
+void telemetryStream::close(  )
+{
+    if ( thread.joinable() )
+    {
+        stopping = true;
+        thread.join();
+    }
+
+    for ( std::unique_ptr<telemetryWriter>& file : files )
+        file->close();
+
+    if ( Recorder )
+        Recorder->close();
+
+    if ( error )
+    {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception( e );
+    }
+}
+
+
+void telemetryStream::setLevelOfDetail( bool _enable )
+{
+    if ( thread.joinable() )
+        throw std::invalid_argument("Level of detail is assigned before the stream is started");
+
+    levelOfDetail = _enable;
+}
+
+
+void telemetryStream::setLossless( bool _lossless )
+{
+    lossless = _lossless;
+}
+
+
+int telemetryStream::channels(  ) const
+{
+    return nChannels;
+}
+
+
+const std::vector<telemetryChannel>& telemetryStream::channelList(  ) const
+{
+    return channelTable;
+}
+
+
+unsigned long telemetryStream::dropped(  ) const
+{
+    return nDropped;
+}
+
+
+const flightRecorder* telemetryStream::recorder(  ) const
+{
+    return Recorder.get();
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void telemetryStream::writer(  )
+{
+    // Records are collected into chunks, but never more than half the buffer is held back
+    uint64_t batch = std::min( chunkSamples, std::max( capacity/2, 1 ) );
+
+    try
+    {
+        while ( true )
+        {
+            // Read stopping before head, so that records pushed before close are written
+            bool done = stopping.load();
+            uint64_t t = tail.load( std::memory_order_relaxed );
+            uint64_t n = head.load( std::memory_order_acquire ) - t;
+
+            if ( n < batch && !done )
+            {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+                continue;
+            }
+
+            // Write contiguous part of the ring buffer, wrapped records follow in the next pass
+            int first = t % capacity;
+            int count = std::min<uint64_t>( n, capacity - first );
+
+            for ( size_t f=0; f<files.size(); ++f )
+            {
+                int rows = ( f+1 < files.size() ? firstChannel[f+1] : nChannels ) - firstChannel[f];
+                files[f]->writeBlock( buffer.block( firstChannel[f], first, rows, count ) );
+            }
+
+            if ( Recorder )
+                for ( int j=0; j<count; ++j )
+                    Recorder->record( buffer.col( first + j ) );
+
+            tail.store( t + count, std::memory_order_release );
+
+            if ( done && n == (uint64_t) count )
+                break;
+        }
+    }
+    catch ( ... )
+    {
+        error = std::current_exception();
+        failed = true;
+    }
+}
@@ -0,0 +1,239 @@
+/**
+ *	\file src/threadPool.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+
+//
+// PUBLIC MEMBER FUNCTIONS:
+//
+
+threadPool::threadPool(  ) : threadPool( std::max( 1u, std::thread::hardware_concurrency() ) ) {}
+
+
+threadPool::threadPool( unsigned int _nThreads )
+{
+    if ( _nThreads < 1 )
+        throw std::invalid_argument("Thread pool requires at least one thread");
+
+    // The calling thread takes part in parallelFor, so one worker less is started
+    for ( unsigned int i=1; i<_nThreads; ++i )
+        workers.emplace_back( &threadPool::worker, this );
+}
+
+
+threadPool::~threadPool(  )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for ( std::thread& t : workers )
+        t.join();
+}
+
+
+void threadPool::submit( std::function<void()> _task )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        tasks.push_back( std::move( _task ) );
+        ++pending;
+    }
+    taskAvailable.notify_one();
+}
+
+
+void threadPool::wait(  )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+
+    // Without workers the calling thread executes the queued tasks itself
+    while ( workers.empty() && !tasks.empty() )
+    {
+        std::function<void()> task = std::move( tasks.front() );
+        tasks.pop_front();
+
+        lock.unlock();
+        try { task(); }
+        catch ( ... ) { lock.lock(); if ( !error ) error = std::current_exception(); lock.unlock(); }
+        lock.lock();
+
+        --pending;
+    }
+
+    tasksDone.wait( lock, [this]{ return pending == 0; } );
+
+    if ( error )
+    {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception( e );
+    }
+}
+
+
+void threadPool::parallelFor( int _n, const std::function<void(int,int)>& _body )
+{
+    int nParts = std::min( (int) size(), _n );
+
+    if ( nParts <= 1 )
+    {
+        if ( _n > 0 )
+            _body( 0,_n );
+        return;
+    }
+
+    for ( int i=1; i<nParts; ++i )
+        submit( [&_body, i, nParts, _n]{ _body( (long) _n*i/nParts, (long) _n*(i+1)/nParts ); } );
+
+    std::exception_ptr localError;
+
+    try { _body( 0,_n/nParts ); }
+    catch ( ... ) { localError = std::current_exception(); }
+
+    wait();
+
+    if ( localError )
+        std::rethrow_exception( localError );
+}
+
+
+void threadPool::parallelForEach( int _n, const std::function<void(int)>& _body )
+{
+    int nParts = std::min( (int) size(), _n );
+
+    // Remaining range of each thread, begin in the low and end in the high word, so that
+    // the owner and thieves update both ends with a single compare-and-swap
+    auto pack = []( uint64_t _begin, uint64_t _end ){ return _begin | ( _end << 32 ); };
+    std::vector<std::atomic<uint64_t>> ranges( std::max( nParts, 0 ) );
+
+    for ( int p=0; p<nParts; ++p )
+        ranges[p].store( pack( (long) _n*p/nParts, (long) _n*(p+1)/nParts ) );
+
+    parallelFor( nParts, [&]( int _part, int )
+    {
+        std::atomic<uint64_t>& own = ranges[_part];
+
+        while ( true )
+        {
+            // Take the next index of the own range from the front
+            uint64_t range = own.load();
+            uint32_t begin = range, end = range >> 32;
+
+            if ( begin < end )
+            {
+                if ( own.compare_exchange_weak( range, pack( begin+1, end ) ) )
+                    _body( begin );
+                continue;
+            }
+
+            // Steal the back half of the largest remaining range
+            int victim = -1;
+            uint32_t largest = 0;
+
+            for ( int p=0; p<nParts; ++p )
+            {
+                uint64_t other = ranges[p].load();
+                uint32_t remaining = (uint32_t)( other >> 32 ) - std::min( (uint32_t) other, (uint32_t)( other >> 32 ) );
+
+                if ( remaining > largest )
+                {
+                    largest = remaining;
+                    victim = p;
+                }
+            }
+
+            if ( victim < 0 )
+                return;
+
+            range = ranges[victim].load();
+            begin = range; end = range >> 32;
+
+            if ( begin >= end )
+                continue;
+
+            uint32_t middle = begin + ( end - begin )/2;
+            if ( ranges[victim].compare_exchange_strong( range, pack( begin, middle ) ) )
+                own.store( pack( middle, end ) );
+        }
+    } );
+}
+
+
+void threadPool::inclusiveScan( VectorXf& _data )
+{
+    // Parts have a fixed length, so that rounding does not depend on the number of threads
+    const int partSize = 256;
+
+    int n = _data.size();
+    int nParts = ( n + partSize - 1 )/partSize;
+
+    // Scan of each part, followed by an offset with the totals of all preceding parts
+    VectorXf partTotal = VectorXf::Zero( nParts );
+
+    parallelFor( nParts, [&]( int _begin, int _end )
+    {
+        for ( int p=_begin; p<_end; ++p )
+        {
+            int end = std::min( n, (p+1)*partSize );
+
+            for ( int i=p*partSize+1; i<end; ++i )
+                _data(i) += _data(i-1);
+
+            partTotal(p) = _data(end-1);
+        }
+    } );
+
+    for ( int p=1; p<nParts; ++p )
+        partTotal(p) += partTotal(p-1);
+
+    parallelFor( nParts, [&]( int _begin, int _end )
+    {
+        for ( int p=std::max( _begin,1 ); p<_end; ++p )
+            _data.segment( p*partSize, std::min( n, (p+1)*partSize ) - p*partSize ).array() += partTotal(p-1);
+    } );
+}
+
+
+unsigned int threadPool::size(  ) const
+{
+    return workers.size() + 1;
+}
+
+
+
+//
+// PRIVATE MEMBER FUNCTIONS:
+//
+
+void threadPool::worker(  )
+{
+    std::unique_lock<std::mutex> lock( mutex );
+
+    while ( true )
+    {
+        taskAvailable.wait( lock, [this]{ return stopping || !tasks.empty(); } );
+
+        if ( tasks.empty() )
+            return;
+
+        std::function<void()> task = std::move( tasks.front() );
+        tasks.pop_front();
+
+        lock.unlock();
+        try { task(); }
+        catch ( ... ) { lock.lock(); if ( !error ) error = std::current_exception(); lock.unlock(); }
+        lock.lock();
+
+        if ( --pending == 0 )
+            tasksDone.notify_all();
+    }
+}
@@ -0,0 +1,200 @@
+/**
+ *	\file src/tvcsim.cpp
+ *	\author Mike Timmerman
+ *	\version 1.0
+ *	\date 2022
+ */
+
+#include "../header.h"    // #include header
+
+
+struct tvcsimScenario
+{
+    scenario Scenario;
+};
+
+
+struct tvcsimSimulation
+{
+    tvcsimSimulation( const scenario& _scenario ) : Simulation( _scenario ) { }
+
+    simulation Simulation;
+    bool finished = false;                  // Set once a step has ended the simulation
+};
+
+
+// Message of the last failure of each thread
+static thread_local std::string lastError;
+
+
+/** Call function, store the message of an exception and return a failure value instead
+ */
+template<typename F, typename R>
+static R guard( F _function, R _failure )
+{
+    try
+    {
+        lastError.clear();
+        return _function();
+    }
+    catch ( const std::exception& e )
+    {
+        lastError = e.what();
+    }
+    catch ( ... )
+    {
+        lastError = "Unknown error";
+    }
+
+    return _failure;
+}
+
+
+
+//
+// C INTERFACE:
+//
+
+const char* tvcsimVersion(  )
+{
+    return resultCache::version();
+}
+
+
+const char* tvcsimLastError(  )
+{
+    return lastError.c_str();
+}
+
+
+tvcsimScenario* tvcsimCreateScenario(  )
+{
+    return guard( [](){
+        tvcsimScenario* Scenario = new tvcsimScenario;
+        Scenario->Scenario.name = "nominal";
+        Scenario->Scenario.telemetry = false;
+        return Scenario;
+    }, (tvcsimScenario*) nullptr );
+}
+
+
+tvcsimScenario* tvcsimLoadScenario( const char* _fileName )
+{
+    return guard( [&](){ return new tvcsimScenario{ loadScenario( _fileName ) }; }, (tvcsimScenario*) nullptr );
+}
+
+
+void tvcsimDestroyScenario( tvcsimScenario* _scenario )
+{
+    delete _scenario;
+}
+
+
+int tvcsimSetParameter( tvcsimScenario* _scenario, const char* _key, const char* _value )
+{
+    return guard( [&](){
+        setScenarioParameter( _scenario->Scenario, _key, _value );
+        return 0;
+    }, -1 );
+}
+
+
+int tvcsimGetParameter( tvcsimScenario* _scenario, const char* _key, float* _values, int _size )
+{
+    return guard( [&](){
+        Map<VectorXf> parameter = _scenario->Scenario.parameter( _key );
+
+        if ( _values )
+        {
+            if ( _size < parameter.size() )
+                throw std::invalid_argument("Parameter " + std::string( _key ) + " has " + std::to_string( parameter.size() ) + " elements");
+            Map<VectorXf>( _values, parameter.size() ) = parameter;
+        }
+
+        return (int) parameter.size();
+    }, -1 );
+}
+
+
+tvcsimSimulation* tvcsimCreateSimulation( const tvcsimScenario* _scenario )
+{
+    return guard( [&](){
+        tvcsimSimulation* Simulation = new tvcsimSimulation( _scenario->Scenario );
+        Simulation->Simulation.setVerbose( false );
+        Simulation->Simulation.setRecording( true );
+        return Simulation;
+    }, (tvcsimSimulation*) nullptr );
+}
+
+
+void tvcsimDestroySimulation( tvcsimSimulation* _simulation )
+{
+    delete _simulation;
+}
+
+
+int tvcsimStep( tvcsimSimulation* _simulation, int _steps )
+{
+    return guard( [&](){
+        int first = _simulation->Simulation.iteration();
+
+        for ( int k=0; k<_steps && !_simulation->finished; ++k )
+            _simulation->finished = !_simulation->Simulation.step();
+
+        return _simulation->Simulation.iteration() - first;
+    }, -1 );
+}
+
+
+int tvcsimRun( tvcsimSimulation* _simulation, float* _metrics )
+{
+    return guard( [&](){
+        // A finished simulation is not stepped again, only its telemetry is closed
+        VectorXf metrics = _simulation->Simulation.run();
+        _simulation->finished = true;
+
+        if ( _metrics )
+            Map<VectorXf>( _metrics, metrics.size() ) = metrics;
+
+        return _simulation->Simulation.iteration();
+    }, -1 );
+}
+
+
+int tvcsimFinished( const tvcsimSimulation* _simulation )
+{
+    return _simulation->finished ? 1 : 0;
+}
+
+
+void tvcsimMetrics( const tvcsimSimulation* _simulation, float* _metrics )
+{
+    VectorXf metrics = _simulation->Simulation.metrics();
+    Map<VectorXf>( _metrics, metrics.size() ) = metrics;
+}
+
+
+const float* tvcsimRecords( const tvcsimSimulation* _simulation, int* _channels, int* _samples )
+{
+    *_channels = (int) recordChannels.size();
+    *_samples = _simulation->Simulation.recordedSamples();
+    return _simulation->Simulation.records();
+}
+
+
+int tvcsimChannels(  )
+{
+    return (int) recordChannels.size();
+}
+
+
+const char* tvcsimChannelName( int _channel )
+{
+    return _channel >= 0 && _channel < (int) recordChannels.size() ? recordChannels[_channel].name.c_str() : nullptr;
+}
+
+
+const char* tvcsimChannelUnit( int _channel )
+{
+    return _channel >= 0 && _channel < (int) recordChannels.size() ? recordChannels[_channel].unit.c_str() : nullptr;
+}
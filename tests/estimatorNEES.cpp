@@ -0,0 +1,62 @@
+#include "../header.h"
+
+
+/* Consistency test of an estimator against the true state
+ *
+ *   EstimatorNEES <scenario file> <ekf|eskf|ukf|pf> [runs]
+ *
+ * Runs the scenario without telemetry for a number of runs, each with its own sensor noise,
+ * and averages the mean normalized estimation error squared (NEES) of the runs. A consistent
+ * filter has a NEES that is chi-square distributed with 12 degrees of freedom, so the average
+ * over N runs must lie within the two-sided 95% bounds of a chi-square distribution with 12N
+ * degrees of freedom, divided by N. Exits with 0 if it does, 1 otherwise.
+ */
+
+
+// Quantile of the chi-square distribution (Wilson-Hilferty approximation)
+static double chiSquareQuantile( double _dof, double _z )
+{
+    double h = 2.0/( 9.0*_dof );
+    return _dof*pow( 1.0 - h + _z*sqrt( h ), 3 );
+}
+
+
+int main( int argc, char* argv[] )
+{
+    if ( argc < 3 )
+    {
+        std::cerr << "usage: EstimatorNEES <scenario file> <ekf|eskf|ukf|pf> [runs]" << std::endl;
+        return 2;
+    }
+
+    int runs = argc > 3 ? std::stoi( argv[3] ) : 10;
+
+    scenario nominal = loadScenario( argv[1] );
+    setScenarioParameter( nominal, "estimator", argv[2] );
+    nominal.telemetry = false;
+
+    double neesSum = 0;
+
+    for ( int k=0; k<runs; ++k )
+    {
+        scenario Scenario = nominal;
+        Scenario.run = k;
+
+        simulation Simulation( Scenario );
+        Simulation.setVerbose( false );
+
+        float nees = Simulation.run( )(3);
+        neesSum += nees;
+
+        std::cout << "run " << k << ": mean NEES " << nees << std::endl;
+    }
+
+    const double dof = 12;
+    double nees = neesSum/runs;
+    double lower = chiSquareQuantile( dof*runs, -1.959964 )/runs;
+    double upper = chiSquareQuantile( dof*runs, 1.959964 )/runs;
+
+    std::cout << argv[2] << ": mean NEES " << nees << " over " << runs << " runs, 95% bounds [" << lower << ", " << upper << "]" << std::endl;
+
+    return ( nees >= lower && nees <= upper ) ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include "../header.h"
+
+
+/* Per-step latency of the estimators
+ *
+ *   EstimatorBenchmark [steps] [particles] [threads]
+ *
+ * Steps every estimator in hover with a noisy IMU sample, a prediction and an IMU update per
+ * step, and a GPS update every 20 steps, and prints the mean wall time per step.
+ */
+
+
+int main( int argc, char* argv[] )
+{
+    int steps = argc > 1 ? std::stoi( argv[1] ) : 10000;
+    int particles = argc > 2 ? std::stoi( argv[2] ) : 2000;
+    unsigned int threads = argc > 3 ? std::stoi( argv[3] ) : 1;
+
+    const float samplingTime = 0.01;
+
+    VectorXf state = VectorXf::Zero( 12 );
+    VectorXf u( 3 ); u << 0, 0, 2276.856764;
+    VectorXf x( 12 );
+
+    // Measured IMU output: Euler angles, body rates and specific force
+    VectorXf y = VectorXf::Zero( 9 );
+    y(8) = -9.81;
+
+    measurement gps;
+    gps.type = GPS_MEASUREMENT;
+    gps.size = 6;
+    gps.value.setZero();
+
+    std::vector<std::pair<std::string, std::unique_ptr<estimator>>> estimators;
+    estimators.emplace_back( "ekf", new estimator( state, 0, samplingTime ) );
+    estimators.emplace_back( "eskf", new ESKFestimator( state, 0, samplingTime ) );
+    estimators.emplace_back( "ukf", new UKFestimator( state, 0, samplingTime ) );
+    estimators.emplace_back( "pf", new PFestimator( state, 0, samplingTime, particles, threads ) );
+
+    randomStream stream( 1, 0, IMU_STREAM );
+
+    for ( auto& [name, Estimator] : estimators )
+    {
+        VectorXf noise = VectorXf::Zero( 9 ), yk = y;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for ( int i=0; i<steps; ++i )
+        {
+            stream.seek( i );
+            stream.normal( noise, 0.0, 0.005 );
+
+            yk = y + noise;
+            Estimator->estimateState( u, yk, x );
+
+            if ( i % 20 == 0 )
+            {
+                gps.sampleTime = gps.arrivalTime = ( i+1 )*samplingTime;
+                Estimator->update( gps );
+            }
+        }
+
+        double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+        std::cout << name << ": " << elapsed/steps*1e6 << " us per step" << std::endl;
+    }
+
+    return 0;
+}
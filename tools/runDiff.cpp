@@ -0,0 +1,110 @@
+#include "../header.h"
+
+
+/* Compare the outputs of two runs channel by channel
+ *
+ *   RunDiff <runA> <runB> [--abs <tolerance>] [--rel <tolerance>] [--time <file>]
+ *
+ * Runs are telemetry, CSV or binary matrix files, or run directories, in which case every
+ * telemetry file present in both directories is compared and divergence times are taken
+ * from time.tlm. Exits with 0 if the runs agree within the tolerances, 1 if they diverge.
+ */
+
+
+static void report( const std::string& _name, const runDifference& _difference, const VectorXf& _time )
+{
+    auto when = [&]( unsigned long _sample )
+    {
+        return _sample < (unsigned long) _time.size() ? "t = " + std::to_string( _time( _sample ) ) + " s" : "sample " + std::to_string( _sample );
+    };
+
+    std::cout << _name << ": " << _difference.compared << " samples compared";
+    if ( _difference.samplesA != _difference.samplesB )
+        std::cout << " (lengths differ: " << _difference.samplesA << " and " << _difference.samplesB << ")";
+    std::cout << std::endl;
+
+    if ( _difference.firstDivergence < 0 )
+        std::cout << "  no divergence" << std::endl;
+    else
+        std::cout << "  first divergence at " << when( _difference.firstDivergence ) << " in "
+                  << _difference.channels[ _difference.firstChannel ].name << std::endl;
+
+    std::printf( "  %-24s %14s %20s %14s %12s %22s\n", "channel", "max error", "at", "RMS", "violations", "first divergence" );
+
+    for ( const channelDifference& channel : _difference.channels )
+        std::printf( "  %-24s %14.6g %20s %14.6g %12lu %22s\n", channel.name.c_str(), channel.maxError, when( channel.maxErrorSample ).c_str(),
+                     channel.rms, channel.violations, channel.firstDivergence < 0 ? "-" : when( channel.firstDivergence ).c_str() );
+}
+
+
+int main(int argc, char const *argv[])
+{
+    std::vector<std::string> runs;
+    float absTol = 1e-6, relTol = 1e-5;
+    std::string timeFile;
+
+    for ( int i=1; i<argc; ++i )
+    {
+        std::string arg = argv[i];
+
+        if ( ( arg == "--abs" || arg == "--rel" || arg == "--time" ) && i+1 < argc )
+        {
+            std::string value = argv[++i];
+            if ( arg == "--abs" ) absTol = std::stof( value );
+            else if ( arg == "--rel" ) relTol = std::stof( value );
+            else timeFile = value;
+        }
+        else
+            runs.push_back( arg );
+    }
+
+    if ( runs.size() != 2 )
+    {
+        std::cerr << "Usage: RunDiff <runA> <runB> [--abs <tolerance>] [--rel <tolerance>] [--time <file>]" << std::endl;
+        return 2;
+    }
+
+    try
+    {
+        // Pairs of files to compare
+        std::vector<std::pair<std::string, std::string>> files;
+
+        if ( std::filesystem::is_directory( runs[0] ) && std::filesystem::is_directory( runs[1] ) )
+        {
+            for ( const auto& entry : std::filesystem::directory_iterator( runs[0] ) )
+            {
+                std::string name = entry.path().filename().string();
+                bool pyramid = name.find( ".lod" ) != std::string::npos;
+
+                if ( entry.path().extension() == ".tlm" && !pyramid && std::filesystem::exists( runs[1] + "/" + name ) )
+                    files.push_back( { entry.path().string(), runs[1] + "/" + name } );
+            }
+            std::sort( files.begin(), files.end() );
+
+            if ( timeFile.empty() && std::filesystem::exists( runs[0] + "/time.tlm" ) )
+                timeFile = runs[0] + "/time.tlm";
+        }
+        else
+            files.push_back( { runs[0], runs[1] } );
+
+        VectorXf time;
+        if ( !timeFile.empty() )
+            time = telemetryReader( timeFile ).channel( 0 );
+
+        bool diverged = false;
+
+        for ( const auto& pair : files )
+        {
+            runDifference difference = compareRuns( pair.first, pair.second, absTol, relTol );
+            report( std::filesystem::path( pair.first ).filename().string(), difference, time );
+            diverged = diverged || difference.firstDivergence >= 0 || difference.samplesA != difference.samplesB;
+        }
+
+        return diverged ? 1 : 0;
+    }
+    catch ( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+}